@@ -0,0 +1,393 @@
+#include "AlsCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AlsCodec
+{
+namespace
+{
+    enum Representation : uint8_t
+    {
+        Verbatim = 0,
+        Scaled = 1,
+        FloatBits = 2
+    };
+
+    constexpr int kMaxOrder = 2;
+    constexpr int kRiceParameterBits = 6;
+    constexpr int kMaxRiceParameter = 40;
+    constexpr int kEscapeLength = 24;                   // a run of this many ones: the value follows in 64 bits
+    constexpr float kScale = 8388608.0f;                // 2^23, one step of 24-bit audio
+    constexpr float kMaxScaled = 1073741824.0f;         // 2^30, keeps second-order residuals small
+
+    uint32_t bitsOf(float value) noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float floatOf(uint32_t bits) noexcept
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Sign-magnitude to offset binary: the integer order follows the float order
+    uint32_t toOrdered(uint32_t bits) noexcept   { return (bits & 0x80000000u) != 0 ? ~bits : (bits | 0x80000000u); }
+    uint32_t fromOrdered(uint32_t bits) noexcept { return (bits & 0x80000000u) != 0 ? (bits & 0x7fffffffu) : ~bits; }
+
+    float fromScaled(int64_t value) noexcept { return static_cast<float>(value) / kScale; }
+
+    bool toScaled(float sample, int64_t& value) noexcept
+    {
+        const float scaled = sample * kScale;
+        if (!(std::abs(scaled) <= kMaxScaled))      // also false for NaN
+            return false;
+
+        value = static_cast<int64_t>(scaled);
+        return bitsOf(fromScaled(value)) == bitsOf(sample);
+    }
+
+    uint64_t zigzag(int64_t value) noexcept  { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+    int64_t unzigzag(uint64_t value) noexcept { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+    int64_t predict(const int64_t* values, int index, int order) noexcept
+    {
+        const int64_t previous = index >= 1 ? values[index - 1] : 0;
+        if (order == 1)
+            return previous;
+        const int64_t beforeThat = index >= 2 ? values[index - 2] : 0;
+        return 2 * previous - beforeThat;
+    }
+
+    uint64_t riceBits(const uint64_t* residuals, int count, int parameter) noexcept
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const uint64_t quotient = residuals[i] >> parameter;
+            bits += quotient < kEscapeLength ? quotient + 1 + static_cast<uint64_t>(parameter)
+                                             : static_cast<uint64_t>(kEscapeLength + 64);
+        }
+        return bits;
+    }
+
+    // Close to log2 of the mean residual
+    int estimateRiceParameter(const uint64_t* residuals, int count) noexcept
+    {
+        uint64_t sum = 0;
+        for (int i = 0; i < count; ++i)
+            sum += residuals[i];
+
+        int guess = 0;
+        while (guess < kMaxRiceParameter && (static_cast<uint64_t>(count) << (guess + 1)) <= sum)
+            ++guess;
+        return guess;
+    }
+
+    // The parameter next to the estimate that codes the partition smallest
+    int chooseRiceParameter(const uint64_t* residuals, int count, uint64_t& bits) noexcept
+    {
+        const int guess = estimateRiceParameter(residuals, count);
+        int best = guess;
+        bits = riceBits(residuals, count, guess);
+        for (const int candidate : { guess - 1, guess + 1 })
+        {
+            if (candidate < 0 || candidate > kMaxRiceParameter)
+                continue;
+            if (const auto candidateBits = riceBits(residuals, count, candidate); candidateBits < bits)
+            {
+                bits = candidateBits;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    // Roughly what writeResiduals() would take
+    uint64_t residualBits(const uint64_t* residuals, int count) noexcept
+    {
+        uint64_t total = 0;
+        for (int start = 0; start < count; start += kPartitionSize)
+        {
+            // the estimate is close enough to rank the candidates; writing refines it
+            const int length = std::min(kPartitionSize, count - start);
+            total += kRiceParameterBits + riceBits(residuals + start, length, estimateRiceParameter(residuals + start, length));
+        }
+        return total;
+    }
+
+    // Most significant bit first, byte aligned at flush()
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& destination) : out(destination) {}
+
+        void write(uint64_t value, int numBits)
+        {
+            if (numBits > 32)
+            {
+                write(value >> 32, numBits - 32);
+                numBits = 32;
+            }
+            if (numBits == 0)
+                return;
+
+            pending = (pending << numBits) | (value & ((uint64_t { 1 } << numBits) - 1));
+            numPending += numBits;
+            while (numPending >= 8)
+            {
+                numPending -= 8;
+                out.push_back(static_cast<uint8_t>(pending >> numPending));
+            }
+        }
+
+        void flush()
+        {
+            if (numPending > 0)
+                out.push_back(static_cast<uint8_t>(pending << (8 - numPending)));
+            numPending = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& out;
+        uint64_t pending = 0;
+        int numPending = 0;
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const uint8_t* source, size_t numBytes) : data(source), size(numBytes) {}
+
+        bool read(int numBits, uint64_t& value)
+        {
+            if (numBits > 32)
+            {
+                uint64_t high = 0, low = 0;
+                if (!read(numBits - 32, high) || !read(32, low))
+                    return false;
+                value = (high << 32) | low;
+                return true;
+            }
+
+            while (numAvailable < numBits)
+            {
+                if (position >= size)
+                    return false;
+                available = (available << 8) | data[position++];
+                numAvailable += 8;
+            }
+            numAvailable -= numBits;
+            value = numBits == 0 ? 0 : (available >> numAvailable) & ((uint64_t { 1 } << numBits) - 1);
+            return true;
+        }
+
+        // Whole bytes used; the rest of a partly read byte is padding
+        size_t getBytesUsed() const noexcept { return position; }
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        uint64_t available = 0;
+        int numAvailable = 0;
+    };
+
+    void writeResiduals(BitWriter& writer, const uint64_t* residuals, int count)
+    {
+        for (int start = 0; start < count; start += kPartitionSize)
+        {
+            const int length = std::min(kPartitionSize, count - start);
+            uint64_t bits = 0;
+            const int parameter = chooseRiceParameter(residuals + start, length, bits);
+            writer.write(static_cast<uint64_t>(parameter), kRiceParameterBits);
+
+            for (int i = start; i < start + length; ++i)
+            {
+                const uint64_t quotient = residuals[i] >> parameter;
+                if (quotient < kEscapeLength)
+                {
+                    writer.write((uint64_t { 1 } << quotient) - 1, static_cast<int>(quotient));
+                    writer.write(0, 1);
+                    writer.write(residuals[i], parameter);
+                }
+                else
+                {
+                    writer.write((uint64_t { 1 } << kEscapeLength) - 1, kEscapeLength);
+                    writer.write(residuals[i], 64);
+                }
+            }
+        }
+    }
+
+    bool readResiduals(BitReader& reader, uint64_t* residuals, int count)
+    {
+        for (int start = 0; start < count; start += kPartitionSize)
+        {
+            uint64_t parameter = 0;
+            if (!reader.read(kRiceParameterBits, parameter) || parameter > kMaxRiceParameter)
+                return false;
+
+            for (int i = start; i < std::min(start + kPartitionSize, count); ++i)
+            {
+                int quotient = 0;
+                uint64_t bit = 1;
+                while (quotient < kEscapeLength)
+                {
+                    if (!reader.read(1, bit))
+                        return false;
+                    if (bit == 0)
+                        break;
+                    ++quotient;
+                }
+
+                uint64_t value = 0;
+                if (quotient == kEscapeLength)
+                {
+                    if (!reader.read(64, value))
+                        return false;
+                }
+                else
+                {
+                    if (!reader.read(static_cast<int>(parameter), value))
+                        return false;
+                    value |= static_cast<uint64_t>(quotient) << parameter;
+                }
+                residuals[i] = value;
+            }
+        }
+        return true;
+    }
+}
+
+void encode(const float* samples, int numSamples, std::vector<uint8_t>& out)
+{
+    std::vector<int64_t> values(static_cast<size_t>(std::min(numSamples, kBlockSize)));
+    std::vector<uint64_t> residuals(values.size());
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += kBlockSize)
+    {
+        const float* block = samples + blockStart;
+        const int length = std::min(kBlockSize, numSamples - blockStart);
+
+        // Pick the representation and order that leave the fewest bits
+        uint64_t bestBits = static_cast<uint64_t>(length) * 32;
+        Representation bestRepresentation = Verbatim;
+        int bestOrder = 0;
+
+        for (const auto representation : { Scaled, FloatBits })
+        {
+            bool representable = true;
+            for (int i = 0; i < length && representable; ++i)
+            {
+                if (representation == Scaled)
+                    representable = toScaled(block[i], values[static_cast<size_t>(i)]);
+                else
+                    values[static_cast<size_t>(i)] = toOrdered(bitsOf(block[i]));
+            }
+            if (!representable)
+                continue;
+
+            for (int order = 1; order <= kMaxOrder; ++order)
+            {
+                for (int i = 0; i < length; ++i)
+                    residuals[static_cast<size_t>(i)] = zigzag(values[static_cast<size_t>(i)] - predict(values.data(), i, order));
+
+                if (const auto bits = residualBits(residuals.data(), length); bits < bestBits)
+                {
+                    bestBits = bits;
+                    bestRepresentation = representation;
+                    bestOrder = order;
+                }
+            }
+        }
+
+        out.push_back(static_cast<uint8_t>(bestRepresentation | (bestOrder << 2)));
+
+        if (bestRepresentation == Verbatim)
+        {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(block);
+            out.insert(out.end(), bytes, bytes + static_cast<size_t>(length) * sizeof(float));
+            continue;
+        }
+
+        for (int i = 0; i < length; ++i)
+        {
+            if (bestRepresentation == Scaled)
+                toScaled(block[i], values[static_cast<size_t>(i)]);
+            else
+                values[static_cast<size_t>(i)] = toOrdered(bitsOf(block[i]));
+        }
+        for (int i = 0; i < length; ++i)
+            residuals[static_cast<size_t>(i)] = zigzag(values[static_cast<size_t>(i)] - predict(values.data(), i, bestOrder));
+
+        BitWriter writer(out);
+        writeResiduals(writer, residuals.data(), length);
+        writer.flush();
+    }
+}
+
+bool decode(const uint8_t* data, size_t numBytes, float* samples, int numSamples)
+{
+    std::vector<int64_t> values(static_cast<size_t>(std::max(0, std::min(numSamples, kBlockSize))));
+    std::vector<uint64_t> residuals(values.size());
+
+    size_t position = 0;
+    for (int blockStart = 0; blockStart < numSamples; blockStart += kBlockSize)
+    {
+        float* block = samples + blockStart;
+        const int length = std::min(kBlockSize, numSamples - blockStart);
+
+        if (position >= numBytes)
+            return false;
+        const uint8_t mode = data[position++];
+        const auto representation = static_cast<Representation>(mode & 3);
+        const int order = mode >> 2;
+
+        if (representation == Verbatim && order == 0)
+        {
+            const auto blockBytes = static_cast<size_t>(length) * sizeof(float);
+            if (numBytes - position < blockBytes)
+                return false;
+            std::memcpy(block, data + position, blockBytes);
+            position += blockBytes;
+            continue;
+        }
+
+        if ((representation != Scaled && representation != FloatBits) || order < 1 || order > kMaxOrder)
+            return false;
+
+        BitReader reader(data + position, numBytes - position);
+        if (!readResiduals(reader, residuals.data(), length))
+            return false;
+        position += reader.getBytesUsed();
+
+        for (int i = 0; i < length; ++i)
+        {
+            // wraps instead of overflowing on corrupt data, which the range checks then reject
+            const auto value = static_cast<int64_t>(static_cast<uint64_t>(unzigzag(residuals[static_cast<size_t>(i)]))
+                                                    + static_cast<uint64_t>(predict(values.data(), i, order)));
+            values[static_cast<size_t>(i)] = value;
+
+            if (representation == Scaled)
+            {
+                if (value < -static_cast<int64_t>(kMaxScaled) || value > static_cast<int64_t>(kMaxScaled))
+                    return false;
+                block[i] = fromScaled(value);
+            }
+            else
+            {
+                if (value < 0 || value > static_cast<int64_t>(0xffffffffu))
+                    return false;
+                block[i] = floatOf(fromOrdered(static_cast<uint32_t>(value)));
+            }
+        }
+    }
+    return position == numBytes;
+}
+}
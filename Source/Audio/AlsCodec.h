@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lossless coding for one channel of .als audio (AlsFormat::Codec::Lossless).
+ *
+ * The samples are coded in independent blocks of kBlockSize. Each block is
+ * turned into integers one of two ways, whichever predicts better:
+ * - scaled: samples that are exact multiples of 2^-23 (anything that came from
+ *   16 or 24-bit audio, and silence) as those integers;
+ * - float bits: any sample, as its IEEE bits reordered so that larger floats are
+ *   larger integers (sign-magnitude to offset binary), so neighbouring samples of
+ *   similar size are close.
+ * A fixed first or second-order predictor (as in FLAC) leaves residuals, which
+ * are zigzag mapped and Rice coded with a parameter chosen per kPartitionSize
+ * residuals. A block that would not shrink is stored verbatim. Decoding
+ * reproduces every bit, including -0, denormals and NaN payloads.
+ *
+ * Blocks don't depend on each other, so a channel can be encoded in pieces that
+ * start on multiples of kBlockSize and the codes concatenated.
+ *
+ * Stateless and allocation-light: safe to run on any number of threads at once.
+ */
+namespace AlsCodec
+{
+    constexpr int kBlockSize = 4096;
+    constexpr int kPartitionSize = 256;
+
+    // Appends the coded samples to out
+    void encode(const float* samples, int numSamples, std::vector<uint8_t>& out);
+
+    // False when the data is truncated or malformed for numSamples samples
+    bool decode(const uint8_t* data, size_t numBytes, float* samples, int numSamples);
+}
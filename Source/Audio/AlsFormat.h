@@ -5,11 +5,24 @@
 
 namespace AlsFormat {
 
-// File Structure: [0:512] Fixed Header | [512:N] JSON Metadata | [N:end] Binary Audio
+// File Structure (v3):
+// [0:512] Fixed Header | [512:N] JSON Metadata | [8-aligned] Chunk Table | [4 KiB-aligned] Audio Chunks
+// An incremental save appends its JSON and table after the audio instead; the header says where they are.
+// v2 always had the JSON at 512; v1 had no chunk table: length-prefixed audio blocks straight after the JSON.
 constexpr uint32_t MAGIC = 0x00534C41;  // "ALS\0"
 constexpr uint32_t VERSION = static_cast<uint32_t>(TrackConfig::PROJECT_VERSION);
+constexpr uint32_t VERSION_CHUNKED = 2;                 // first version with a chunk table
+constexpr uint32_t VERSION_JSON_OFFSET = 3;             // first version whose JSON can be anywhere
 constexpr size_t HEADER_SIZE = 512;
 constexpr uint16_t BITS_PER_SAMPLE = 32;
+constexpr uint32_t CHUNK_ALIGNMENT = 4096;              // page size, so a mapped chunk is an aligned float array
+constexpr uint64_t CHUNK_TABLE_ALIGNMENT = 8;
+
+// How the audio chunks are stored (header field, v2)
+enum class Codec : uint32_t {
+    None = 0,                  // raw 32-bit float, usable in place from a mapped file
+    Lossless = 1               // AlsCodec: predicted, Rice-coded, bit-exact
+};
 
 #pragma pack(push, 1)
 struct Header {
@@ -22,15 +35,38 @@ struct Header {
     uint16_t numChannels;      // 1=mono, 2=stereo
     uint16_t numTracks;
     uint16_t reserved1;
-    uint8_t  reserved2[476];   // Padding to 512 bytes
+    // v2
+    uint64_t chunkTableOffset; // From the start of the file
+    uint32_t numChunks;
+    uint32_t chunkAlignment;   // Every chunk offset is a multiple of this
+    uint32_t codec;            // Codec of every audio chunk (0 in files from before it existed)
+    // v3
+    uint64_t jsonOffset;       // From the start of the file
+    uint8_t  reserved2[448];   // Padding to 512 bytes
+};
+
+/**
+ * One channel of one track's audio (v2). Chunks are in track, then channel, order.
+ */
+struct ChunkEntry {
+    uint16_t trackIndex;
+    uint16_t channel;
+    uint32_t reserved1;
+    uint64_t offset;           // From the start of the file, a multiple of chunkAlignment
+    uint64_t length;           // Stored bytes (numSamples * 4 unless coded)
+    uint64_t numSamples;
+    uint64_t contentHash;      // ContentHash of the raw float samples (0 in files from before it existed)
+    uint64_t reserved2;        // Future use, zero
 };
 #pragma pack(pop)
 
 static_assert(sizeof(Header) == HEADER_SIZE, "Header must be exactly 512 bytes");
+static_assert(sizeof(ChunkEntry) == 48, "Chunk table entries are 48 bytes");
 
 /**
  * Binary audio layout for active tracks:
- * [uint32_t numSamples][uint32_t numChannels][float data...]
+ * v2: one chunk per channel, raw 32-bit float or AlsCodec, at the offsets in the chunk table
+ * v1: [uint32_t numSamples][uint32_t numChannels][float data...]
  */
 
 inline void initHeader(Header& h) {
@@ -38,6 +74,23 @@ inline void initHeader(Header& h) {
     h.magic = MAGIC;
     h.version = VERSION;
     h.bitsPerSample = BITS_PER_SAMPLE;
+    h.chunkAlignment = CHUNK_ALIGNMENT;
+    h.codec = static_cast<uint32_t>(Codec::None);
+    h.jsonOffset = HEADER_SIZE;
+}
+
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// The chunk table follows the JSON
+constexpr uint64_t chunkTableOffset(uint64_t jsonLength, uint64_t jsonOffset = HEADER_SIZE) {
+    return alignUp(jsonOffset + jsonLength, CHUNK_TABLE_ALIGNMENT);
+}
+
+// The first chunk follows the table, on a chunk boundary
+constexpr uint64_t firstChunkOffset(uint64_t jsonLength, uint32_t numChunks) {
+    return alignUp(chunkTableOffset(jsonLength) + uint64_t { numChunks } * sizeof(ChunkEntry), CHUNK_ALIGNMENT);
 }
 
-} // namespace AlsFormat
\ No newline at end of file
+} // namespace AlsFormat
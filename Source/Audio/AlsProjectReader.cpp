@@ -0,0 +1,320 @@
+#include "AlsProjectReader.h"
+
+#include <cstring>
+#include <limits>
+
+#include "AlsCodec.h"
+
+namespace
+{
+    constexpr int kMaxTrackChannels = 2;
+
+    bool readExactly(juce::InputStream& stream, void* destination, juce::int64 numBytes)
+    {
+        return numBytes >= 0 && numBytes <= std::numeric_limits<int>::max()
+               && stream.read(destination, static_cast<size_t>(numBytes)) == static_cast<int>(numBytes);
+    }
+}
+
+AlsProjectReader::AlsProjectReader(const juce::File& source)
+    : file(source)
+{
+    juce::FileInputStream stream(file);
+    if (!stream.openedOk())
+    {
+        DBG("AlsProjectReader: Failed to open " + file.getFullPathName());
+        return;
+    }
+    fileSize = stream.getTotalLength();
+
+    if (!readHeaderAndMetadata(stream))
+        return;
+
+    const bool haveChunks = header.version >= AlsFormat::VERSION_CHUNKED ? readChunkTable(stream)
+                                                                         : scanSequentialAudio(stream);
+    if (!haveChunks)
+        return;
+
+    // Reading through the mapping is only a fast path; without it chunks are read on demand
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mappedFile->getData() == nullptr || static_cast<juce::int64>(mappedFile->getSize()) < fileSize)
+        mappedFile.reset();
+
+    valid = true;
+}
+
+double AlsProjectReader::getSampleRate() const noexcept
+{
+    return header.sampleRate > 0 ? static_cast<double>(header.sampleRate)
+                                 : static_cast<double>(TrackConfig::DEFAULT_SAMPLE_RATE);
+}
+
+bool AlsProjectReader::hasTrackAudio(int trackIndex) const noexcept
+{
+    for (const auto& chunk : chunks)
+        if (chunk.trackIndex == trackIndex)
+            return true;
+    return false;
+}
+
+bool AlsProjectReader::getTrackAudio(int trackIndex, juce::AudioBuffer<float>& audio)
+{
+    bool needsRead = false;
+    if (!prepareTrackAudio(trackIndex, audio, needsRead))
+        return false;
+
+    for (int ch = 0; needsRead && ch < audio.getNumChannels(); ++ch)
+    {
+        if (!readTrackChannel(trackIndex, ch, audio.getWritePointer(ch)))
+        {
+            DBG("AlsProjectReader: Failed to read audio for track " + juce::String(trackIndex));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AlsProjectReader::prepareTrackAudio(int trackIndex, juce::AudioBuffer<float>& audio, bool& needsRead)
+{
+    const AlsFormat::ChunkEntry* trackChunks[kMaxTrackChannels] = {};
+    const int numChannels = findTrackChunks(trackIndex, trackChunks);
+    if (numChannels <= 0)
+        return false;
+
+    const int numSamples = static_cast<int>(trackChunks[0]->numSamples);
+
+    // In place when every channel is raw, mapped and aligned
+    float* channels[kMaxTrackChannels] = {};
+    bool inPlace = true;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        channels[ch] = const_cast<float*>(mappedSamples(*trackChunks[ch]));
+        inPlace = inPlace && channels[ch] != nullptr;
+    }
+
+    needsRead = !inPlace;
+    if (inPlace)
+        audio.setDataToReferTo(channels, numChannels, numSamples);
+    else
+        audio.setSize(numChannels, numSamples, false, false, true);
+    return true;
+}
+
+bool AlsProjectReader::readTrackChannel(int trackIndex, int channel, float* destination)
+{
+    const AlsFormat::ChunkEntry* trackChunks[kMaxTrackChannels] = {};
+    if (channel < 0 || channel >= findTrackChunks(trackIndex, trackChunks))
+        return false;
+
+    const auto& chunk = *trackChunks[channel];
+    const auto numSamples = static_cast<int>(chunk.numSamples);
+
+    if (getCodec() == AlsFormat::Codec::None)
+    {
+        if (const auto* mapped = mappedBytes(chunk))
+        {
+            std::memcpy(destination, mapped, static_cast<size_t>(chunk.length));
+            return true;
+        }
+        return readBytes(chunk, destination);
+    }
+
+    if (const auto* mapped = mappedBytes(chunk))
+        return AlsCodec::decode(static_cast<const uint8_t*>(mapped), static_cast<size_t>(chunk.length), destination, numSamples);
+
+    std::vector<uint8_t> coded(static_cast<size_t>(chunk.length));
+    return readBytes(chunk, coded.data())
+           && AlsCodec::decode(coded.data(), coded.size(), destination, numSamples);
+}
+
+bool AlsProjectReader::readHeaderAndMetadata(juce::FileInputStream& stream)
+{
+    if (!readExactly(stream, &header, static_cast<juce::int64>(AlsFormat::HEADER_SIZE)))
+    {
+        DBG("AlsProjectReader: Failed to read header");
+        return false;
+    }
+
+    if (header.magic != AlsFormat::MAGIC)
+    {
+        DBG("AlsProjectReader: Invalid magic (not an .als file)");
+        return false;
+    }
+    if (header.version > AlsFormat::VERSION)
+    {
+        DBG("AlsProjectReader: Unsupported format version " + juce::String(header.version));
+        return false;
+    }
+    if (header.version < AlsFormat::VERSION_CHUNKED)
+        header.codec = static_cast<uint32_t>(AlsFormat::Codec::None);
+    if (header.version < AlsFormat::VERSION_JSON_OFFSET)
+        header.jsonOffset = AlsFormat::HEADER_SIZE;
+    if (header.codec != static_cast<uint32_t>(AlsFormat::Codec::None)
+        && header.codec != static_cast<uint32_t>(AlsFormat::Codec::Lossless))
+    {
+        DBG("AlsProjectReader: Unknown audio codec " + juce::String(header.codec));
+        return false;
+    }
+    if (header.jsonOffset < AlsFormat::HEADER_SIZE || header.jsonOffset > static_cast<uint64_t>(fileSize)
+        || header.jsonLength > static_cast<uint64_t>(fileSize) - header.jsonOffset)
+    {
+        DBG("AlsProjectReader: Metadata runs past the end of the file");
+        return false;
+    }
+
+    juce::MemoryBlock jsonBlock(static_cast<size_t>(header.jsonLength));
+    if (!stream.setPosition(static_cast<juce::int64>(header.jsonOffset))
+        || !readExactly(stream, jsonBlock.getData(), static_cast<juce::int64>(header.jsonLength)))
+    {
+        DBG("AlsProjectReader: Failed to read JSON");
+        return false;
+    }
+
+    metadata = juce::JSON::parse(juce::String::fromUTF8(static_cast<const char*>(jsonBlock.getData()),
+                                                        static_cast<int>(header.jsonLength)));
+    if (!metadata.isObject())
+    {
+        DBG("AlsProjectReader: Invalid JSON metadata");
+        return false;
+    }
+    return true;
+}
+
+bool AlsProjectReader::readChunkTable(juce::FileInputStream& stream)
+{
+    if (header.numChunks == 0)
+        return true;
+
+    const auto tableBytes = static_cast<juce::int64>(header.numChunks) * static_cast<juce::int64>(sizeof(AlsFormat::ChunkEntry));
+    if (header.chunkAlignment == 0 || header.chunkTableOffset > static_cast<uint64_t>(fileSize)
+        || tableBytes > fileSize - static_cast<juce::int64>(header.chunkTableOffset))
+    {
+        DBG("AlsProjectReader: Invalid chunk table");
+        return false;
+    }
+
+    chunks.resize(header.numChunks);
+    if (!stream.setPosition(static_cast<juce::int64>(header.chunkTableOffset))
+        || !readExactly(stream, chunks.data(), tableBytes))
+    {
+        DBG("AlsProjectReader: Failed to read chunk table");
+        chunks.clear();
+        return false;
+    }
+
+    for (const auto& chunk : chunks)
+    {
+        const bool lengthMatches = getCodec() != AlsFormat::Codec::None || chunk.length == chunk.numSamples * sizeof(float);
+        if (chunk.offset % header.chunkAlignment != 0 || !lengthMatches
+            || chunk.numSamples > static_cast<uint64_t>(std::numeric_limits<int>::max()) || !isChunkInFile(chunk))
+        {
+            DBG("AlsProjectReader: Invalid chunk for track " + juce::String(chunk.trackIndex));
+            chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * v1: [int32 numSamples][int32 numChannels][planar floats] for each track with
+ * audio, in the order the JSON lists them.
+ */
+bool AlsProjectReader::scanSequentialAudio(juce::FileInputStream& stream)
+{
+    const auto* tracks = metadata.getProperty("tracks", juce::var()).getArray();
+    if (tracks == nullptr)
+        return true;
+
+    auto position = static_cast<juce::int64>(AlsFormat::HEADER_SIZE + header.jsonLength);
+    for (const auto& track : *tracks)
+    {
+        if (!track.isObject() || !static_cast<bool>(track.getProperty("hasAudio", false)))
+            continue;
+
+        if (!stream.setPosition(position))
+            break;
+        const int numSamples = stream.readInt();
+        const int numChannels = stream.readInt();
+        const auto channelBytes = static_cast<juce::int64>(numSamples) * static_cast<juce::int64>(sizeof(float));
+        position += 2 * static_cast<juce::int64>(sizeof(int));
+
+        if (numSamples <= 0 || numChannels <= 0 || numChannels > kMaxTrackChannels
+            || position + numChannels * channelBytes > fileSize)
+        {
+            // the blocks are only found by walking them, so nothing after a bad one is usable
+            DBG("AlsProjectReader: Invalid audio block for track " + track.getProperty("index", 0).toString());
+            break;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            AlsFormat::ChunkEntry chunk {};
+            chunk.trackIndex = static_cast<uint16_t>(static_cast<int>(track.getProperty("index", 0)));
+            chunk.channel = static_cast<uint16_t>(ch);
+            chunk.offset = static_cast<uint64_t>(position);
+            chunk.length = static_cast<uint64_t>(channelBytes);
+            chunk.numSamples = static_cast<uint64_t>(numSamples);
+            chunks.push_back(chunk);
+            position += channelBytes;
+        }
+    }
+    return true;
+}
+
+bool AlsProjectReader::isChunkInFile(const AlsFormat::ChunkEntry& chunk) const noexcept
+{
+    const auto size = static_cast<uint64_t>(fileSize);
+    return chunk.offset <= size && chunk.length <= size - chunk.offset;
+}
+
+int AlsProjectReader::findTrackChunks(int trackIndex, const AlsFormat::ChunkEntry** trackChunks) const
+{
+    // A track's chunks are adjacent in the table, channel 0 first
+    int numChannels = 0;
+    for (const auto& chunk : chunks)
+    {
+        if (chunk.trackIndex != trackIndex)
+            continue;
+        if (numChannels == kMaxTrackChannels || chunk.channel != numChannels
+            || (numChannels > 0 && chunk.numSamples != trackChunks[0]->numSamples))
+        {
+            DBG("AlsProjectReader: Inconsistent chunks for track " + juce::String(trackIndex));
+            return -1;
+        }
+        trackChunks[numChannels++] = &chunk;
+    }
+    return numChannels;
+}
+
+const void* AlsProjectReader::mappedBytes(const AlsFormat::ChunkEntry& chunk) const noexcept
+{
+    if (!isMapped())
+        return nullptr;
+    return static_cast<const char*>(mappedFile->getData()) + chunk.offset;
+}
+
+const float* AlsProjectReader::mappedSamples(const AlsFormat::ChunkEntry& chunk) const noexcept
+{
+    if (getCodec() != AlsFormat::Codec::None || chunk.offset % alignof(float) != 0)
+        return nullptr;
+    return static_cast<const float*>(mappedBytes(chunk));
+}
+
+bool AlsProjectReader::readBytes(const AlsFormat::ChunkEntry& chunk, void* destination)
+{
+    const juce::ScopedLock lock(fallbackLock);
+
+    if (fallbackStream == nullptr)
+    {
+        fallbackStream = std::make_unique<juce::FileInputStream>(file);
+        if (!fallbackStream->openedOk())
+        {
+            fallbackStream.reset();
+            return false;
+        }
+    }
+
+    return fallbackStream->setPosition(static_cast<juce::int64>(chunk.offset))
+           && readExactly(*fallbackStream, destination, static_cast<juce::int64>(chunk.length));
+}
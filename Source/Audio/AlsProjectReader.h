@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include "AlsFormat.h"
+
+/**
+ * Random access to a saved .als project.
+ *
+ * The constructor reads the header, the JSON metadata and the chunk table (for
+ * v1 files, which have none, it walks the audio blocks once to build one), then
+ * maps the file into memory. getTrackAudio() hands out any track's channels
+ * without reading the others: for raw v2 chunks, whose offsets are page
+ * aligned, the buffer refers straight to the mapped file, so nothing is read
+ * until the samples are touched. Coded chunks are decoded from the mapping, and
+ * when the file can't be mapped, or a v1 block isn't float aligned, the track
+ * is read into the buffer instead.
+ *
+ * To spread a load over several threads, size every buffer with
+ * prepareTrackAudio() first, then fill the channels that need it with
+ * readTrackChannel(), which may run for different channels at the same time.
+ * Views stay valid while the reader lives.
+ */
+class AlsProjectReader
+{
+public:
+    explicit AlsProjectReader(const juce::File& source);
+
+    bool isValid() const noexcept { return valid; }
+    bool isMapped() const noexcept { return mappedFile != nullptr && mappedFile->getData() != nullptr; }
+
+    const AlsFormat::Header& getHeader() const noexcept { return header; }
+    const juce::var& getMetadata() const noexcept { return metadata; }
+    const std::vector<AlsFormat::ChunkEntry>& getChunks() const noexcept { return chunks; }
+
+    double getSampleRate() const noexcept;
+    bool hasTrackAudio(int trackIndex) const noexcept;
+
+    AlsFormat::Codec getCodec() const noexcept { return static_cast<AlsFormat::Codec>(header.codec); }
+
+    // False when the track has no audio or its chunks can't be read
+    bool getTrackAudio(int trackIndex, juce::AudioBuffer<float>& audio);
+
+    // Sizes audio for the track, or points it at the mapped file when the chunks can be used
+    // as they are; needsRead says whether readTrackChannel() must still fill the channels.
+    bool prepareTrackAudio(int trackIndex, juce::AudioBuffer<float>& audio, bool& needsRead);
+    // Reads or decodes one channel into a prepared buffer (thread safe)
+    bool readTrackChannel(int trackIndex, int channel, float* destination);
+
+private:
+    juce::File file;
+    juce::int64 fileSize = 0;
+    AlsFormat::Header header {};
+    juce::var metadata;
+    std::vector<AlsFormat::ChunkEntry> chunks;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::unique_ptr<juce::FileInputStream> fallbackStream;
+    juce::CriticalSection fallbackLock;                 // readTrackChannel() runs on several threads
+    bool valid = false;
+
+    bool readHeaderAndMetadata(juce::FileInputStream& stream);
+    bool readChunkTable(juce::FileInputStream& stream);
+    bool scanSequentialAudio(juce::FileInputStream& stream);
+    bool isChunkInFile(const AlsFormat::ChunkEntry& chunk) const noexcept;
+    int findTrackChunks(int trackIndex, const AlsFormat::ChunkEntry** trackChunks) const;
+    const void* mappedBytes(const AlsFormat::ChunkEntry& chunk) const noexcept;
+    const float* mappedSamples(const AlsFormat::ChunkEntry& chunk) const noexcept;
+    bool readBytes(const AlsFormat::ChunkEntry& chunk, void* destination);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AlsProjectReader)
+};
@@ -0,0 +1,303 @@
+#include "ConvolutionReverbBus.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr int kHeadBlock = TrackConfig::REVERB_HEAD_BLOCK_SIZE;
+constexpr int kTailBlock = TrackConfig::REVERB_TAIL_BLOCK_SIZE;
+// The head covers two tail blocks: one for the block to fill, one for the worker to finish it.
+constexpr int kTailStart = 2 * kTailBlock;
+// Tail ring length in tail blocks; the worker never runs more than ~4 blocks ahead of the reader.
+constexpr int kRingBlocks = 8;
+constexpr int kMaxIrChannels = 2;
+constexpr int kWorkerPollMs = 1;
+constexpr double kFadeInSeconds = 0.002;
+
+static_assert(kTailBlock % kHeadBlock == 0, "tail partitions must be whole head partitions");
+}
+
+struct ConvolutionReverbBus::Engine
+{
+    PartitionedConvolver head;                  // audio thread
+    PartitionedConvolver tail;                  // tail thread
+    bool hasTail = false;
+    int numOutputs = 1;
+    int ringLength = kRingBlocks * kTailBlock;
+    juce::int64 dormantAfterSamples = 0;
+
+    // head streaming (audio thread)
+    std::vector<float> headInput;
+    juce::AudioBuffer<float> headOutput;
+    int headFill = 0;
+
+    // tail handoff: audio thread writes input and publishes whole blocks,
+    // the tail thread convolves them and publishes the output blocks
+    std::vector<float> tailInputRing;
+    juce::AudioBuffer<float> tailOutputRing;
+    std::atomic<juce::int64> tailBlocksSubmitted { 0 };
+    std::atomic<juce::int64> tailBlocksDone { 0 };
+
+    juce::int64 inputPosition = 0;              // send samples consumed while awake
+    juce::int64 silentSamples = 0;
+};
+
+ConvolutionReverbBus::ConvolutionReverbBus()
+    : juce::Thread("Reverb Tail")
+{
+}
+
+ConvolutionReverbBus::~ConvolutionReverbBus()
+{
+    stopThread(1000);
+}
+
+void ConvolutionReverbBus::prepare(double sampleRateIn)
+{
+    sampleRate = sampleRateIn;
+    rebuildEngine();
+}
+
+void ConvolutionReverbBus::releaseResources()
+{
+    stopThread(1000);
+
+    std::unique_ptr<Engine> retired;
+    {
+        const juce::SpinLock::ScopedLockType lock(engineLock);
+        std::swap(engine, retired);
+    }
+}
+
+void ConvolutionReverbBus::loadImpulseResponse(const juce::AudioBuffer<float>& impulseResponse, double impulseSampleRate)
+{
+    userImpulseResponse.makeCopyOf(impulseResponse);
+    userImpulseSampleRate = impulseSampleRate;
+
+    if (sampleRate > 0.0)
+        rebuildEngine();
+}
+
+/**
+ * Builds the new engine off the audio thread, then swaps it in. The tail thread
+ * is stopped across the swap so it never sees a retired engine; the audio thread
+ * simply skips the return for a block if it hits the swap.
+ */
+void ConvolutionReverbBus::rebuildEngine()
+{
+    stopThread(1000);
+
+    std::unique_ptr<Engine> next;
+    if (sampleRate > 0.0)
+    {
+        next = userImpulseResponse.getNumSamples() > 0
+            ? buildEngine(userImpulseResponse, userImpulseSampleRate)
+            : buildEngine(createDefaultImpulseResponse(sampleRate), sampleRate);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(engineLock);
+        std::swap(engine, next);
+    }
+
+    lateTailBlocks.store(0, std::memory_order_relaxed);
+    dormant.store(false, std::memory_order_relaxed);
+
+    if (engine != nullptr && engine->hasTail)
+        startThread(juce::Thread::Priority::high);
+
+    // the previous engine is released here, on the message thread
+}
+
+std::unique_ptr<ConvolutionReverbBus::Engine> ConvolutionReverbBus::buildEngine(const juce::AudioBuffer<float>& source,
+                                                                                double sourceRate) const
+{
+    const int numChannels = juce::jlimit(1, kMaxIrChannels, source.getNumChannels());
+    const double ratio = sourceRate > 0.0 ? sourceRate / sampleRate : 1.0;
+    const int maxLength = static_cast<int>(TrackConfig::REVERB_MAX_IR_SECONDS * sampleRate);
+    const int length = juce::jlimit(0, maxLength, static_cast<int>(std::ceil(source.getNumSamples() / ratio)));
+
+    // match the IR to the engine rate
+    juce::AudioBuffer<float> ir(numChannels, juce::jmax(1, length));
+    ir.clear();
+    for (int channel = 0; channel < numChannels && source.getNumChannels() > 0; ++channel)
+    {
+        if (ratio == 1.0)
+        {
+            ir.copyFrom(channel, 0, source, channel, 0, juce::jmin(length, source.getNumSamples()));
+        }
+        else
+        {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, source.getReadPointer(channel), ir.getWritePointer(channel),
+                                 length, source.getNumSamples(), 0);
+        }
+    }
+
+    auto built = std::make_unique<Engine>();
+    built->numOutputs = numChannels;
+    built->hasTail = length > kTailStart;
+    built->head.prepare(kHeadBlock, ir, 0, juce::jmin(length, kTailStart));
+    if (built->hasTail)
+        built->tail.prepare(kTailBlock, ir, kTailStart, length - kTailStart);
+
+    built->headInput.assign(static_cast<size_t>(kHeadBlock), 0.0f);
+    built->headOutput.setSize(numChannels, kHeadBlock);
+    built->headOutput.clear();
+    built->tailInputRing.assign(static_cast<size_t>(built->ringLength), 0.0f);
+    built->tailOutputRing.setSize(numChannels, built->ringLength);
+    built->tailOutputRing.clear();
+
+    // by then every partition and both rings hold only the response to silence
+    built->dormantAfterSamples = static_cast<juce::int64>(length) + kTailStart + 3 * kTailBlock + kHeadBlock;
+    return built;
+}
+
+void ConvolutionReverbBus::processReturn(const float* sendInput, juce::AudioBuffer<float>& master,
+                                         int numSamples, bool sendIsSilent) noexcept
+{
+    const juce::SpinLock::ScopedTryLockType lock(engineLock);
+    if (!lock.isLocked() || engine == nullptr || numSamples <= 0)
+        return;
+
+    auto& e = *engine;
+
+    // Dormant once the whole IR has rung out and the tail thread has caught up.
+    // Every internal state is zero then, so pausing the timeline is inaudible.
+    e.silentSamples = sendIsSilent ? e.silentSamples + numSamples : 0;
+    const bool tailIdle = e.tailBlocksDone.load(std::memory_order_acquire)
+                          == e.tailBlocksSubmitted.load(std::memory_order_relaxed);
+    const bool sleep = sendIsSilent && tailIdle && e.silentSamples > e.dormantAfterSamples;
+    dormant.store(sleep, std::memory_order_relaxed);
+    if (sleep)
+        return;
+
+    const int masterChannels = master.getNumChannels();
+    int done = 0;
+
+    // segments never cross a head block boundary, so never a tail block boundary either
+    while (done < numSamples)
+    {
+        const int count = juce::jmin(numSamples - done, kHeadBlock - e.headFill);
+
+        juce::FloatVectorOperations::copy(e.headInput.data() + e.headFill, sendInput + done, count);
+        if (e.hasTail)
+        {
+            const auto ringOffset = static_cast<int>(e.inputPosition % e.ringLength);
+            juce::FloatVectorOperations::copy(e.tailInputRing.data() + ringOffset, sendInput + done, count);
+        }
+
+        // tail output for this segment was rendered from input kTailStart + kHeadBlock samples ago
+        const juce::int64 tailPosition = e.inputPosition - kHeadBlock - kTailStart;
+        bool tailReady = false;
+        if (e.hasTail && tailPosition >= 0)
+        {
+            tailReady = e.tailBlocksDone.load(std::memory_order_acquire) > tailPosition / kTailBlock;
+            if (!tailReady && tailPosition % kTailBlock == 0)
+                lateTailBlocks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        for (int channel = 0; channel < masterChannels; ++channel)
+        {
+            const int source = juce::jmin(channel, e.numOutputs - 1);
+            float* dest = master.getWritePointer(channel, done);
+
+            // head output is the previous head block, i.e. kHeadBlock samples of pre-delay
+            juce::FloatVectorOperations::add(dest, e.headOutput.getReadPointer(source, e.headFill), count);
+            if (tailReady)
+                juce::FloatVectorOperations::add(dest,
+                                                 e.tailOutputRing.getReadPointer(source, static_cast<int>(tailPosition % e.ringLength)),
+                                                 count);
+        }
+
+        e.headFill += count;
+        e.inputPosition += count;
+        done += count;
+
+        if (e.headFill == kHeadBlock)
+        {
+            e.head.processBlock(e.headInput.data(), e.headOutput.getArrayOfWritePointers());
+            e.headFill = 0;
+        }
+
+        if (e.hasTail && e.inputPosition % kTailBlock == 0)
+            e.tailBlocksSubmitted.store(e.inputPosition / kTailBlock, std::memory_order_release);
+    }
+}
+
+// === Tail thread ===
+
+void ConvolutionReverbBus::run()
+{
+    // Polling keeps the audio thread free of any wake-up call that could lock;
+    // a 1 ms poll is far inside the one-tail-block deadline.
+    while (!threadShouldExit())
+    {
+        if (!processPendingTailBlocks())
+            wait(kWorkerPollMs);
+    }
+}
+
+bool ConvolutionReverbBus::processPendingTailBlocks()
+{
+    // the engine is only swapped while this thread is stopped
+    auto* e = engine.get();
+    if (e == nullptr || !e->hasTail)
+        return false;
+
+    juce::int64 done = e->tailBlocksDone.load(std::memory_order_relaxed);
+    const juce::int64 submitted = e->tailBlocksSubmitted.load(std::memory_order_acquire);
+    if (done >= submitted)
+        return false;
+
+    // Too far behind: the oldest input has been overwritten. Drop it and resync.
+    const juce::int64 maxBacklog = kRingBlocks / 2;
+    if (submitted - done > maxBacklog)
+    {
+        for (; done < submitted - maxBacklog; ++done)
+            e->tailOutputRing.clear(static_cast<int>((done * kTailBlock) % e->ringLength), kTailBlock);
+        e->tail.reset();
+        e->tailBlocksDone.store(done, std::memory_order_release);
+    }
+
+    while (done < submitted && !threadShouldExit())
+    {
+        const auto offset = static_cast<int>((done * kTailBlock) % e->ringLength);
+        float* outputs[kMaxIrChannels] = {};
+        for (int channel = 0; channel < e->numOutputs; ++channel)
+            outputs[channel] = e->tailOutputRing.getWritePointer(channel, offset);
+
+        e->tail.processBlock(e->tailInputRing.data() + offset, outputs);
+        e->tailBlocksDone.store(++done, std::memory_order_release);
+    }
+    return true;
+}
+
+// === Default impulse response ===
+
+juce::AudioBuffer<float> ConvolutionReverbBus::createDefaultImpulseResponse(double sampleRate)
+{
+    const int length = juce::jmax(1, static_cast<int>(TrackConfig::REVERB_DEFAULT_DECAY_SECONDS * sampleRate));
+    const int fadeIn = juce::jmax(1, static_cast<int>(kFadeInSeconds * sampleRate));
+    // -60 dB at the end of the decay
+    const double decayPerSample = std::log(0.001) / static_cast<double>(length);
+
+    juce::AudioBuffer<float> ir(2, length);
+    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    {
+        juce::Random random(0x5eed + channel);      // fixed seeds: deterministic, decorrelated L/R
+        auto* data = ir.getWritePointer(channel);
+        double energy = 0.0;
+
+        for (int s = 0; s < length; ++s)
+        {
+            const double envelope = std::exp(decayPerSample * s) * juce::jmin(1.0, static_cast<double>(s) / fadeIn);
+            data[s] = static_cast<float>((random.nextDouble() * 2.0 - 1.0) * envelope);
+            energy += static_cast<double>(data[s]) * data[s];
+        }
+
+        if (energy > 0.0)
+            juce::FloatVectorOperations::multiply(data, static_cast<float>(1.0 / std::sqrt(energy)), length);
+    }
+    return ir;
+}
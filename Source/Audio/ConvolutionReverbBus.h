@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include "PartitionedConvolver.h"
+#include "../Utils/TrackConfig.h"
+
+/**
+ * Shared send/return convolution reverb for the master section.
+ *
+ * Tracks feed a mono send bus; the return is added to the master (stereo if the
+ * IR is stereo). The impulse response is split non-uniformly:
+ * - head: the first 2 * REVERB_TAIL_BLOCK_SIZE samples, convolved on the audio
+ *   thread with small REVERB_HEAD_BLOCK_SIZE partitions
+ * - tail: the rest, convolved on a background thread with large partitions.
+ *   The head is long enough that each tail block has a full tail block of time
+ *   to finish before it is needed.
+ *
+ * The audio thread hands input to the tail thread through a ring buffer and
+ * atomic block counters; it never waits. A tail block that is not ready in time
+ * is dropped (counted in getNumLateTailBlocks()). The return carries
+ * REVERB_HEAD_BLOCK_SIZE samples of pre-delay, which is not reported as latency
+ * because the dry path is not delayed.
+ *
+ * After the send has been silent for longer than the IR, the bus goes dormant
+ * and costs nothing until signal arrives again.
+ */
+class ConvolutionReverbBus : private juce::Thread
+{
+public:
+    ConvolutionReverbBus();
+    ~ConvolutionReverbBus() override;
+
+    // Rebuilds the engine for the sample rate (default IR unless one was loaded). Message thread.
+    void prepare(double sampleRate);
+    void releaseResources();
+
+    // Copies the IR (up to two channels, resampled if needed) and swaps it in. Message thread.
+    void loadImpulseResponse(const juce::AudioBuffer<float>& impulseResponse, double impulseSampleRate);
+
+    // Adds the wet return of numSamples send samples into master. Audio thread.
+    void processReturn(const float* sendInput, juce::AudioBuffer<float>& master,
+                       int numSamples, bool sendIsSilent) noexcept;
+
+    int getReturnDelaySamples() const noexcept { return TrackConfig::REVERB_HEAD_BLOCK_SIZE; }
+    int getNumLateTailBlocks() const noexcept { return lateTailBlocks.load(std::memory_order_relaxed); }
+    bool isDormant() const noexcept { return dormant.load(std::memory_order_relaxed); }
+
+    // Decorrelated stereo noise with an exponential decay, energy normalised per channel.
+    static juce::AudioBuffer<float> createDefaultImpulseResponse(double sampleRate);
+
+private:
+    struct Engine;
+
+    std::unique_ptr<Engine> engine;
+    juce::SpinLock engineLock;                  // audio thread only ever try-locks
+
+    juce::AudioBuffer<float> userImpulseResponse;
+    double userImpulseSampleRate = 0.0;
+    double sampleRate = 0.0;
+
+    std::atomic<int> lateTailBlocks { 0 };
+    std::atomic<bool> dormant { false };
+
+    void rebuildEngine();
+    std::unique_ptr<Engine> buildEngine(const juce::AudioBuffer<float>& impulseResponse, double impulseSampleRate) const;
+    bool processPendingTailBlocks();
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverbBus)
+};
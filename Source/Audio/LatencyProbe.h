@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "../Utils/TrackConfig.h"
+
+/**
+ * Measures the round trip from the main output back to the main input, for
+ * record latency compensation. Needs the output patched (or held by a mic)
+ * back into the input while it runs.
+ *
+ * start() asks for a measurement. At the end of the next slice the audio
+ * thread replaces the output with a short click, and from then on silence,
+ * and listens for the click in every following slice's input. The distance
+ * from the click to its echo, in timeline samples, is the offset a take has to
+ * be moved by to line up with the loops that were playing while it was made.
+ * Both sides only read and write atomics, so it can run during playback.
+ */
+class LatencyProbe
+{
+public:
+    static constexpr int kNoEcho = -1;
+
+    // === Audio thread, from prepareToPlay ===
+    void prepare(double sampleRate) noexcept
+    {
+        timeoutSamples = static_cast<juce::int64>(sampleRate * TrackConfig::LATENCY_PROBE_TIMEOUT_SECONDS);
+        phase.store(Phase::Idle, std::memory_order_release);
+    }
+
+    // === Message thread ===
+    void start() noexcept
+    {
+        auto expected = Phase::Idle;
+        phase.compare_exchange_strong(expected, Phase::Requested, std::memory_order_acq_rel);
+    }
+
+    bool isRunning() const noexcept
+    {
+        const auto current = phase.load(std::memory_order_acquire);
+        return current == Phase::Requested || current == Phase::Listening;
+    }
+
+    // True once per finished measurement; latencySamples is kNoEcho when nothing came back in time
+    bool takeResult(int& latencySamples) noexcept
+    {
+        if (phase.load(std::memory_order_acquire) != Phase::Finished)
+            return false;
+
+        latencySamples = result.load(std::memory_order_relaxed);
+        phase.store(Phase::Idle, std::memory_order_release);
+        return true;
+    }
+
+    // === Audio thread, once per slice ===
+    // Before anything reads the input
+    void listen(const juce::AudioBuffer<float>& input, int numInputChannels) noexcept
+    {
+        if (phase.load(std::memory_order_acquire) != Phase::Listening)
+            return;
+
+        const int numSamples = input.getNumSamples();
+        const int numChannels = juce::jmin(numInputChannels, input.getNumChannels());
+
+        int echo = numSamples;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* data = input.getReadPointer(ch);
+            for (int i = 0; i < echo; ++i)
+            {
+                if (std::abs(data[i]) >= TrackConfig::LATENCY_PROBE_THRESHOLD)
+                {
+                    echo = i;
+                    break;
+                }
+            }
+        }
+
+        if (echo < numSamples)
+            finish(static_cast<int>(juce::jmin<juce::int64>(elapsed + echo, TrackConfig::MAX_RECORD_LATENCY_SAMPLES)));
+        else if ((elapsed += numSamples) > timeoutSamples)
+            finish(kNoEcho);
+    }
+
+    // After the output is complete
+    void emit(juce::AudioBuffer<float>& output) noexcept
+    {
+        const auto current = phase.load(std::memory_order_acquire);
+        if (current != Phase::Requested && current != Phase::Listening)
+            return;
+
+        // nothing but the click may come back while listening
+        output.clear();
+
+        if (current == Phase::Requested)
+        {
+            const int clickLength = juce::jmin(TrackConfig::LATENCY_PROBE_CLICK_SAMPLES, output.getNumSamples());
+            for (int ch = 0; ch < output.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::fill(output.getWritePointer(ch), TrackConfig::LATENCY_PROBE_CLICK_LEVEL, clickLength);
+
+            // the next slice's input starts this many samples after the click
+            elapsed = output.getNumSamples();
+            phase.store(Phase::Listening, std::memory_order_release);
+        }
+    }
+
+private:
+    enum class Phase { Idle, Requested, Listening, Finished };
+
+    std::atomic<Phase> phase { Phase::Idle };
+    std::atomic<int> result { kNoEcho };
+    juce::int64 elapsed = 0;                // audio thread: click to the start of this slice's input
+    juce::int64 timeoutSamples = 0;
+
+    void finish(int latencySamples) noexcept
+    {
+        result.store(latencySamples, std::memory_order_relaxed);
+        phase.store(Phase::Finished, std::memory_order_release);
+    }
+};
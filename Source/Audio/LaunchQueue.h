@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include <juce_core/juce_core.h>
+
+#include "SpscQueue.h"
+#include "../Utils/TrackConfig.h"
+
+namespace gin { class SamplePlayer; }
+
+/**
+ * Track commands from the message thread, each run on the audio thread either
+ * at the next block or at a musical boundary (next beat, next bar or the next
+ * wrap of a loop), ordered by the timeline sample they are due on.
+ *
+ * The message thread push()es into a lock-free single-producer queue. At the
+ * start of each block the audio thread drains it, resolves each new event's
+ * quantisation to a sample and moves it into a binary min-heap: O(log n) in
+ * and out, and peeking at the next due time is O(1). Events due on the same
+ * sample keep the order they were queued in. Both stores have a fixed
+ * capacity, so nothing here allocates or locks.
+ *
+ * An event may carry a player built on the message thread (new audio, or an
+ * empty one to swap in when a track drops its audio); whoever consumes the
+ * event owns it.
+ */
+class LaunchQueue
+{
+public:
+    enum class Quantize
+    {
+        Immediate,
+        NextBeat,
+        NextBar,
+        NextLoopWrap            // of the event's track, or the first looping track
+    };
+
+    enum class Action
+    {
+        StartRecording,
+        StopRecording,
+        StartPlayback,
+        StopPlayback,
+        Clear,
+        Multiply,
+        Divide,
+        Undo,
+        Arm,
+        Disarm,
+        Unload,                 // drop the audio, keep the settings
+        LoadAudio,              // install the event's player
+        AdoptAudio              // loaded audio becomes the loop; value = its downbeat offset
+    };
+
+    static constexpr int kAllTracks = -1;
+    static constexpr int kCapacity = TrackConfig::LAUNCH_QUEUE_CAPACITY;
+    static constexpr juce::int64 kNever = std::numeric_limits<juce::int64>::max();
+
+    struct Event
+    {
+        Action action = Action::StartPlayback;
+        int track = kAllTracks;
+        Quantize quantize = Quantize::Immediate;
+        gin::SamplePlayer* player = nullptr;  // owned by the event
+        int value = 0;                      // action argument
+        juce::int64 dueSample = 0;          // resolved on the audio thread
+        std::uint32_t order = 0;
+    };
+
+    // === Message thread (the only producer) ===
+    // False when the inbox is full (the audio thread isn't running or is far behind);
+    // the caller still owns the event's player then.
+    bool push(const Event& event) noexcept { return inbox.push(event); }
+
+    // Drops everything queued, including pushes made before the audio thread's next collect().
+    void cancelAll() noexcept { cancelRequested.store(true, std::memory_order_release); }
+
+    // === Audio thread ===
+    // Moves new events into the schedule; resolve(const Event&) returns their due sample.
+    // Cancelled events go to drop(const Event&), so their players can be reclaimed.
+    template <typename Resolve, typename Drop>
+    void collect(Resolve&& resolve, Drop&& drop) noexcept
+    {
+        Event event;
+        if (cancelRequested.exchange(false, std::memory_order_acquire))
+        {
+            for (int i = 0; i < scheduledSize; ++i)
+                drop(scheduled[static_cast<size_t>(i)]);
+            scheduledSize = 0;
+
+            while (inbox.pop(event))
+                drop(event);
+            return;
+        }
+
+        // a full schedule leaves the rest in the inbox, in order, for a later block
+        while (scheduledSize < kCapacity && inbox.pop(event))
+        {
+            event.dueSample = resolve(event);
+            event.order = nextOrder++;
+            scheduled[static_cast<size_t>(scheduledSize++)] = event;
+            std::push_heap(scheduled.begin(), scheduled.begin() + scheduledSize, LaterFirst{});
+        }
+    }
+
+    // Resolves every scheduled event again, e.g. after the timeline jumped.
+    template <typename Resolve>
+    void reschedule(Resolve&& resolve) noexcept
+    {
+        for (int i = 0; i < scheduledSize; ++i)
+            scheduled[static_cast<size_t>(i)].dueSample = resolve(scheduled[static_cast<size_t>(i)]);
+
+        std::make_heap(scheduled.begin(), scheduled.begin() + scheduledSize, LaterFirst{});
+    }
+
+    juce::int64 getNextDueSample() const noexcept
+    {
+        return scheduledSize > 0 ? scheduled[0].dueSample : kNever;
+    }
+
+    // Removes and returns the earliest event if it is due at or before position.
+    bool popDue(juce::int64 position, Event& event) noexcept
+    {
+        if (scheduledSize == 0 || scheduled[0].dueSample > position)
+            return false;
+
+        std::pop_heap(scheduled.begin(), scheduled.begin() + scheduledSize, LaterFirst{});
+        event = scheduled[static_cast<size_t>(--scheduledSize)];
+        return true;
+    }
+
+    int getNumScheduled() const noexcept { return scheduledSize; }
+
+private:
+    // std heaps keep the greatest element on top, so "greater" means due earlier
+    struct LaterFirst
+    {
+        bool operator()(const Event& a, const Event& b) const noexcept
+        {
+            if (a.dueSample != b.dueSample)
+                return a.dueSample > b.dueSample;
+            return static_cast<std::int32_t>(a.order - b.order) > 0;
+        }
+    };
+
+    SpscQueue<Event, static_cast<size_t>(kCapacity)> inbox;
+    std::atomic<bool> cancelRequested { false };
+
+    // audio thread only
+    std::array<Event, kCapacity> scheduled {};
+    int scheduledSize = 0;
+    std::uint32_t nextOrder = 0;
+};
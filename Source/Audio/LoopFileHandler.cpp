@@ -4,16 +4,123 @@
 
 #include "LoopFileHandler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
 LoopFileHandler::LoopFileHandler() {
     formatManager.registerBasicFormats(); // WAV, AIFF, FLAC, OGG
 }
 
-bool LoopFileHandler::loadAudioFile(const juce::File &file, LoopTrack& targetTrack) {
-    if (!isSupportedAudioFile(file)) {
-        DBG("Unsupported file type: "+file.getFileName());
+LoopFileHandler::~LoopFileHandler() {
+    // Let a running job stop at its next step and wait for it; its results are dropped
+    cancelJob();
+    if (jobPool) jobPool->removeAllJobs(false, -1);
+    if (jobActive && jobHoldsPlayers) jobLoopManager->releaseRetiredPlayers();
+}
+
+bool LoopFileHandler::loadAudioFile(const juce::File &file, LoopManager& loopManager, size_t trackIndex) {
+    if (loopManager.getTrack(trackIndex) == nullptr) {
+        DBG("No track " + juce::String(static_cast<int>(trackIndex)));
         return false;
     }
 
+    // readAudioFile() rejects unsupported files itself, with the one reader it decodes from
+    juce::AudioSampleBuffer buffer;
+    double fileSampleRate = 0.0;
+    if (!readAudioFile(file, buffer, fileSampleRate, nullptr, nullptr)) {
+        return false;
+    }
+
+    // Give buffer to track (copied into a player here, swapped in on the audio thread)
+    if (!loopManager.loadTrackAudio(trackIndex, buffer, fileSampleRate)) {
+        DBG("Failed to queue audio for Track " + juce::String(static_cast<int>(trackIndex)));
+        return false;
+    }
+
+    DBG("Successfully loaded into Track " + juce::String(static_cast<int>(trackIndex)));
+
+    if (onAudioFileLoaded) {
+        onAudioFileLoaded(trackIndex, buffer, fileSampleRate);
+    }
+
+    return true;
+}
+
+bool LoopFileHandler::loadAudioFileAsync(const juce::File& file, LoopManager& loopManager, size_t trackIndex) {
+    const LoopTrack* track = loopManager.getTrack(trackIndex);
+    if (track == nullptr) {
+        DBG("No track " + juce::String(static_cast<int>(trackIndex)));
+        return false;
+    }
+
+    return startJob(loopManager, nullptr, [this, file, track, trackIndex] {
+        LoadedTrack loaded;
+        loaded.trackIndex = trackIndex;
+        if (!readAudioFile(file, loaded.audio, loaded.sampleRate, &job, &job.progress)) return false;
+
+        // The copy into the player happens here rather than on the message thread
+        loaded.player = track->createPlayer(loaded.audio, loaded.sampleRate);
+        const juce::ScopedLock lock(resultLock);
+        loadedTracks.push_back(std::move(loaded));
+        return true;
+    });
+}
+
+bool LoopFileHandler::loadAudioFilesAsync(const juce::Array<juce::File>& files, LoopManager& loopManager,
+                                          size_t firstTrackIndex) {
+    if (files.isEmpty() || loopManager.getTrack(firstTrackIndex) == nullptr) {
+        DBG("No track " + juce::String(static_cast<int>(firstTrackIndex) + 1) + " to load files to");
+        return false;
+    }
+
+    // The files that fit load; the user is told about the rest
+    const int numFitting = juce::jmin(files.size(), static_cast<int>(loopManager.getNumTracks() - firstTrackIndex));
+    juce::Array<juce::File> fitting(files);
+    if (numFitting < files.size()) {
+        juce::StringArray leftOut;
+        for (int f = numFitting; f < files.size(); ++f) leftOut.add(files.getReference(f).getFileName());
+        fitting.removeRange(numFitting, files.size() - numFitting);
+        reportToUser("Only " + juce::String(numFitting) + " of the " + juce::String(files.size())
+                     + " files fit on the tracks from Track " + juce::String(static_cast<int>(firstTrackIndex) + 1)
+                     + ", so these were not loaded: " + leftOut.joinIntoString(", "));
+    }
+
+    std::vector<const LoopTrack*> tracks;
+    for (int f = 0; f < fitting.size(); ++f) {
+        tracks.push_back(loopManager.getTrack(firstTrackIndex + static_cast<size_t>(f)));
+    }
+
+    return startJob(loopManager, nullptr, [this, files = fitting, tracks, firstTrackIndex] {
+        // The files decode side by side; each is handed over as soon as it is done, in whatever order
+        std::atomic<int> filesDone { 0 }, filesFailed { 0 };
+        runInParallel(files.size(), [&](int f) {
+            if (job.shouldStop()) return;
+
+            LoadedTrack loaded;
+            loaded.trackIndex = firstTrackIndex + static_cast<size_t>(f);
+            if (readAudioFile(files.getReference(f), loaded.audio, loaded.sampleRate, &job, nullptr)) {
+                loaded.player = tracks[static_cast<size_t>(f)]->createPlayer(loaded.audio, loaded.sampleRate);
+                const juce::ScopedLock lock(resultLock);
+                loadedTracks.push_back(std::move(loaded));
+            } else if (!job.shouldStop()) {
+                ++filesFailed;
+                reportToUser(files.getReference(f).getFileName() + " could not be read, so Track "
+                             + juce::String(static_cast<int>(loaded.trackIndex) + 1) + " was left as it was.");
+            }
+            job.progress = static_cast<float>(++filesDone) / static_cast<float>(files.size());
+        });
+        return filesFailed == 0 && !job.shouldStop();
+    });
+}
+
+/**
+ * Decodes a whole file in slices, so a job can report progress and stop early.
+ * The file is opened once; the reader's conversion to float is vectorised.
+ */
+bool LoopFileHandler::readAudioFile(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate,
+                                    JobControl* control, std::atomic<float>* progress) {
     // Create reader for the file
     std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
 
@@ -25,28 +132,26 @@ bool LoopFileHandler::loadAudioFile(const juce::File &file, LoopTrack& targetTra
     // Get file info
     int numChannels = static_cast<int>(reader->numChannels);
     int numSamples = static_cast<int>(reader->lengthInSamples);
-    double fileSampleRate = reader->sampleRate;
+    sampleRate = reader->sampleRate;
 
     DBG("Loading file: " + file.getFileName());
     DBG(" Channels: " + juce::String(numChannels));
     DBG(" Samples: " + juce::String(numSamples));
-    DBG(" Sample Rate: " + juce::String(fileSampleRate));
+    DBG(" Sample Rate: " + juce::String(sampleRate));
 
     // Crate buffer and read audio
-    juce::AudioSampleBuffer buffer(numChannels,numSamples);
+    audio.setSize(numChannels, numSamples);
 
-    bool readSuccess = reader->read(&buffer, 0, numSamples, 0, true, true);
+    for (int start = 0; start < numSamples; start += TrackConfig::FILE_READ_SLICE_SAMPLES) {
+        if (control && control->shouldStop()) return false;
 
-    if (!readSuccess) {
-        DBG("Failed to read audio data");
-        return false;
+        const int length = juce::jmin(TrackConfig::FILE_READ_SLICE_SAMPLES, numSamples - start);
+        if (!reader->read(&audio, start, length, start, true, true)) {
+            DBG("Failed to read audio data");
+            return false;
+        }
+        if (progress) *progress = static_cast<float>(start + length) / static_cast<float>(numSamples);
     }
-
-    // Give buffer to track
-    targetTrack.setAudioBuffer(buffer, fileSampleRate);
-
-    DBG("Successfully loaded into Track " + juce::String(targetTrack.getTrackId()));
-
     return true;
 }
 
@@ -66,6 +171,201 @@ bool LoopFileHandler::isSupportedAudioFile(const juce::File &file) {
     return true;
 }
 
+void LoopFileHandler::runInParallel(int numTasks, const std::function<void(int)>& task) {
+    if (numTasks <= 0) return;
+
+    // Sync calls on the message thread and a job on its thread may both get here first
+    if (numTasks > 1) {
+        std::call_once(codecPoolCreated, [this] {
+            codecPool = std::make_unique<juce::ThreadPool>(juce::jmax(1, juce::SystemStats::getNumCpus() - 1));
+        });
+    }
+
+    // Every participant claims the next task until none are left
+    std::atomic<int> nextTask { 0 };
+    auto drain = [&] {
+        for (int j = nextTask++; j < numTasks; j = nextTask++) task(j);
+    };
+
+    const int numHelpers = numTasks > 1 ? juce::jmin(codecPool->getNumThreads(), numTasks - 1) : 0;
+    std::atomic<int> helpersLeft { numHelpers };
+    juce::WaitableEvent helpersDone;
+    for (int h = 0; h < numHelpers; ++h) {
+        codecPool->addJob([&] {
+            drain();
+            if (--helpersLeft == 0) helpersDone.signal();
+        });
+    }
+
+    drain();
+    if (numHelpers > 0) helpersDone.wait();
+}
+
+/**
+ * Queues work on the job thread. It returns whether it succeeded and hands its
+ * results over under resultLock; handleJobResults() picks them up.
+ */
+bool LoopFileHandler::startJob(LoopManager& loopManager, SyncEngine* syncEngine, std::function<bool()> work) {
+    if (jobActive) {
+        DBG("File job already running");
+        return false;
+    }
+    if (jobPool == nullptr) jobPool = std::make_unique<juce::ThreadPool>(1);
+
+    jobActive = true;
+    jobLoopManager = &loopManager;
+    jobSyncEngine = syncEngine;
+    job.progress = 0.0f;
+    job.cancelled = false;
+    {
+        const juce::ScopedLock lock(resultLock);
+        jobFinished = false;
+        jobSucceeded = false;
+    }
+
+    jobPool->addJob([this, work = std::move(work)] {
+        const bool succeeded = work();
+        const juce::ScopedLock lock(resultLock);
+        jobFinished = true;
+        jobSucceeded = succeeded;
+    });
+    return true;
+}
+
+void LoopFileHandler::handleJobResults() {
+    juce::StringArray messages;
+    {
+        const juce::ScopedLock lock(resultLock);
+        std::swap(messages, pendingUserMessages);
+    }
+    for (const auto& message : messages) {
+        if (onUserMessage) onUserMessage(message);
+    }
+
+    if (!jobActive) return;
+
+    juce::var settings;
+    std::vector<LoadedTrack> tracks;
+    bool finished = false;
+    bool succeeded = false;
+    {
+        const juce::ScopedLock lock(resultLock);
+        std::swap(settings, pendingSettings);
+        std::swap(tracks, loadedTracks);
+        finished = jobFinished;
+        succeeded = jobSucceeded;
+        // whatever the job reported before finishing goes out with its results
+        messages.clear();
+        std::swap(messages, pendingUserMessages);
+    }
+    for (const auto& message : messages) {
+        if (onUserMessage) onUserMessage(message);
+    }
+
+    const bool cancelled = job.shouldStop();
+    if (!cancelled && !settings.isVoid()) {
+        applyProjectSettings(settings, *jobLoopManager, *jobSyncEngine);
+    }
+
+    // Each player swaps in whole at the next audio block
+    for (auto& loaded : tracks) {
+        if (cancelled) break;
+        if (!jobLoopManager->loadTrackPlayer(loaded.trackIndex, std::move(loaded.player))) {
+            DBG("Failed to queue audio for Track " + juce::String(static_cast<int>(loaded.trackIndex)));
+            continue;
+        }
+        if (loaded.audio.getNumSamples() > 0 && onAudioFileLoaded) {
+            onAudioFileLoaded(loaded.trackIndex, loaded.audio, loaded.sampleRate);
+        }
+    }
+
+    if (!finished) return;
+
+    if (jobHoldsPlayers) jobLoopManager->releaseRetiredPlayers();
+    jobHoldsPlayers = false;
+    jobActive = false;
+    if (onJobFinished) onJobFinished(succeeded && !cancelled);
+}
+
+void LoopFileHandler::reportToUser(const juce::String& message) {
+    DBG(message);
+    const juce::ScopedLock lock(resultLock);
+    pendingUserMessages.add(message);
+}
+
+bool LoopFileHandler::padTo(juce::OutputStream& stream, uint64_t offset) {
+    const auto position = static_cast<uint64_t>(stream.getPosition());
+    return position <= offset && stream.writeRepeatedByte(0, static_cast<size_t>(offset - position));
+}
+
+bool LoopFileHandler::writeAudioChunks(juce::OutputStream& stream, AlsFormat::Codec codec,
+                                       std::vector<AlsFormat::ChunkEntry>& chunks,
+                                       const std::vector<const float*>& chunkSamples, JobControl* control) {
+    uint64_t totalSamples = 0, samplesWritten = 0;
+    for (const auto& chunk : chunks) totalSamples += chunk.numSamples;
+    auto reportProgress = [&](uint64_t numSamples) {
+        samplesWritten += numSamples;
+        if (control && totalSamples > 0)
+            control->progress = static_cast<float>(static_cast<double>(samplesWritten) / static_cast<double>(totalSamples));
+    };
+
+    // Raw chunks go out in one write each, straight from the players' buffers
+    if (codec == AlsFormat::Codec::None) {
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            if (control && control->shouldStop()) return false;
+            auto& chunk = chunks[c];
+            chunk.offset = AlsFormat::alignUp(static_cast<uint64_t>(stream.getPosition()), AlsFormat::CHUNK_ALIGNMENT);
+            chunk.length = chunk.numSamples * sizeof(float);
+            if (!padTo(stream, chunk.offset) || !stream.write(chunkSamples[c], static_cast<size_t>(chunk.length)))
+                return false;
+            reportProgress(chunk.numSamples);
+        }
+        return true;
+    }
+
+    // Coded chunks are cut into segments of whole codec blocks, whose codes concatenate.
+    // A window of segments is encoded in parallel and written in order, then the next,
+    // so memory stays at one window however large the project is.
+    static_assert(TrackConfig::PROJECT_SAVE_SEGMENT_SAMPLES % AlsCodec::kBlockSize == 0,
+                  "Segments must hold whole codec blocks");
+    struct Segment { size_t chunk; uint64_t start; int numSamples; };
+    std::vector<Segment> segments;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        uint64_t start = 0;
+        do {    // an empty chunk still gets one (empty) segment, and so an offset
+            const auto length = juce::jmin<uint64_t>(TrackConfig::PROJECT_SAVE_SEGMENT_SAMPLES, chunks[c].numSamples - start);
+            segments.push_back({ c, start, static_cast<int>(length) });
+            start += length;
+        } while (start < chunks[c].numSamples);
+        chunks[c].length = 0;
+    }
+
+    const int windowSize = juce::SystemStats::getNumCpus();
+    std::vector<std::vector<uint8_t>> coded(static_cast<size_t>(windowSize));
+    for (size_t first = 0; first < segments.size(); first += coded.size()) {
+        if (control && control->shouldStop()) return false;
+        const auto count = juce::jmin(coded.size(), segments.size() - first);
+        runInParallel(static_cast<int>(count), [&](int w) {
+            const auto& segment = segments[first + static_cast<size_t>(w)];
+            auto& out = coded[static_cast<size_t>(w)];
+            out.clear();
+            AlsCodec::encode(chunkSamples[segment.chunk] + segment.start, segment.numSamples, out);
+        });
+
+        for (size_t w = 0; w < count; ++w) {
+            auto& chunk = chunks[segments[first + w].chunk];
+            if (segments[first + w].start == 0) {
+                chunk.offset = AlsFormat::alignUp(static_cast<uint64_t>(stream.getPosition()), AlsFormat::CHUNK_ALIGNMENT);
+                if (!padTo(stream, chunk.offset)) return false;
+            }
+            if (!stream.write(coded[w].data(), coded[w].size())) return false;
+            chunk.length += coded[w].size();
+            reportProgress(static_cast<uint64_t>(segments[first + w].numSamples));
+        }
+    }
+    return true;
+}
+
 bool LoopFileHandler::writeTrackToStream(juce::OutputStream &stream, const LoopTrack &track) {
     // Write track settings
     stream.writeFloat(track.getCurrentVolumeDb());
@@ -126,20 +426,36 @@ bool LoopFileHandler::readTrackFromStream(juce::InputStream &stream, LoopTrack &
 
 bool LoopFileHandler::saveProject(const juce::File &destination, const LoopManager &loopManager,
                                   const SyncEngine &syncEngine) {
-    juce::FileOutputStream stream(destination);
-    if (!stream.openedOk()) {
-        DBG("Save Project: Failed to open file for writing");
+    auto snapshot = snapshotProject(loopManager, syncEngine);
+    return writeProject(destination, snapshot, nullptr);
+}
+
+bool LoopFileHandler::saveProjectAsync(const juce::File& destination, LoopManager& loopManager,
+                                       const SyncEngine& syncEngine) {
+    // The snapshot points into the players; they stay alive until the job's results are handled
+    auto snapshot = std::make_shared<ProjectSnapshot>(snapshotProject(loopManager, syncEngine));
+    if (!startJob(loopManager, nullptr, [this, destination, snapshot] {
+            return writeProject(destination, *snapshot, &job);
+        })) {
         return false;
     }
+    loopManager.holdRetiredPlayers();
+    jobHoldsPlayers = true;
+    return true;
+}
 
-    AlsFormat::Header header;
+LoopFileHandler::ProjectSnapshot LoopFileHandler::snapshotProject(const LoopManager &loopManager,
+                                                                  const SyncEngine &syncEngine) const {
+    ProjectSnapshot snapshot;
+    AlsFormat::Header& header = snapshot.header;
     AlsFormat::initHeader(header);
+    header.codec = static_cast<uint32_t>(projectCodec);
 
     double projectSampleRate = syncEngine.getSampleRate();
     if (projectSampleRate <= 0) projectSampleRate = static_cast<double>(TrackConfig::DEFAULT_SAMPLE_RATE);
     header.sampleRate = static_cast<uint32_t>(projectSampleRate);
     header.numChannels = TrackConfig::STEREO_MODE ? 2 : 1;
-    header.numTracks = static_cast<uint16_t>(TrackConfig::MAX_TRACKS);
+    header.numTracks = static_cast<uint16_t>(loopManager.getNumTracks());
 
     // Build JSON metadata
     juce::DynamicObject::Ptr root = new juce::DynamicObject();
@@ -149,7 +465,7 @@ bool LoopFileHandler::saveProject(const juce::File &destination, const LoopManag
     root->setProperty("numTracks", static_cast<int>(header.numTracks));
 
     juce::Array<juce::var> tracksArray;
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i) {
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i) {
         const LoopTrack* track = loopManager.getTrack(i);
         if (!track) continue;
 
@@ -170,123 +486,408 @@ bool LoopFileHandler::saveProject(const juce::File &destination, const LoopManag
     root->setProperty("tracks", tracksArray);
 
     juce::var jsonVar(root.get());
-    juce::String jsonStr = juce::JSON::toString(jsonVar);
-    size_t jsonBytes = jsonStr.getNumBytesAsUTF8();
-    juce::MemoryBlock jsonBlock(jsonStr.toRawUTF8(), jsonBytes);
-    header.jsonLength = jsonBlock.getSize();
+    snapshot.json = juce::JSON::toString(jsonVar);
+    header.jsonLength = snapshot.json.getNumBytesAsUTF8();
 
-    // Write binary audio to memory first so we know the length
-    juce::MemoryBlock audioBlock;
-    juce::MemoryOutputStream audioStream(audioBlock, true);
-
-    int tracksWithAudio = 0;
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i) {
+    // One chunk per channel of every track with audio, streamed straight from the players
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i) {
         const LoopTrack* track = loopManager.getTrack(i);
-        if (!track || !track->hasAudio()) continue;
+        if (!track) continue;
 
+        // The generation only vouches for the buffer if it didn't change while the buffer was taken
+        const uint32_t generation = track->getAudioGeneration();
         const auto& buf = track->getAudioBuffer();
-        int numSamples = buf.getNumSamples();
-        int numChannels = buf.getNumChannels();
-
-        audioStream.writeInt(numSamples);
-        audioStream.writeInt(numChannels);
-        for (int ch = 0; ch < numChannels; ++ch) {
-            audioStream.write(buf.getReadPointer(ch),
-                              static_cast<size_t>(numSamples) * sizeof(float));
+        if (buf.getNumSamples() == 0) continue;
+        const uint64_t chunkGeneration = track->getAudioGeneration() == generation
+                                             ? generation : ProjectSnapshot::unknownGeneration;
+        for (int ch = 0; ch < buf.getNumChannels(); ++ch) {
+            AlsFormat::ChunkEntry chunk {};
+            chunk.trackIndex = static_cast<uint16_t>(i);
+            chunk.channel = static_cast<uint16_t>(ch);
+            chunk.numSamples = static_cast<uint64_t>(buf.getNumSamples());
+            snapshot.chunks.push_back(chunk);
+            snapshot.chunkSamples.push_back(buf.getReadPointer(ch));
+            snapshot.chunkGenerations.push_back(chunkGeneration);
         }
-        ++tracksWithAudio;
+        ++snapshot.tracksWithAudio;
     }
-    header.audioLength = audioBlock.getSize();
 
-    // Write header
-    if (!stream.write(static_cast<const void*>(&header), AlsFormat::HEADER_SIZE)) {
-        DBG("Save Project: Failed to write header");
+    header.numChunks = static_cast<uint32_t>(snapshot.chunks.size());
+    header.chunkTableOffset = AlsFormat::chunkTableOffset(header.jsonLength);
+    return snapshot;
+}
+
+bool LoopFileHandler::writeProject(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control) {
+    SaveRecord previous;
+    {
+        const juce::ScopedLock lock(resultLock);
+        previous = lastSave;
+    }
+    // Generations only mean something if the file is still the one the last save wrote
+    const bool fileUnchanged = previous.file == destination && destination.existsAsFile()
+                               && destination.getLastModificationTime() == previous.modified
+                               && destination.getSize() == previous.size;
+    hashChunks(snapshot, fileUnchanged ? &previous : nullptr);
+
+    bool saved = writeChangedChunks(destination, snapshot, control);
+    if (!saved && !(control && control->shouldStop())) {
+        saved = writeWholeProject(destination, snapshot, control);
+    }
+    if (!saved) return false;
+
+    const juce::ScopedLock lock(resultLock);
+    lastSave = { destination, destination.getLastModificationTime(), destination.getSize(),
+                 snapshot.chunks, snapshot.chunkGenerations };
+    return true;
+}
+
+/**
+ * Fills in every chunk's content hash. A chunk whose track hasn't changed since
+ * the last save (same audio generation) keeps the hash that save wrote; the
+ * rest are hashed, in parallel.
+ */
+void LoopFileHandler::hashChunks(ProjectSnapshot& snapshot, const SaveRecord* previous) {
+    std::vector<size_t> toHash;
+    for (size_t c = 0; c < snapshot.chunks.size(); ++c) {
+        auto& chunk = snapshot.chunks[c];
+        bool known = false;
+        for (size_t p = 0; previous != nullptr && p < previous->chunks.size() && !known; ++p) {
+            const auto& old = previous->chunks[p];
+            if (old.trackIndex == chunk.trackIndex && old.channel == chunk.channel && old.numSamples == chunk.numSamples
+                && previous->chunkGenerations[p] == snapshot.chunkGenerations[c]
+                && snapshot.chunkGenerations[c] != ProjectSnapshot::unknownGeneration) {
+                chunk.contentHash = old.contentHash;
+                known = true;
+            }
+        }
+        if (!known) toHash.push_back(c);
+    }
+
+    runInParallel(static_cast<int>(toHash.size()), [&](int t) {
+        auto& chunk = snapshot.chunks[toHash[static_cast<size_t>(t)]];
+        chunk.contentHash = ContentHash::hash(snapshot.chunkSamples[toHash[static_cast<size_t>(t)]],
+                                              static_cast<size_t>(chunk.numSamples) * sizeof(float));
+    });
+}
+
+/**
+ * Saves over an existing project of the same format and codec: chunks whose
+ * hash matches stay where they are, and changed ones are appended, followed by
+ * a new JSON and table. Nothing the old header points at is overwritten; the
+ * header is written last, once the rest is on disk, and is what switches the
+ * project over. False, with the project as it was, when that isn't possible
+ * or worthwhile (see ALSFORMAT.md).
+ */
+bool LoopFileHandler::writeChangedChunks(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control) {
+    if (!destination.existsAsFile()) return false;
+
+    std::vector<AlsFormat::ChunkEntry> existing;
+    {
+        AlsProjectReader reader(destination);   // closed (unmapped) before the file is written
+        if (!reader.isValid() || reader.getHeader().version != AlsFormat::VERSION
+            || reader.getHeader().codec != snapshot.header.codec) {
+            return false;
+        }
+        existing = reader.getChunks();
+    }
+
+    auto& header = snapshot.header;
+    auto& chunks = snapshot.chunks;
+    const auto oldEnd = static_cast<uint64_t>(destination.getSize());
+
+    // Keep every chunk the file already has with the same content
+    std::vector<AlsFormat::ChunkEntry> dirtyChunks;
+    std::vector<const float*> dirtySamples;
+    std::vector<size_t> dirtyIndices;
+    uint64_t keptBytes = 0, dirtyBytes = 0;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        auto& chunk = chunks[c];
+        const auto match = std::find_if(existing.begin(), existing.end(), [&chunk](const AlsFormat::ChunkEntry& old) {
+            return old.trackIndex == chunk.trackIndex && old.channel == chunk.channel
+                   && old.numSamples == chunk.numSamples && old.contentHash == chunk.contentHash && old.contentHash != 0;
+        });
+        if (match != existing.end()) {
+            chunk.offset = match->offset;
+            chunk.length = match->length;
+            keptBytes += AlsFormat::alignUp(chunk.length, AlsFormat::CHUNK_ALIGNMENT);
+        } else {
+            dirtyChunks.push_back(chunk);
+            dirtySamples.push_back(snapshot.chunkSamples[c]);
+            dirtyIndices.push_back(c);
+            dirtyBytes += AlsFormat::alignUp(chunk.numSamples * sizeof(float), AlsFormat::CHUNK_ALIGNMENT);
+        }
+    }
+
+    // Everything before the append but the header and the kept chunks is dead once the new
+    // metadata is current; the file mustn't be mostly that
+    const uint64_t appendStart = dirtyChunks.empty() ? oldEnd : AlsFormat::alignUp(oldEnd, AlsFormat::CHUNK_ALIGNMENT);
+    const uint64_t deadBytes = appendStart - juce::jmin(appendStart, AlsFormat::HEADER_SIZE + keptBytes);
+    if (static_cast<double>(deadBytes) > TrackConfig::PROJECT_MAX_DEAD_RATIO * static_cast<double>(keptBytes + dirtyBytes)) {
+        return false;
+    }
+
+    juce::FileOutputStream stream(destination);
+    if (!stream.openedOk()) return false;
+
+    // Changed audio after everything the old table still points at ...
+    if (!dirtyChunks.empty()
+        && (!stream.setPosition(static_cast<juce::int64>(oldEnd)) || !padTo(stream, appendStart)
+            || !writeAudioChunks(stream, static_cast<AlsFormat::Codec>(header.codec), dirtyChunks, dirtySamples, control)
+            || (control && control->shouldStop()))) {
+        DBG("Save Project: Failed to append audio data");
+        stream.setPosition(static_cast<juce::int64>(oldEnd));
+        stream.truncate();
         return false;
     }
-    // Write JSON
-    if (!stream.write(jsonBlock.getData(), static_cast<size_t>(header.jsonLength))) {
-        DBG("Save Project: Failed to write JSON");
+    for (size_t d = 0; d < dirtyIndices.size(); ++d) {
+        chunks[dirtyIndices[d]] = dirtyChunks[d];
+    }
+
+    // ... then the new JSON and table after it, and last the header that switches over to them
+    header.jsonOffset = static_cast<uint64_t>(stream.getPosition());
+    header.chunkTableOffset = AlsFormat::chunkTableOffset(header.jsonLength, header.jsonOffset);
+    if (!writeMetadata(stream, snapshot)) {
+        DBG("Save Project: Failed to write metadata");
+        stream.setPosition(static_cast<juce::int64>(oldEnd));
+        stream.truncate();
         return false;
     }
-    // Write binary audio
-    if (header.audioLength > 0 && !stream.write(audioBlock.getData(), static_cast<size_t>(header.audioLength))) {
-        DBG("Save Project: Failed to write audio data");
+    if (!writeHeader(stream, header)) {
+        DBG("Save Project: Failed to write header");
         return false;
     }
 
-    DBG("Save Project: Saved " + juce::String(tracksWithAudio) + " tracks to " + destination.getFileName());
+    DBG("Save Project: Rewrote " + juce::String(static_cast<int>(dirtyChunks.size())) + " of "
+        + juce::String(static_cast<int>(chunks.size())) + " chunks in " + destination.getFileName());
     return true;
 }
 
-bool LoopFileHandler::loadProject(const juce::File &source, LoopManager &loopManager, SyncEngine &syncEngine) {
-    if (!source.existsAsFile()) {
-        DBG("Load Project: File does not exist");
-        return false;
+/**
+ * Writes the project to a temporary file that replaces destination once it is
+ * complete.
+ */
+bool LoopFileHandler::writeWholeProject(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control) {
+    juce::TemporaryFile temporary(destination);
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+        if (!stream.openedOk()) {
+            DBG("Save Project: Failed to open file for writing");
+            return false;
+        }
+
+        auto& header = snapshot.header;
+        auto& chunks = snapshot.chunks;
+        header.jsonOffset = AlsFormat::HEADER_SIZE;     // an incremental attempt may have moved it
+        header.chunkTableOffset = AlsFormat::chunkTableOffset(header.jsonLength);
+
+        // Header and JSON first, with a zeroed table; coded chunk sizes aren't known until
+        // they're written, so the table and the header are patched afterwards
+        if (!stream.write(static_cast<const void*>(&header), AlsFormat::HEADER_SIZE)) {
+            DBG("Save Project: Failed to write header");
+            return false;
+        }
+        if (!stream.write(snapshot.json.toRawUTF8(), static_cast<size_t>(header.jsonLength))) {
+            DBG("Save Project: Failed to write JSON");
+            return false;
+        }
+        if (!padTo(stream, header.chunkTableOffset + chunks.size() * sizeof(AlsFormat::ChunkEntry))) {
+            DBG("Save Project: Failed to write chunk table");
+            return false;
+        }
+
+        if (!writeAudioChunks(stream, static_cast<AlsFormat::Codec>(header.codec), chunks, snapshot.chunkSamples, control)) {
+            DBG("Save Project: Failed to write audio data");
+            return false;
+        }
+        if (!writeMetadata(stream, snapshot) || !writeHeader(stream, header)) {
+            DBG("Save Project: Failed to write chunk table");
+            return false;
+        }
     }
 
-    juce::FileInputStream stream(source);
-    if (!stream.openedOk()) {
-        DBG("Load Project: Failed to open file");
+    if ((control && control->shouldStop()) || !temporary.overwriteTargetFileWithTemporary()) {
         return false;
     }
 
-    AlsFormat::Header header;
-    if (stream.read(&header, AlsFormat::HEADER_SIZE) != static_cast<int64_t>(AlsFormat::HEADER_SIZE)) {
-        DBG("Load Project: Failed to read header");
+    DBG("Save Project: Saved " + juce::String(snapshot.tracksWithAudio) + " tracks to " + destination.getFileName());
+    return true;
+}
+
+/**
+ * JSON and chunk table at the offsets in the header, flushed to disk. Nothing
+ * reads them until writeHeader() points the file at them.
+ */
+bool LoopFileHandler::writeMetadata(juce::FileOutputStream& stream, ProjectSnapshot& snapshot) {
+    auto& header = snapshot.header;
+    const auto& chunks = snapshot.chunks;
+
+    uint64_t audioStart = std::numeric_limits<uint64_t>::max(), audioEnd = 0;
+    for (const auto& chunk : chunks) {
+        audioStart = juce::jmin(audioStart, chunk.offset);
+        audioEnd = juce::jmax(audioEnd, chunk.offset + chunk.length);
+    }
+    header.audioLength = chunks.empty() ? 0 : audioEnd - audioStart;
+
+    if (!stream.setPosition(static_cast<juce::int64>(header.jsonOffset))
+        || !stream.write(snapshot.json.toRawUTF8(), static_cast<size_t>(header.jsonLength))
+        || !padTo(stream, header.chunkTableOffset)
+        || !(chunks.empty() || stream.write(chunks.data(), chunks.size() * sizeof(AlsFormat::ChunkEntry)))) {
         return false;
     }
+    stream.flush();     // FileOutputStream syncs to disk: the new metadata is there before the header names it
+    return stream.getStatus().wasOk();
+}
 
-    if (header.magic != AlsFormat::MAGIC) {
-        DBG("Load Project: Invalid magic (not an .als file)");
+/**
+ * The commit point of a save: one 512-byte write at the start of the file,
+ * synced like the metadata before it.
+ */
+bool LoopFileHandler::writeHeader(juce::FileOutputStream& stream, const AlsFormat::Header& header) {
+    if (!stream.setPosition(0) || !stream.write(static_cast<const void*>(&header), AlsFormat::HEADER_SIZE)) {
         return false;
     }
-    if (header.version > AlsFormat::VERSION) {
-        DBG("Load Project: Unsupported format version " + juce::String(header.version));
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+bool LoopFileHandler::loadProject(const juce::File &source, LoopManager &loopManager, SyncEngine &syncEngine) {
+    if (!source.existsAsFile()) {
+        DBG("Load Project: File does not exist");
         return false;
     }
 
-    // Read JSON
-    juce::MemoryBlock jsonBlock(header.jsonLength);
-    if (stream.read(jsonBlock.getData(), static_cast<size_t>(header.jsonLength)) != static_cast<int64_t>(header.jsonLength)) {
-        DBG("Load Project: Failed to read JSON");
+    // Header, metadata and chunk table; the audio stays in the mapped file until a track needs it
+    AlsProjectReader reader(source);
+    if (!reader.isValid()) {
+        DBG("Load Project: Not a readable .als project");
         return false;
     }
+    if (!checkProjectFits(reader, source, loopManager.getNumTracks())) return false;
+    applyProjectSettings(reader.getMetadata(), loopManager, syncEngine);
+
+    // Every track's buffer sized (or mapped in place) first ...
+    struct PendingTrack {
+        TrackLoad load;
+        juce::AudioBuffer<float> buffer;
+    };
+    std::vector<PendingTrack> pending;
+    std::vector<std::pair<size_t, int>> channelReads;   // pending track, channel
+
+    for (const auto& load : findTrackLoads(reader, loopManager.getNumTracks())) {
+        // Any track's chunks, at random; for a raw, mapped v2 file this is a view onto
+        // the mapping, copied once into the track's player by loadTrackAudio()
+        PendingTrack pendingTrack { load, {} };
+        bool needsRead = false;
+        if (!reader.prepareTrackAudio(load.index, pendingTrack.buffer, needsRead)) {
+            DBG("Load Project: Invalid audio for track " + juce::String(load.index));
+            continue;
+        }
+        for (int ch = 0; needsRead && ch < pendingTrack.buffer.getNumChannels(); ++ch) {
+            channelReads.emplace_back(pending.size(), ch);
+        }
+        pending.push_back(std::move(pendingTrack));
+    }
 
-    juce::var jsonVar = juce::JSON::parse(juce::String::fromUTF8(
-        static_cast<const char*>(jsonBlock.getData()),
-        static_cast<size_t>(header.jsonLength)));
-    if (!jsonVar.isObject()) {
-        DBG("Load Project: Invalid JSON metadata");
+    // ... then the channels that must be read or decoded, all in parallel
+    std::vector<char> readOk(channelReads.size(), 0);
+    runInParallel(static_cast<int>(channelReads.size()), [&](int r) {
+        const auto [p, ch] = channelReads[static_cast<size_t>(r)];
+        readOk[static_cast<size_t>(r)] = reader.readTrackChannel(pending[p].load.index, ch, pending[p].buffer.getWritePointer(ch)) ? 1 : 0;
+    });
+    std::vector<char> trackFailed(pending.size(), 0);
+    for (size_t r = 0; r < channelReads.size(); ++r) {
+        if (!readOk[r]) trackFailed[channelReads[r].first] = 1;
+    }
+
+    int numTracksWithAudio = 0;
+    for (size_t p = 0; p < pending.size(); ++p) {
+        if (trackFailed[p]) {
+            DBG("Load Project: Invalid audio for track " + juce::String(pending[p].load.index));
+            continue;
+        }
+        if (loopManager.loadTrackAudio(static_cast<size_t>(pending[p].load.index), pending[p].buffer, pending[p].load.sampleRate)) {
+            ++numTracksWithAudio;
+        }
+    }
+
+    DBG("Load Project: Loaded " + juce::String(numTracksWithAudio) + " tracks from " + source.getFileName());
+    return true;
+}
+
+/**
+ * Reads the project on the job thread one track at a time, each track's channels
+ * in parallel, and builds its player there; the message thread only posts it.
+ */
+bool LoopFileHandler::loadProjectAsync(const juce::File& source, LoopManager& loopManager, SyncEngine& syncEngine) {
+    if (!source.existsAsFile()) {
+        DBG("Load Project: File does not exist");
         return false;
     }
 
+    return startJob(loopManager, &syncEngine, [this, source, &loopManager] {
+        AlsProjectReader reader(source);
+        if (!reader.isValid()) {
+            DBG("Load Project: Not a readable .als project");
+            return false;
+        }
+        if (!checkProjectFits(reader, source, loopManager.getNumTracks())) return false;
+
+        const auto loads = findTrackLoads(reader, loopManager.getNumTracks());
+        {
+            const juce::ScopedLock lock(resultLock);
+            pendingSettings = reader.getMetadata();
+        }
+
+        for (size_t i = 0; i < loads.size(); ++i) {
+            if (job.shouldStop()) return false;
+
+            juce::AudioBuffer<float> buffer;
+            if (readProjectTrack(reader, loads[i].index, buffer)) {
+                LoadedTrack loaded;
+                loaded.trackIndex = static_cast<size_t>(loads[i].index);
+                loaded.player = loopManager.getTrack(loaded.trackIndex)->createPlayer(buffer, loads[i].sampleRate);
+                loaded.sampleRate = loads[i].sampleRate;
+
+                const juce::ScopedLock lock(resultLock);
+                loadedTracks.push_back(std::move(loaded));
+            } else {
+                DBG("Load Project: Invalid audio for track " + juce::String(loads[i].index));
+            }
+            job.progress = static_cast<float>(i + 1) / static_cast<float>(loads.size());
+        }
+        return true;
+    });
+}
+
+/**
+ * Tempo, then every track's settings; all audio is dropped (queued ahead of the
+ * new audio). Settings are plain atomics, reset here and overwritten from the file.
+ */
+void LoopFileHandler::applyProjectSettings(const juce::var& metadata, LoopManager& loopManager, SyncEngine& syncEngine) {
     // Apply global settings
-    juce::var bpmVar = jsonVar.getProperty("bpm", TrackConfig::DEFAULT_BPM);
+    juce::var bpmVar = metadata.getProperty("bpm", TrackConfig::DEFAULT_BPM);
     if (bpmVar.isDouble() || bpmVar.isInt())
-        syncEngine.setTempo(static_cast<float>(static_cast<double>(bpmVar)));
+        syncEngine.setConstantTempo(static_cast<float>(static_cast<double>(bpmVar)));
 
-    // Stop and clear all tracks before loading
     loopManager.stopAllPlayback();
-    loopManager.clearAllTracks();
-
-    double projectSampleRate = header.sampleRate > 0
-        ? static_cast<double>(header.sampleRate)
-        : static_cast<double>(TrackConfig::DEFAULT_SAMPLE_RATE);
+    loopManager.scheduleLaunch(LaunchQueue::Action::Unload, LaunchQueue::kAllTracks);
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i) {
+        if (auto* track = loopManager.getTrack(i)) track->resetSettings();
+    }
 
-    // Apply per-track metadata and load audio
-    juce::var tracksVar = jsonVar.getProperty("tracks", juce::var());
-    if (!tracksVar.isArray()) {
+    // Apply per-track metadata
+    const juce::Array<juce::var>* tracksArray = metadata.getProperty("tracks", juce::var()).getArray();
+    if (tracksArray == nullptr) {
         DBG("Load Project: No tracks array in JSON");
-        return true; // Empty project is valid
+        return; // Empty project is valid
     }
 
-    juce::Array<juce::var>* tracksArray = tracksVar.getArray();
-    int numTracksWithAudio = 0;
     for (const auto& tVar : *tracksArray) {
         if (!tVar.isObject()) continue;
 
         int index = static_cast<int>(tVar.getProperty("index", 0));
-        if (index < 0 || index >= TrackConfig::MAX_TRACKS) continue;
+        // checkProjectFits() has ruled out tracks past the end; this only guards against bad indices
+        if (index < 0 || index >= static_cast<int>(loopManager.getNumTracks())) continue;
 
         LoopTrack* track = loopManager.getTrack(static_cast<size_t>(index));
         if (!track) continue;
@@ -298,37 +899,68 @@ bool LoopFileHandler::loadProject(const juce::File &source, LoopManager &loopMan
         track->setSolo(static_cast<bool>(tVar.getProperty("solo", false)));
         track->setReverse(static_cast<bool>(tVar.getProperty("reverse", false)));
         track->setSlip(static_cast<int>(tVar.getProperty("slipOffset", 0)));
+    }
+}
 
-        bool hasAudio = static_cast<bool>(tVar.getProperty("hasAudio", false));
-        if (!hasAudio) continue;
-
-        // Read next audio block from binary section
-        int numSamples = stream.readInt();
-        int numChannels = stream.readInt();
-        if (numSamples <= 0 || numChannels <= 0 || numChannels > 2) {
-            DBG("Load Project: Invalid audio block for track " + juce::String(index));
-            continue;
+int LoopFileHandler::getProjectNumTracks(const AlsProjectReader& reader) {
+    int numTracks = juce::jmax(static_cast<int>(reader.getHeader().numTracks),
+                               static_cast<int>(reader.getMetadata().getProperty("numTracks", 0)));
+    if (const auto* tracksArray = reader.getMetadata().getProperty("tracks", juce::var()).getArray()) {
+        for (const auto& tVar : *tracksArray) {
+            if (tVar.isObject()) numTracks = juce::jmax(numTracks, static_cast<int>(tVar.getProperty("index", 0)) + 1);
         }
+    }
+    for (const auto& chunk : reader.getChunks()) {
+        numTracks = juce::jmax(numTracks, static_cast<int>(chunk.trackIndex) + 1);
+    }
+    return numTracks;
+}
 
-        juce::AudioBuffer<float> buffer(numChannels, numSamples);
-        for (int ch = 0; ch < numChannels; ++ch) {
-            if (stream.read(buffer.getWritePointer(ch), static_cast<size_t>(numSamples) * sizeof(float))
-                != static_cast<int64_t>(numSamples) * static_cast<int64_t>(sizeof(float))) {
-                DBG("Load Project: Failed to read audio for track " + juce::String(index));
-                break;
-            }
-        }
+/**
+ * The processor gives the session the project's track count before loading;
+ * a project with more tracks than that (past TrackConfig::MAX_TRACKS) is
+ * refused whole rather than loaded without some of them.
+ */
+bool LoopFileHandler::checkProjectFits(const AlsProjectReader& reader, const juce::File& source, size_t numTracks) {
+    const int needed = getProjectNumTracks(reader);
+    if (needed <= static_cast<int>(numTracks)) return true;
+
+    reportToUser(source.getFileName() + " has " + juce::String(needed) + " tracks but this session has "
+                 + juce::String(static_cast<int>(numTracks)) + ", so it was not loaded.");
+    return false;
+}
+
+std::vector<LoopFileHandler::TrackLoad> LoopFileHandler::findTrackLoads(const AlsProjectReader& reader, size_t numTracks) {
+    std::vector<TrackLoad> loads;
+    const auto* tracksArray = reader.getMetadata().getProperty("tracks", juce::var()).getArray();
+    if (tracksArray == nullptr) return loads;
+
+    const double projectSampleRate = reader.getSampleRate();
+    for (const auto& tVar : *tracksArray) {
+        if (!tVar.isObject() || !static_cast<bool>(tVar.getProperty("hasAudio", false))) continue;
+
+        int index = static_cast<int>(tVar.getProperty("index", 0));
+        if (index < 0 || index >= static_cast<int>(numTracks)) continue;
 
         double trackSr = projectSampleRate;
         if (tVar.hasProperty("sourceSampleRate")) {
             trackSr = static_cast<double>(tVar.getProperty("sourceSampleRate", projectSampleRate));
         }
-        track->setAudioBuffer(buffer, trackSr);
-        ++numTracksWithAudio;
+        loads.push_back({ index, trackSr });
     }
+    return loads;
+}
 
-    DBG("Load Project: Loaded " + juce::String(numTracksWithAudio) + " tracks from " + source.getFileName());
-    return true;
+bool LoopFileHandler::readProjectTrack(AlsProjectReader& reader, int trackIndex, juce::AudioBuffer<float>& audio) {
+    bool needsRead = false;
+    if (!reader.prepareTrackAudio(trackIndex, audio, needsRead)) return false;
+    if (!needsRead) return true;
+
+    std::vector<char> readOk(static_cast<size_t>(audio.getNumChannels()), 0);
+    runInParallel(audio.getNumChannels(), [&](int ch) {
+        readOk[static_cast<size_t>(ch)] = reader.readTrackChannel(trackIndex, ch, audio.getWritePointer(ch)) ? 1 : 0;
+    });
+    return std::all_of(readOk.begin(), readOk.end(), [](char ok) { return ok != 0; });
 }
 
 juce::StringArray LoopFileHandler::getSupportedExtensions() {
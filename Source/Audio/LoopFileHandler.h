@@ -6,26 +6,55 @@
 #include "LoopTrack.h"
 #include "LoopManager.h"
 #include "AlsFormat.h"
+#include "AlsProjectReader.h"
+#include "AlsCodec.h"
+#include "../Utils/ContentHash.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include "juce_audio_formats/juce_audio_formats.h"
 #include "juce_audio_basics/juce_audio_basics.h"
 #include "juce_data_structures/juce_data_structures.h"
 #include "../Utils/TrackConfig.h"
 
 /**
- * Handles playback from file and storage
+ * Handles playback from file and storage.
+ *
+ * Every load and save has a synchronous form and an ...Async() one. An async
+ * job runs on the handler's background thread, one at a time, and can be
+ * cancelled. Its results reach the engine from handleJobResults(), which the
+ * processor's timer calls on the message thread: a loading project has its
+ * settings applied first, then each track is handed over as soon as it is
+ * decoded, so playback can start before the last one is in.
  */
 class LoopFileHandler {
 public:
     LoopFileHandler();
-    ~LoopFileHandler() = default;
+    ~LoopFileHandler();
 
     // === Load audio file from disk ===
-    bool loadAudioFile(const juce::File& file, LoopTrack& targetTrack);
+    // Reads the file here; the track picks the audio up at the next audio block
+    bool loadAudioFile(const juce::File& file, LoopManager& loopManager, size_t trackIndex);
+    bool loadAudioFileAsync(const juce::File& file, LoopManager& loopManager, size_t trackIndex);
+    // files[i] goes to track firstTrackIndex + i. The files are decoded concurrently and each
+    // track gets its audio as soon as its file is done; the job fails if any file did.
+    // Files past the last track are left out; those and any unreadable files go to onUserMessage.
+    bool loadAudioFilesAsync(const juce::Array<juce::File>& files, LoopManager& loopManager, size_t firstTrackIndex);
+    // Called (message thread) with the decoded audio after each successful load of an audio file
+    std::function<void(size_t trackIndex, const juce::AudioBuffer<float>& audio, double sampleRate)> onAudioFileLoaded;
+    // Opens the file to check it; loading doesn't need this first
     bool isSupportedAudioFile(const juce::File& file);
     static juce::StringArray getSupportedExtensions();
     static juce::String getSupportedExtString();
 
     // === Saving and loading projects ===
+    // Codec for the audio of projects saved from now on (raw float by default, which loads in place)
+    void setProjectCodec(AlsFormat::Codec codec) { projectCodec = codec; }
+    AlsFormat::Codec getProjectCodec() const { return projectCodec; }
+
+    // Saving streams the audio to the file as it goes, so it needs no copy of the project.
+    // Saving again to the same project only appends the tracks whose audio changed, then the
+    // new metadata; the header written last switches over, so a crash leaves the old project.
     bool saveProject(const juce::File& destination,
                      const LoopManager& loopManager,
                      const SyncEngine& syncEngine);
@@ -34,16 +63,122 @@ public:
                      LoopManager& loopManager,
                      SyncEngine& syncEngine);
 
+    // A cancelled or failed save leaves the old project as it was
+    bool saveProjectAsync(const juce::File& destination, LoopManager& loopManager, const SyncEngine& syncEngine);
+    bool loadProjectAsync(const juce::File& source, LoopManager& loopManager, SyncEngine& syncEngine);
+
+    // === Background jobs (message thread) ===
+    bool isJobRunning() const noexcept { return jobActive; }
+    float getJobProgress() const noexcept { return job.progress.load(std::memory_order_relaxed); }  // 0..1
+    // The job stops at its next chunk or track and nothing more is handed to the engine
+    void cancelJob() noexcept { job.cancelled.store(true, std::memory_order_relaxed); }
+    // Publishes what the job has finished since the last call; called from the processor's timer
+    void handleJobResults();
+    std::function<void(bool succeeded)> onJobFinished;
+    // Called (message thread, from handleJobResults()) with what the user should be told
+    // about a load or save that didn't do everything asked of it
+    std::function<void(const juce::String& message)> onUserMessage;
+
+    // Tracks a project needs: its header's count or the highest track it has settings or audio for
+    static int getProjectNumTracks(const AlsProjectReader& reader);
+
     static juce::File getDefaultAudioFolder();
     static juce::File getDefaultProjectFolder();
 
 private:
+    // Shared by the job thread and the calls that report on it
+    struct JobControl {
+        std::atomic<float> progress { 0.0f };
+        std::atomic<bool> cancelled { false };
+
+        bool shouldStop() const noexcept { return cancelled.load(std::memory_order_relaxed); }
+    };
+
+    // What a save needs from the engine, taken on the message thread
+    struct ProjectSnapshot {
+        AlsFormat::Header header {};
+        juce::String json;
+        std::vector<AlsFormat::ChunkEntry> chunks;
+        std::vector<const float*> chunkSamples;     // the players' buffers, one per chunk
+        std::vector<uint64_t> chunkGenerations;     // their tracks' audio generations, or unknownGeneration
+        int tracksWithAudio = 0;
+
+        static constexpr uint64_t unknownGeneration = ~uint64_t { 0 };  // audio changed while it was snapshotted
+    };
+
+    // What the last save wrote, so the next one to the same file can skip clean tracks
+    struct SaveRecord {
+        juce::File file;
+        juce::Time modified;
+        juce::int64 size = 0;
+        std::vector<AlsFormat::ChunkEntry> chunks;  // as in the file's table, hashes included
+        std::vector<uint64_t> chunkGenerations;
+    };
+
+    // A track with audio in a loaded project
+    struct TrackLoad {
+        int index;
+        double sampleRate;
+    };
+
+    // Decoded on the job thread, waiting for handleJobResults()
+    struct LoadedTrack {
+        size_t trackIndex = 0;
+        std::unique_ptr<gin::SamplePlayer> player;
+        juce::AudioBuffer<float> audio;             // imported files only, for onAudioFileLoaded
+        double sampleRate = 0.0;
+    };
+
     juce::AudioFormatManager formatManager;     // Save only SamplePlayer handles load and play
+    AlsFormat::Codec projectCodec = AlsFormat::Codec::None;
+    std::unique_ptr<juce::ThreadPool> codecPool; // Encodes/decodes chunks in parallel, created on first use
+    std::once_flag codecPoolCreated;
+
+    // === Background jobs ===
+    std::unique_ptr<juce::ThreadPool> jobPool;  // one thread, created on first use
+    JobControl job;
+    bool jobActive = false;                     // message thread, until the results are handled
+    LoopManager* jobLoopManager = nullptr;
+    SyncEngine* jobSyncEngine = nullptr;        // loads only
+    bool jobHoldsPlayers = false;               // saves read the players' buffers
+
+    juce::CriticalSection resultLock;           // job thread and message thread
+    juce::var pendingSettings;                  // a loaded project's metadata, applied before its tracks
+    juce::StringArray pendingUserMessages;      // for onUserMessage, from any thread
+    std::vector<LoadedTrack> loadedTracks;
+    bool jobFinished = false;
+    bool jobSucceeded = false;
+    SaveRecord lastSave;                        // also under resultLock: saves may run on the job thread
+
+    bool startJob(LoopManager& loopManager, SyncEngine* syncEngine, std::function<bool()> work);
+    void reportToUser(const juce::String& message);
+    bool checkProjectFits(const AlsProjectReader& reader, const juce::File& source, size_t numTracks);
+
+    // Runs task(0..numTasks-1) on the calling thread and the codec pool, returns when all are done
+    void runInParallel(int numTasks, const std::function<void(int)>& task);
+
+    ProjectSnapshot snapshotProject(const LoopManager& loopManager, const SyncEngine& syncEngine) const;
+    // Only the changed chunks and the metadata when it can, otherwise the whole project
+    bool writeProject(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control);
+    void hashChunks(ProjectSnapshot& snapshot, const SaveRecord* previous);
+    bool writeChangedChunks(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control);
+    bool writeWholeProject(const juce::File& destination, ProjectSnapshot& snapshot, JobControl* control);
+    static bool writeMetadata(juce::FileOutputStream& stream, ProjectSnapshot& snapshot);
+    static bool writeHeader(juce::FileOutputStream& stream, const AlsFormat::Header& header);
+    static bool padTo(juce::OutputStream& stream, uint64_t offset);    // Zero padding up to offset
+    // Writes the chunks' audio in order at aligned offsets, filling in their offsets and lengths
+    bool writeAudioChunks(juce::OutputStream& stream, AlsFormat::Codec codec, std::vector<AlsFormat::ChunkEntry>& chunks,
+                          const std::vector<const float*>& chunkSamples, JobControl* control);
+
+    static void applyProjectSettings(const juce::var& metadata, LoopManager& loopManager, SyncEngine& syncEngine);
+    static std::vector<TrackLoad> findTrackLoads(const AlsProjectReader& reader, size_t numTracks);
+    // One track's audio, its channels read or decoded in parallel
+    bool readProjectTrack(AlsProjectReader& reader, int trackIndex, juce::AudioBuffer<float>& audio);
+    bool readAudioFile(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate,
+                       JobControl* control, std::atomic<float>* progress);
 
     bool writeTrackToStream(juce::OutputStream& stream, const LoopTrack& track);
     bool readTrackFromStream(juce::InputStream& stream, LoopTrack& track);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopFileHandler)
 };
-
-
@@ -4,19 +4,48 @@
 
 #include "LoopManager.h"
 
-LoopManager::LoopManager(SyncEngine& se) : syncEngine(se) {
-     // Create all our tracks
-     for (size_t i = 0; i < TrackConfig::MAX_TRACKS; i++) {
-         tracks[i] = std::make_unique<LoopTrack>(static_cast<int>(i));
-     }
+#include <algorithm>
 
-     // Initialize track outputs
-     for (auto& buf : trackOutputs) {
-         buf = nullptr;
-     }
+LoopManager::LoopManager(SyncEngine& se, int numTracks) : syncEngine(se) {
+     setNumTracks(numTracks);
+}
+
+LoopManager::~LoopManager() {
+    // The audio thread is gone; commands it never ran still own their players
+    launchQueue.cancelAll();
+    launchQueue.collect([](const LaunchQueue::Event&) { return juce::int64(0); },
+                        [](const LaunchQueue::Event& event) { delete event.player; });
+    retiredPlayerHolds = 0;
+    heldPlayers.clear();
+    reclaimRetiredPlayers();
+    for (int i = 0; i < retireBacklogSize.load(); ++i) {
+        delete retireBacklog[static_cast<size_t>(i)];
+    }
+}
+
+void LoopManager::setNumTracks(int numTracks) {
+    const auto trackCount = static_cast<size_t>(TrackConfig::clampNumTracks(numTracks));
+
+    // A removed track takes its players with it; nothing may still be reading them
+    jassert(retiredPlayerHolds == 0);
+    tracks.resize(trackCount);
+    for (size_t i = 0; i < trackCount; i++) {
+        if (!tracks[i]) tracks[i] = std::make_unique<LoopTrack>(static_cast<int>(i));
+    }
+
+    // Track outputs are allocated in prepareToPlay
+    trackOutputs.resize(trackCount);
+    trackActive.assign(trackCount, 0);
+    trackRendered.assign(trackCount, 0);
+    outputList.assign(trackCount, nullptr);
+    tracksToRender.reserve(trackCount);
+    directOutputs.resize(trackCount);
+    hasDirectOutput.assign(trackCount, 0);
 }
 
 void LoopManager::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) {
+    reclaimRetiredPlayers();
+
     // Prepare each track
     for (auto& track : tracks) {
         if (track)
@@ -29,9 +58,23 @@ void LoopManager::prepareToPlay(double sampleRate, int samplesPerBlock, int numC
         buf->clear();
     }
 
+    // The channel layout may have changed; the caller re-registers direct outputs per block
+    std::fill(hasDirectOutput.begin(), hasDirectOutput.end(), 0);
+
+    // SyncEngine restarts from zero; anything still scheduled is resolved again there
+    expectedLaunchPosition = 0;
+
+    // Workers are (re)spawned here, never while the audio callback is running
+    if (requestedRenderWorkers > 0)
+        renderPool.start(requestedRenderWorkers, sampleRate, samplesPerBlock);
+    else
+        renderPool.stop();
 }
 
 void LoopManager::releaseResources() {
+    renderPool.stop();
+    reclaimRetiredPlayers();
+
     for (auto& track : tracks) {
         track->releaseResources();
     }
@@ -40,55 +83,205 @@ void LoopManager::releaseResources() {
     for (auto& buf : trackOutputs) {
         buf.reset();
     }
+    std::fill(trackActive.begin(), trackActive.end(), 0);
 }
 
 void LoopManager::processBlock(const juce::AudioBuffer<float> &input) {
     const int numSamples = input.getNumSamples();
 
+    auto resolveAt = [this](juce::int64 position) {
+        return [this, position](const LaunchQueue::Event& event) { return resolveLaunch(event, position); };
+    };
+
+    // 1. Pick up newly scheduled launches; if the clock jumped since the last
+    //    block (relocation, host loop wrap), due samples are worked out again
+    flushRetireBacklog();
+    const auto blockStart = syncEngine.getUpcomingSample();
+    if (blockStart != expectedLaunchPosition) {
+        launchQueue.reschedule(resolveAt(blockStart));
+    }
+    launchQueue.collect(resolveAt(blockStart), [this](const LaunchQueue::Event& event) {
+        retirePlayer(std::unique_ptr<gin::SamplePlayer>(event.player));
+    });
+
+    std::fill(trackActive.begin(), trackActive.end(), 0);
+    std::fill(trackRendered.begin(), trackRendered.end(), 0);
+
+    // 2. Render in segments that end where a launch is due, so every launch lands on
+    //    its exact sample. With nothing due inside the block this is a single segment.
+    int offset = 0;
+    do {
+        const auto position = syncEngine.getUpcomingSample();
+
+        // Without room to hand back what they swap out, due commands wait for the next
+        // block: the tracks keep their players until the message thread has reclaimed some
+        bool launchesWait = false;
+        LaunchQueue::Event event;
+        while (launchQueue.getNextDueSample() <= position) {
+            if (!hasRoomForLaunch()) {
+                launchesWait = true;
+                launchesHeldBack.store(true, std::memory_order_relaxed);
+                break;
+            }
+            launchQueue.popDue(position, event);
+            applyLaunch(event, position);
+        }
+
+        const auto untilNextLaunch = launchesWait ? juce::int64(numSamples - offset)
+                                                  : launchQueue.getNextDueSample() - position;
+        const int length = static_cast<int>(juce::jlimit<juce::int64>(juce::jmin(1, numSamples - offset),
+                                                                        numSamples - offset,
+                                                                        untilNextLaunch));
+        renderSegment(input, offset, length);
+        offset += length;
+    } while (offset < numSamples);
+
+    expectedLaunchPosition = syncEngine.getUpcomingSample();
+}
+
+void LoopManager::renderSegment(const juce::AudioBuffer<float>& input, int offset, int numSamples) {
     // 1. Handle sync (advance the global clock)
     syncEngine.advance(numSamples);
 
-    // 2. Clear all track output buffers (reuse, don't allocate)
-    for (auto& buf : trackOutputs) {
-        if (buf) {
-            buf->clear();
+    // 2. Process only tracks that have something to do; idle tracks cost nothing
+    //    here and publish no output, so MixerEngine skips them too
+    tracksToRender.clear();
+    for (size_t i = 0; i < tracks.size(); i++) {
+        if (!tracks[i] || !trackOutputs[i] || tracks[i]->isIdle()) {
+            // a direct output still has to be written, even when there is nothing to play;
+            // so does a track that played earlier in this block and stopped at a launch
+            if (hasDirectOutput[i] != 0 || trackRendered[i] != 0) {
+                getRenderTarget(i).clear(offset, numSamples);
+            }
+            continue;
+        }
+
+        // a track that starts at a launch inside the block has nothing before it
+        if (trackRendered[i] == 0 && offset > 0) {
+            getRenderTarget(i).clear(0, offset);
         }
+        tracksToRender.push_back(static_cast<int>(i));
     }
 
-    // 3. Process each track into its own output buffer
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; i++) {
-        auto& track = tracks[i];
-        auto& trackBuffer = trackOutputs[i];
+    // Most blocks are one segment, and render straight from the caller's input
+    const bool wholeBlock = offset == 0 && numSamples == input.getNumSamples();
+    juce::AudioBuffer<float> segmentInput;
+    if (!wholeBlock) {
+        // read-only view; tracks take their input by const reference
+        segmentInput.setDataToReferTo(const_cast<float* const*>(input.getArrayOfReadPointers()),
+                                      input.getNumChannels(), offset, numSamples);
+    }
+    const auto& trackInput = wholeBlock ? input : segmentInput;
+    renderOffset = offset;
+
+    // 3. Tracks only touch their own state, so they can render on any thread;
+    //    the mixer still sums them in track order, keeping output bit-identical
+    if (renderPool.getNumWorkers() > 0 && tracksToRender.size() > 1) {
+        renderInput = &trackInput;
+        renderPool.run(static_cast<int>(tracksToRender.size()), &LoopManager::renderTrackTask, this);
+        renderInput = nullptr;
+    } else {
+        for (int index : tracksToRender) {
+            renderTrack(static_cast<size_t>(index), trackInput);
+        }
+    }
 
-        if (!track || !trackBuffer) continue;
+    // A take that set its loop length this segment left its old player behind
+    for (int index : tracksToRender) {
+        retirePlayer(tracks[static_cast<size_t>(index)]->takeReplacedPlayer());
+    }
+}
+
+void LoopManager::renderTrack(size_t index, const juce::AudioBuffer<float>& input) {
+    auto& output = getRenderTarget(index);
+    const int numSamples = input.getNumSamples();
+
+    // Reuse the buffer, don't allocate. Track reads from input, writes to its render target
+    // (a view onto this segment when the block is split at a launch)
+    juce::AudioBuffer<float> segmentView;
+    if (renderOffset != 0 || numSamples != output.getNumSamples()) {
+        segmentView.setDataToReferTo(output.getArrayOfWritePointers(), output.getNumChannels(), renderOffset, numSamples);
+    }
+    auto& target = segmentView.getNumChannels() > 0 ? segmentView : output;
+
+    target.clear();
+    tracks[index]->processBlock(input, target, syncEngine);
+    trackRendered[index] = 1;
 
-        // Let the track process - reads from inputs, writes to trackBuffer
-        track->processBlock(input, *trackBuffer, syncEngine);
+    // A playing track can still render digital silence (e.g. a quiet loop section)
+    if (!isDigitallySilent(target, numSamples)) {
+        trackActive[index] = 1;
     }
 }
 
-std::vector<juce::AudioBuffer<float>*> LoopManager::getTrackOutputs() {
-    std::vector<juce::AudioBuffer<float>*> outputs;
-    outputs.reserve(TrackConfig::MAX_TRACKS);
+juce::AudioBuffer<float>& LoopManager::getRenderTarget(size_t index) noexcept {
+    if (hasDirectOutput[index] != 0) return directOutputs[index];
+    return *trackOutputs[index];
+}
 
-    for (auto& buf : trackOutputs) {
-        if (buf) {
-            outputs.push_back(buf.get());
-        } else {
-            outputs.push_back(nullptr);
+void LoopManager::setTrackDirectOutput(size_t index, float* const* channels, int numChannels, int numSamples) noexcept {
+    if (index >= directOutputs.size()) return;
+
+    // refers to the caller's channels; no allocation for any realistic channel count
+    directOutputs[index].setDataToReferTo(channels, numChannels, numSamples);
+    hasDirectOutput[index] = 1;
+}
+
+void LoopManager::clearTrackDirectOutput(size_t index) noexcept {
+    if (index < hasDirectOutput.size()) hasDirectOutput[index] = 0;
+}
+
+void LoopManager::renderTrackTask(void* context, int taskIndex) {
+    auto& manager = *static_cast<LoopManager*>(context);
+    manager.renderTrack(static_cast<size_t>(manager.tracksToRender[static_cast<size_t>(taskIndex)]), *manager.renderInput);
+}
+
+/**
+ * True when every channel stays below TrackConfig::SILENCE_THRESHOLD
+ * for the first numSamples samples.
+ */
+bool LoopManager::isDigitallySilent(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept {
+    const int samplesToCheck = juce::jmin(numSamples, buffer.getNumSamples());
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+        auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), samplesToCheck);
+        if (range.getStart() < -TrackConfig::SILENCE_THRESHOLD || range.getEnd() > TrackConfig::SILENCE_THRESHOLD) {
+            return false;
         }
     }
-    return outputs;
+    return true;
+}
+
+bool LoopManager::isTrackActiveThisBlock(size_t index) const noexcept {
+    return index < trackActive.size() && trackActive[index] != 0;
+}
+
+int LoopManager::getNumTracksActiveThisBlock() const noexcept {
+    int count = 0;
+    for (auto active : trackActive) {
+        if (active != 0) count++;
+    }
+    return count;
+}
+
+const std::vector<juce::AudioBuffer<float>*>& LoopManager::getTrackOutputs() noexcept {
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        auto& buf = trackOutputs[i];
+        outputList[i] = (buf && trackActive[i] != 0) ? &getRenderTarget(i) : nullptr;
+    }
+    return outputList;
 }
 
 std::vector<const juce::AudioBuffer<float>*> LoopManager::getTrackOutputs() const {
     std::vector<const juce::AudioBuffer<float>*> outputs;
-    outputs.reserve(TrackConfig::MAX_TRACKS);
+    outputs.reserve(tracks.size());
 
-    for (auto& buf : trackOutputs) {
-        if (buf) {
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        auto& buf = trackOutputs[i];
+        if (buf && trackActive[i] != 0) {
             // Const-correctness: safe because we're providing read-only access
-            outputs.push_back(static_cast<const juce::AudioBuffer<float>*>(buf.get()));
+            const juce::AudioBuffer<float>* target = hasDirectOutput[i] != 0 ? &directOutputs[i] : buf.get();
+            outputs.push_back(target);
         } else {
             outputs.push_back(nullptr);
         }
@@ -96,6 +289,246 @@ std::vector<const juce::AudioBuffer<float>*> LoopManager::getTrackOutputs() cons
     return outputs;
 }
 
+// === Track commands ===
+bool LoopManager::scheduleLaunch(LaunchQueue::Action action, int trackIndex, LaunchQueue::Quantize quantize) {
+    if (trackIndex != LaunchQueue::kAllTracks && (trackIndex < 0 || static_cast<size_t>(trackIndex) >= tracks.size())) {
+        return false;
+    }
+
+    // Actions that drop a track's audio carry an empty player to swap in, so the old
+    // one is freed here rather than on the audio thread. A player belongs to one track.
+    const bool needsPlayer = action == LaunchQueue::Action::StartRecording
+                          || action == LaunchQueue::Action::Clear
+                          || action == LaunchQueue::Action::Unload;
+    if (!needsPlayer) {
+        return postCommand(action, trackIndex, quantize, nullptr);
+    }
+
+    if (trackIndex != LaunchQueue::kAllTracks) {
+        return postCommand(action, trackIndex, quantize, tracks[static_cast<size_t>(trackIndex)]->createPlayer());
+    }
+
+    bool queued = true;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        queued = postCommand(action, static_cast<int>(i), quantize, tracks[i]->createPlayer()) && queued;
+    }
+    return queued;
+}
+
+bool LoopManager::armTrack(size_t trackIndex, bool armed) {
+    if (trackIndex >= tracks.size()) return false;
+    return postCommand(armed ? LaunchQueue::Action::Arm : LaunchQueue::Action::Disarm,
+                       static_cast<int>(trackIndex), LaunchQueue::Quantize::Immediate, nullptr);
+}
+
+bool LoopManager::loadTrackAudio(size_t trackIndex, const juce::AudioBuffer<float>& buffer, double sourceSampleRate) {
+    if (trackIndex >= tracks.size()) return false;
+    return loadTrackPlayer(trackIndex, tracks[trackIndex]->createPlayer(buffer, sourceSampleRate));
+}
+
+bool LoopManager::loadTrackPlayer(size_t trackIndex, std::unique_ptr<gin::SamplePlayer> player) {
+    if (trackIndex >= tracks.size() || player == nullptr) return false;
+    return postCommand(LaunchQueue::Action::LoadAudio, static_cast<int>(trackIndex), LaunchQueue::Quantize::Immediate,
+                       std::move(player));
+}
+
+bool LoopManager::adoptTrackAudio(size_t trackIndex, int downbeatOffset) {
+    if (trackIndex >= tracks.size()) return false;
+    return postCommand(LaunchQueue::Action::AdoptAudio, static_cast<int>(trackIndex), LaunchQueue::Quantize::Immediate,
+                       nullptr, downbeatOffset);
+}
+
+/**
+ * Queues one command; the queue takes the player only if the push succeeds,
+ * otherwise it is freed here on the caller's thread.
+ */
+bool LoopManager::postCommand(LaunchQueue::Action action, int trackIndex, LaunchQueue::Quantize quantize,
+                              std::unique_ptr<gin::SamplePlayer> player, int value) {
+    reclaimRetiredPlayers();
+
+    LaunchQueue::Event event;
+    event.action = action;
+    event.track = trackIndex;
+    event.quantize = quantize;
+    event.player = player.get();
+    event.value = value;
+
+    if (!launchQueue.push(event)) {
+        DBG("LoopManager: command queue full, dropping command for track " + juce::String(trackIndex));
+        return false;
+    }
+    player.release();
+    return true;
+}
+
+/**
+ * Empties the audio thread's list whether or not players are held, so a long
+ * save never leaves it full; held players are only freed at the last release.
+ */
+void LoopManager::reclaimRetiredPlayers() {
+    gin::SamplePlayer* player = nullptr;
+    while (retiredPlayers.pop(player)) {
+        if (retiredPlayerHolds > 0) {
+            heldPlayers.emplace_back(player);
+        } else {
+            delete player;
+        }
+    }
+}
+
+void LoopManager::releaseRetiredPlayers() {
+    jassert(retiredPlayerHolds > 0);
+    if (--retiredPlayerHolds == 0) {
+        heldPlayers.clear();
+        reclaimRetiredPlayers();
+    }
+}
+
+size_t LoopManager::getNumRetiredPlayers() const noexcept {
+    return retiredPlayers.getNumReady() + heldPlayers.size() + static_cast<size_t>(retireBacklogSize.load());
+}
+
+/**
+ * Room for one command's player and for one more on every track whose take
+ * ends in this segment (audio thread).
+ */
+bool LoopManager::hasRoomForLaunch() const noexcept {
+    return retiredPlayers.getNumReady() + tracks.size() < static_cast<size_t>(TrackConfig::RETIRED_PLAYER_CAPACITY);
+}
+
+/**
+ * Hands a player the audio thread no longer uses back to the message thread.
+ * It can't be freed here: a save (holdRetiredPlayers()) or the message thread
+ * may still be reading its audio.
+ */
+void LoopManager::retirePlayer(std::unique_ptr<gin::SamplePlayer> player) noexcept {
+    if (player == nullptr) return;
+
+    if (retiredPlayers.push(player.get())) {
+        player.release();
+        return;
+    }
+
+    // Commands wait for room (hasRoomForLaunch()), so only the players of cancelled ones
+    // get here, and the backlog holds as many as can be queued. Past that would be a bug.
+    const int backlogged = retireBacklogSize.load(std::memory_order_relaxed);
+    jassert(backlogged < static_cast<int>(retireBacklog.size()));
+    if (backlogged < static_cast<int>(retireBacklog.size())) {
+        retireBacklog[static_cast<size_t>(backlogged)] = player.release();
+        retireBacklogSize.store(backlogged + 1, std::memory_order_relaxed);
+    }
+}
+
+void LoopManager::flushRetireBacklog() noexcept {
+    const int backlogged = retireBacklogSize.load(std::memory_order_relaxed);
+    int flushed = 0;
+    while (flushed < backlogged && retiredPlayers.push(retireBacklog[static_cast<size_t>(flushed)])) {
+        ++flushed;
+    }
+    if (flushed == 0) return;
+
+    std::copy(retireBacklog.begin() + flushed, retireBacklog.begin() + backlogged, retireBacklog.begin());
+    retireBacklogSize.store(backlogged - flushed, std::memory_order_relaxed);
+}
+
+/**
+ * Timeline sample a launch is due on, seen from position (audio thread).
+ * A followed host that is stopped has no grid moving, so launches run at once.
+ */
+juce::int64 LoopManager::resolveLaunch(const LaunchQueue::Event& event, juce::int64 position) const noexcept {
+    if (!syncEngine.isTransportRolling()) {
+        return position;
+    }
+
+    switch (event.quantize) {
+        case LaunchQueue::Quantize::Immediate:
+            return position;
+
+        case LaunchQueue::Quantize::NextBeat:
+            return syncEngine.getNextBeatSample(position);
+
+        case LaunchQueue::Quantize::NextBar:
+            return syncEngine.getNextBarSample(position);
+
+        case LaunchQueue::Quantize::NextLoopWrap: {
+            // the event's own loop, else the first track that has one
+            const LoopTrack* reference = event.track != LaunchQueue::kAllTracks ? getTrack(static_cast<size_t>(event.track)) : nullptr;
+            if (reference == nullptr || !reference->hasLoop()) {
+                reference = nullptr;
+                for (const auto& track : tracks) {
+                    if (track->hasLoop()) {
+                        reference = track.get();
+                        break;
+                    }
+                }
+            }
+
+            // nothing loops yet: the bar line is the next musical boundary
+            if (reference == nullptr) {
+                return syncEngine.getNextBarSample(position);
+            }
+
+            const juce::int64 loopLength = reference->getLoopLengthSamples();
+            auto phase = (position - reference->getRecordingStartGlobalSample()) % loopLength;
+            if (phase < 0) phase += loopLength;
+            return phase == 0 ? position : position + (loopLength - phase);
+        }
+    }
+    return position;
+}
+
+void LoopManager::applyLaunch(const LaunchQueue::Event& event, juce::int64 position) {
+    // The event's player is ours now: it goes into its track, or back to the message thread
+    std::unique_ptr<gin::SamplePlayer> player(event.player);
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        if (event.track != LaunchQueue::kAllTracks && static_cast<size_t>(event.track) != i) continue;
+
+        auto& track = *tracks[i];
+        switch (event.action) {
+            case LaunchQueue::Action::StartRecording:
+                if (!track.isArmed()) break;                   // armed tracks only
+                if (player) retirePlayer(track.swapPlayer(std::move(player)));
+                track.startRecording(position);
+                break;
+            case LaunchQueue::Action::StopRecording:
+                // stopRecording() would also start a stopped track's playback
+                if (track.getState() == LoopTrack::State::Recording) track.stopRecording();
+                break;
+            case LaunchQueue::Action::StartPlayback:    track.startPlayback(); break;
+            case LaunchQueue::Action::StopPlayback:     track.stopPlayback(); break;
+            case LaunchQueue::Action::Clear:
+                if (player) retirePlayer(track.swapPlayer(std::move(player)));
+                track.clear();
+                break;
+            case LaunchQueue::Action::Unload:
+                if (player) retirePlayer(track.swapPlayer(std::move(player)));
+                track.unload();
+                break;
+            case LaunchQueue::Action::LoadAudio:
+                if (player) retirePlayer(track.setPlayer(std::move(player)));
+                break;
+            case LaunchQueue::Action::AdoptAudio:       track.adoptAudioAsLoop(event.value); break;
+            case LaunchQueue::Action::Arm:              track.armForRecording(true); break;
+            case LaunchQueue::Action::Disarm:           track.armForRecording(false); break;
+            case LaunchQueue::Action::Multiply:
+            case LaunchQueue::Action::Divide:
+            case LaunchQueue::Action::Undo: {
+                // Loop edits copy the loop through the undo buffer, as they do from the UI today
+                const AudioThreadGuard::ScopedAllowance loopEdit;
+                if (event.action == LaunchQueue::Action::Multiply)      track.multiplyLoop();
+                else if (event.action == LaunchQueue::Action::Divide)   track.divideLoop();
+                else                                                    track.performUndo();
+                retirePlayer(track.takeReplacedPlayer());
+                break;
+            }
+        }
+    }
+
+    // not taken (e.g. recording on a track that isn't armed)
+    retirePlayer(std::move(player));
+}
+
 /**
  *  Get track when we need to modify the track
  *  ex:
@@ -125,28 +558,29 @@ const LoopTrack* LoopManager::getTrack(size_t trackIndex) const {
 }
 
 void LoopManager::startAllPlayback() {
-    for (auto& track : tracks) {
-        if (track->hasLoop()) {
-            track->startPlayback();
-        }
-    }
+    // startPlayback() skips tracks without a loop
+    scheduleLaunch(LaunchQueue::Action::StartPlayback, LaunchQueue::kAllTracks);
 }
 
 void LoopManager::stopAllPlayback() {
-    for (auto& track : tracks) {
-        track->stopPlayback();
-    }
+    scheduleLaunch(LaunchQueue::Action::StopPlayback, LaunchQueue::kAllTracks);
 }
 
 void LoopManager::clearAllTracks() {
-    for (auto& track : tracks) {
-        track->clear();
-    }
+    scheduleLaunch(LaunchQueue::Action::Clear, LaunchQueue::kAllTracks);
 }
 
 void LoopManager::armAllTracks(bool armed) {
+    scheduleLaunch(armed ? LaunchQueue::Action::Arm : LaunchQueue::Action::Disarm, LaunchQueue::kAllTracks);
+}
+
+/**
+ * Every track compensates takes started from now on; a take in progress keeps
+ * the latency it started with.
+ */
+void LoopManager::setRecordLatency(int samples) noexcept {
     for (auto& track : tracks) {
-        track->armForRecording(armed);
+        track->setRecordLatency(samples);
     }
 }
 
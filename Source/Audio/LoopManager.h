@@ -2,37 +2,96 @@
 // Created by Vincewa Tran on 1/28/26.
 //
 #pragma once
-#include "memory"
 #include "array"
+#include "atomic"
+#include "memory"
 #include "vector"
 #include "gin_dsp/gin_dsp.h"
 #include "LoopTrack.h"
 #include "SyncEngine.h"
 #include "MixerEngine.h"
+#include "RealtimeWorkerPool.h"
+#include "LaunchQueue.h"
+#include "SpscQueue.h"
 #include "../Utils/TrackConfig.h"
 
 
 class LoopManager {
 public:
-    explicit LoopManager(SyncEngine& syncEngine);
-    ~LoopManager() = default;
+    // The project's track count; setNumTracks() changes it while the audio is stopped.
+    explicit LoopManager(SyncEngine& syncEngine, int numTracks = TrackConfig::DEFAULT_NUM_TRACKS);
+    ~LoopManager();
 
     // === Audio thread methods ===
     void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
     void releaseResources();
     void processBlock(const juce::AudioBuffer<float>& input);
 
+    // === Parallel rendering ===
+    // Worker threads that render tracks alongside the audio thread (0 = serial).
+    // Takes effect at the next prepareToPlay. Output is bit-identical either way.
+    void setNumRenderWorkers(int numWorkers) noexcept { requestedRenderWorkers = numWorkers; }
+    int getNumRenderWorkers() const noexcept { return renderPool.getNumWorkers(); }
+
+    // === Direct outputs ===
+    // Renders the track straight into the given channels this block (e.g. a host output
+    // bus) instead of its internal buffer; the mixer then reads it from there, so the
+    // stem costs no copy. Audio thread, before processBlock(). Cleared by prepareToPlay.
+    void setTrackDirectOutput(size_t index, float* const* channels, int numChannels, int numSamples) noexcept;
+    void clearTrackDirectOutput(size_t index) noexcept;
+
+    // === Track commands (message thread, the only producer) ===
+    // Every state change reaches the audio thread through one lock-free queue, drained
+    // at the start of each block. A quantized command waits for the next beat, bar or
+    // loop wrap; the audio thread ends a render segment there, so it lands on that
+    // exact sample at any buffer size. trackIndex may be LaunchQueue::kAllTracks.
+    // False for an unknown track or a full queue.
+    bool scheduleLaunch(LaunchQueue::Action action, int trackIndex,
+                        LaunchQueue::Quantize quantize = LaunchQueue::Quantize::Immediate);
+    bool armTrack(size_t trackIndex, bool armed);
+    // The buffer is copied into a player here; the audio thread only swaps a pointer
+    bool loadTrackAudio(size_t trackIndex, const juce::AudioBuffer<float>& buffer, double sourceSampleRate);
+    // Same, with a player already built (LoopTrack::createPlayer(buffer, rate)) on another thread
+    bool loadTrackPlayer(size_t trackIndex, std::unique_ptr<gin::SamplePlayer> player);
+    // Loaded audio becomes the track's loop, downbeatOffset samples in landing on the bar lines
+    bool adoptTrackAudio(size_t trackIndex, int downbeatOffset);
+    void cancelScheduledLaunches() noexcept { launchQueue.cancelAll(); }
+    int getNumScheduledLaunches() const noexcept { return launchQueue.getNumScheduled(); }    // audio thread
+
+    // Frees players the audio thread swapped out. Called on every command; the processor
+    // also calls it from its timer so nothing lingers while nobody sends commands.
+    void reclaimRetiredPlayers();
+    // While held, swapped-out players are still taken off the audio thread's list but
+    // kept until the last release, so a background job can go on reading the buffers it
+    // was handed here (a save streaming them to disk). Nestable.
+    void holdRetiredPlayers() noexcept { ++retiredPlayerHolds; }
+    void releaseRetiredPlayers();
+    // Swapped out and not freed yet, wherever they wait. Message thread.
+    size_t getNumRetiredPlayers() const noexcept;
+    // True once after due commands had to wait a block because the audio thread's list of
+    // swapped-out players was short of room. Message thread.
+    bool takeLaunchesHeldBack() noexcept { return launchesHeldBack.exchange(false, std::memory_order_relaxed); }
+
     // === Track access ===
     LoopTrack* getTrack(size_t trackIndex);
     const LoopTrack* getTrack(size_t trackIndex) const;
-    size_t getNumTracks() const noexcept { return TrackConfig::MAX_TRACKS; }
+    size_t getNumTracks() const noexcept { return tracks.size(); }
+    // Adds empty tracks or removes the last ones, whatever they hold. Message thread, with
+    // the audio thread not processing (not yet prepared, or the processor suspended) and
+    // no file job reading the tracks; new tracks are prepared by the next prepareToPlay.
+    // Commands queued for a removed track are dropped when they come due.
+    void setNumTracks(int numTracks);
 
-    // === Global transport controls ===
+    // === Global transport controls (queued, applied at the next block) ===
     void startAllPlayback();
     void stopAllPlayback();
     void clearAllTracks();
     void armAllTracks(bool armed);
 
+    // === Latency compensation (any thread) ===
+    // Round-trip input/output latency in samples, so new takes line up with the loops heard
+    void setRecordLatency(int samples) noexcept;
+
     // === Sync access ===
     SyncEngine& getSyncEngine() noexcept { return syncEngine; }
     const SyncEngine& getSyncEngine() const noexcept { return syncEngine; }
@@ -43,6 +102,11 @@ public:
     bool isAllTracksEmpty() const;
     int getNumActiveTracks() const;
 
+    // === Per-block activity (audio thread) ===
+    // A track is active when it was processed this block and produced non-silent output
+    bool isTrackActiveThisBlock(size_t index) const noexcept;
+    int getNumTracksActiveThisBlock() const noexcept;
+
     // === Per-track status helpers (for UI) ===
     LoopTrack::State getTrackState(size_t index) const;
     bool isTrackArmed(size_t index) const;
@@ -51,17 +115,66 @@ public:
     float getTrackVolume(size_t index) const;
     float getTrackPan(size_t index) const;
 
-    // === Get track outputs for MixerEngine ===
-    std::vector<juce::AudioBuffer<float>*> getTrackOutputs();
+    // === Get track outputs for MixerEngine (nullptr for idle/silent tracks) ===
+    // Audio thread: refreshes a list sized once in the constructor, so it never allocates.
+    const std::vector<juce::AudioBuffer<float>*>& getTrackOutputs() noexcept;
+    // Copying variant for read-only callers off the audio thread.
     std::vector<const juce::AudioBuffer<float>*> getTrackOutputs() const;
 
 private:
     // === Core components ===
     SyncEngine& syncEngine;
-    std::array<std::unique_ptr<LoopTrack>, TrackConfig::MAX_TRACKS> tracks;
+    std::vector<std::unique_ptr<LoopTrack>> tracks;
+
+    // === Per-track output buffers (sized once in the constructor) ===
+    std::vector<std::unique_ptr<gin::ScratchBuffer>> trackOutputs;
+    std::vector<uint8_t> trackActive;
+    std::vector<uint8_t> trackRendered;                  // rendered by an earlier segment of this block
+    std::vector<juce::AudioBuffer<float>*> outputList;    // returned by getTrackOutputs()
+
+    // === Direct outputs (views onto caller-owned channels, set per block) ===
+    std::vector<juce::AudioBuffer<float>> directOutputs;
+    std::vector<uint8_t> hasDirectOutput;
+
+    juce::AudioBuffer<float>& getRenderTarget(size_t index) noexcept;
+
+    // === Parallel rendering ===
+    RealtimeWorkerPool renderPool;
+    int requestedRenderWorkers = 0;
+    std::vector<int> tracksToRender;                    // reserved once, filled per block
+    const juce::AudioBuffer<float>* renderInput = nullptr;
+    int renderOffset = 0;                               // segment start within the block's outputs
+
+    void renderSegment(const juce::AudioBuffer<float>& input, int offset, int numSamples);
+    void renderTrack(size_t index, const juce::AudioBuffer<float>& input);
+    static void renderTrackTask(void* context, int taskIndex);
+
+    // === Quantized launches (audio thread) ===
+    LaunchQueue launchQueue;
+    juce::int64 expectedLaunchPosition = 0;             // where the timeline continues if it doesn't jump
+
+    juce::int64 resolveLaunch(const LaunchQueue::Event& event, juce::int64 position) const noexcept;
+    void applyLaunch(const LaunchQueue::Event& event, juce::int64 position);
+    bool postCommand(LaunchQueue::Action action, int trackIndex, LaunchQueue::Quantize quantize,
+                     std::unique_ptr<gin::SamplePlayer> player, int value = 0);
+
+    // === Player handover: audio thread -> message thread ===
+    // A command hands back at most one player, and a take one more when it ends, so
+    // commands only run while the list has room for that on every track (see hasRoomForLaunch()).
+    static_assert(TrackConfig::RETIRED_PLAYER_CAPACITY > TrackConfig::MAX_TRACKS, "no room left for commands");
+    SpscQueue<gin::SamplePlayer*, static_cast<size_t>(TrackConfig::RETIRED_PLAYER_CAPACITY)> retiredPlayers;
+    // Players of cancelled commands, dropped all at once, wait here (audio thread) for room.
+    // Every queued command fits: the inbox and the schedule hold LAUNCH_QUEUE_CAPACITY each.
+    std::array<gin::SamplePlayer*, 2 * TrackConfig::LAUNCH_QUEUE_CAPACITY> retireBacklog {};
+    std::atomic<int> retireBacklogSize { 0 };
+    std::atomic<bool> launchesHeldBack { false };
+    void retirePlayer(std::unique_ptr<gin::SamplePlayer> player) noexcept;
+    void flushRetireBacklog() noexcept;
+    bool hasRoomForLaunch() const noexcept;
+    int retiredPlayerHolds = 0;                         // message thread
+    std::vector<std::unique_ptr<gin::SamplePlayer>> heldPlayers;    // message thread, until the last release
 
-    // === Per-track output buffers ===
-    std::array<std::unique_ptr<gin::ScratchBuffer>, TrackConfig::MAX_TRACKS> trackOutputs;
+    static bool isDigitallySilent(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopManager)
 };
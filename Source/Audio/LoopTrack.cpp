@@ -3,18 +3,17 @@
 // Represents a single independent loop track with a state machine
 // - Integrate the CircularBuffer + volume/pan + record/play state
 // - Where audio data gets processed.
-// - DSP and effects chain will eventually go here as well.
+// - Insert effects run through the per-track TrackFxChain.
 
 #include "LoopTrack.h"
 
+#include <algorithm>
+
 LoopTrack::LoopTrack(int id) : trackId(id),
 recordingBuffer(2, 1024),
-undoBuffer(2, 1024) {
-
-    // Configure Gin's SamplePlayer
-    player.setLooping(true);
-    player.setCrossfadeSamples(TrackConfig::DEFAULT_BUFFER_SIZE);       // Buffer size of 256
-
+undoBuffer(2, 1024),
+player(createPlayer()) {
+    installedPlayer.store(player.get(), std::memory_order_release);
 }
 
 LoopTrack::~LoopTrack() {
@@ -27,7 +26,8 @@ LoopTrack::~LoopTrack() {
 void LoopTrack::releaseResources() {
     recordingBuffer.setSize(0, 0);
     undoBuffer.setSize(0, 0);
-    player.reset();
+    playerScratch.setSize(0, 0);
+    player->reset();
 }
 
 /**
@@ -39,7 +39,7 @@ void LoopTrack::releaseResources() {
  * Called on the audio thread during prepareToPlay()
  * Allocates buffers and initializes DSP components
  */
-void LoopTrack::prepareToPlay(double sr, int /*samplesPerBlock*/, int numChannels) {
+void LoopTrack::prepareToPlay(double sr, int samplesPerBlock, int numChannels) {
 
     sampleRate = sr;
 
@@ -53,47 +53,107 @@ void LoopTrack::prepareToPlay(double sr, int /*samplesPerBlock*/, int numChannel
     undoBuffer.reset();
 
     // Configure SamplePlayer (GIN)
-    player.setPlaybackSampleRate(sampleRate);
-    player.reset();
+    player->setPlaybackSampleRate(sampleRate);
+    player->reset();
     playerLoaded = false;
 
-    // 50ms volume fade
-    volumeSmoother.setSampleRate(sampleRate);
-    volumeSmoother.setTime(TrackConfig::VOLUME_FADE_SECONDS);
-    volumeSmoother.setValueUnsmoothed(
-            juce::Decibels::decibelsToGain(currentVolumeDb.load()));
+    // One block of player output, reused every block
+    playerScratch.setSize(numChannels, samplesPerBlock);
 
-    // 30ms pan fade
-    panSmoother.setSampleRate(sampleRate);
-    panSmoother.setTime(TrackConfig::PAN_FADE_SECONDS);
-    panSmoother.setValueUnsmoothed(currentPan.load());
+    // Insert effects are all prepared now, so enabling one later never allocates
+    fxChain.prepare(sampleRate, samplesPerBlock, numChannels);
+
+    // Pick the mono/stereo processing path once
+    preparedChannels = numChannels;
+    switch (numChannels) {
+        case 1:  processForLayout = &LoopTrack::processBlockForLayout<1>; break;
+        case 2:  processForLayout = &LoopTrack::processBlockForLayout<2>; break;
+        default: processForLayout = &LoopTrack::processBlockForLayout<TrackConfig::DYNAMIC_CHANNELS>; break;
+    }
 }
 
 /**
- * Sets the audio buffer for this loop track.
+ * Loads audio data into track from an external buffer
  * - stops any ongoing playback or recording
  * - clears any existing recording buffer
- * - handles resampling if needed
- * - configures the internal player with the new buffer and sample rate
+ * - the player resamples if the source rate differs from the track's
+ *
+ * Only for a track the audio thread isn't using; otherwise build the player with
+ * createPlayer(buffer, rate) and hand it over through LoopManager::loadTrackAudio().
  *
  * @param newBuffer             Buffer containing audio data to be used
  * @param sourceSampleRate      Sample rate of the provided audio buffer
  */
 void LoopTrack::setAudioBuffer(const juce::AudioSampleBuffer &newBuffer, double sourceSampleRate) {
+    setPlayer(createPlayer(newBuffer, sourceSampleRate));
+}
+
+/**
+ * Makes loaded audio the track's loop: its whole length at the project rate,
+ * placed so the sample downbeatOffset in falls on the timeline's bar lines
+ * (the loop is counted from sample -downbeatOffset).
+ * Audio thread, through LoopManager::adoptTrackAudio().
+ *
+ * @param downbeatOffset        First downbeat in the audio, project samples
+ */
+void LoopTrack::adoptAudioAsLoop(int downbeatOffset) {
+    if (!hasAudio() || currentState.load() == State::Recording) return;
+
+    const double sourceRate = player->getSourceSampleRate();
+    const double ratio = (sourceRate > 0.0 && sampleRate > 0.0) ? sampleRate / sourceRate : 1.0;
+    loopLengthSamples.store(juce::roundToInt(player->getBuffer().getNumSamples() * ratio));
+    recordingStartGlobalSample.store(-static_cast<juce::int64>(downbeatOffset));
+    realignPending = true;
+
+    if (currentState.load() == State::Empty) {
+        currentState.store(State::Stopped);
+    }
+}
+
+// === Player handover ===
+/**
+ * A player configured like this track's (looping, crossfade, playback rate).
+ * Allocates, so it is built off the audio thread and handed over by pointer.
+ */
+std::unique_ptr<gin::SamplePlayer> LoopTrack::createPlayer() const {
+    auto newPlayer = std::make_unique<gin::SamplePlayer>();
+    newPlayer->setLooping(true);
+    newPlayer->setCrossfadeSamples(TrackConfig::DEFAULT_BUFFER_SIZE);   // Buffer size of 256
+    if (sampleRate > 0.0) {
+        newPlayer->setPlaybackSampleRate(sampleRate);
+    }
+    return newPlayer;
+}
+
+std::unique_ptr<gin::SamplePlayer> LoopTrack::createPlayer(const juce::AudioSampleBuffer& buffer,
+                                                           double sourceSampleRate) const {
+    auto newPlayer = createPlayer();
+    newPlayer->setBuffer(buffer, sourceSampleRate);
+    return newPlayer;
+}
+
+std::unique_ptr<gin::SamplePlayer> LoopTrack::swapPlayer(std::unique_ptr<gin::SamplePlayer> replacement) noexcept {
+    jassert(replacement != nullptr);
+    std::swap(player, replacement);
+    installedPlayer.store(player.get(), std::memory_order_release);
+    audioGeneration.fetch_add(1, std::memory_order_release);
+    return replacement;
+}
+
+/**
+ * Installs a loaded player (see createPlayer(buffer, rate)) in place of the
+ * current audio, like setAudioBuffer(). Returns the old player, so the caller
+ * decides which thread frees it.
+ */
+std::unique_ptr<gin::SamplePlayer> LoopTrack::setPlayer(std::unique_ptr<gin::SamplePlayer> loadedPlayer) {
     // Clear any existing recording state
     stop();
     recordingBuffer.reset();
+    latencyTailRemaining = 0;
 
-    // TODO: Handle mismatched sample rates
-
-    // Set audio buffer
-    player.setBuffer(newBuffer, sourceSampleRate);
-    sampleRate = sourceSampleRate;
-
+    auto previous = swapPlayer(std::move(loadedPlayer));
     playerLoaded = true;
-
-    DBG("Track " + juce::String(trackId) + ": Audio buffer set - " +
-        juce::String(newBuffer.getNumSamples()) + " samples");
+    return previous;
 }
 
 /**
@@ -112,49 +172,101 @@ void LoopTrack::processBlock(const juce::AudioBuffer<float> &input,
                              juce::AudioBuffer<float> &output,
                              const SyncEngine& syncEngine) {
 
+    // Specialisation was picked in prepareToPlay; fall back if the caller hands us another layout
+    if (output.getNumChannels() == preparedChannels && input.getNumChannels() >= preparedChannels) {
+        (this->*processForLayout)(input, output, syncEngine);
+    } else {
+        processBlockForLayout<TrackConfig::DYNAMIC_CHANNELS>(input, output, syncEngine);
+    }
+}
+
+/**
+ * processBlock body, specialised on channel count so the per-channel loops
+ * are fixed at compile time (DYNAMIC_CHANNELS reads the count from the buffers).
+ */
+template <int NumChannels>
+void LoopTrack::processBlockForLayout(const juce::AudioBuffer<float> &input,
+                                      juce::AudioBuffer<float> &output,
+                                      const SyncEngine& syncEngine) {
+
+    constexpr bool fixedLayout = NumChannels != TrackConfig::DYNAMIC_CHANNELS;
+    const int numChannels = fixedLayout ? NumChannels : output.getNumChannels();
     const int numSamples = input.getNumSamples();
     State state = currentState.load();
 
     // === Recording ===
-    if (state == State::Recording && isRecordingActive.load()) {
+    // The input runs takeLatency behind the timeline, so the take's first sample arrives
+    // that late and its last one that long after the stop. Both ends are index arithmetic
+    // on the FIFO: the early input is popped unread and the tail only written in part.
+    const bool recording = state == State::Recording && isRecordingActive.load();
+    if (recording || latencyTailRemaining > 0) {
+        const int numToWrite = recording ? numSamples : juce::jmin(numSamples, latencyTailRemaining);
+        const juce::AudioBuffer<float> take(const_cast<float* const*>(input.getArrayOfReadPointers()),
+                                            input.getNumChannels(), numToWrite);
+        if (!recording) {
+            latencyTailRemaining -= numToWrite;
+        }
+
         // Write to FIFO
-        if (!recordingBuffer.write(input)){
+        if (!recordingBuffer.write(take)){
             // Buffer is full so overwrite the oldest sampled audio
-            recordingBuffer.ensureFreeSpace(numSamples);
-            recordingBuffer.write(input);
+            recordingBuffer.ensureFreeSpace(numToWrite);
+            recordingBuffer.write(take);
+        }
+
+        if (latencySkipRemaining > 0) {
+            const int skipped = juce::jmin(latencySkipRemaining, recordingBuffer.getNumReady());
+            recordingBuffer.pop(skipped);
+            latencySkipRemaining -= skipped;
         }
 
         // If this is the initial input/recording in the loop
-        if (loopLengthSamples.load() == 0) {
-            int recorded = recordingBuffer.getNumReady();
-            int samplesPerBeat = syncEngine.getSamplesPerBeat();
-
-            if (samplesPerBeat > 0) {
-                // Align to nearest beat boundary
-                int alignedLength = ((recorded + samplesPerBeat -1) /
-                        samplesPerBeat) * samplesPerBeat;
+        const int recorded = recordingBuffer.getNumReady();
+        if (recording && loopLengthSamples.load() == 0 && recorded > 0) {
+            // Round up to whole beats from where the take started, on the tempo map,
+            // so the boundary is exact even at fractional samples-per-beat
+            int alignedLength = syncEngine.getBeatAlignedLength(recordingStartGlobalSample.load(), recorded);
+            if (alignedLength > 0) {
                 setLoopLength(alignedLength);
             }
         }
     }
 
+    // === Timeline ===
+    // When the clock jumps (host relocation or loop wrap) the loop picks up where the
+    // timeline now is, counted from the take's start, so it stays on the host's grid
+    if (const auto generation = syncEngine.getTimelineGeneration(); generation != timelineGeneration || realignPending) {
+        timelineGeneration = generation;
+        realignPending = false;
+        if (playerLoaded) {
+            alignPlayerToTimeline(syncEngine.getBlockStartSample());
+        }
+    }
+
     // === Playback ===
+    // A followed host that is stopped holds every loop where it is
+    // (and a take isn't loaded before its latency tail is in)
     bool shouldPlay = (state == State::Playing || state == State::Recording)
-            && hasLoop();
+            && hasLoop() && syncEngine.isTransportRolling() && latencyTailRemaining == 0;
 
     if (shouldPlay) {
         // If it's the first time hitting play, load the buffer into Gin's SamplePlayer
         if (!playerLoaded && hasLoop()) {
             loadRecordingToPlayer();
-            player.play();
+            player->play();
             playerLoaded = true;
+            alignPlayerToTimeline(syncEngine.getBlockStartSample());
         }
 
-        // Get temporary buffer - NO ALLOCATION!
-        gin::ScratchBuffer playerOutput(output.getNumChannels(), numSamples);
+        // View onto the prepared scratch; hosts never exceed the prepared block size
+        jassert(numSamples <= playerScratch.getNumSamples() && numChannels <= playerScratch.getNumChannels());
+        if (playerScratch.getNumSamples() < numSamples || playerScratch.getNumChannels() < numChannels) {
+            playerScratch.setSize(numChannels, numSamples, false, false, true);
+        }
+        juce::AudioBuffer<float> playerOutput(playerScratch.getArrayOfWritePointers(), numChannels, numSamples);
 
         // SamplePlayer handles crossfading, looping, and position tracking
-        player.processBlock(playerOutput);
+        player->processBlock(playerOutput);
 
         // Apply Effects
         // Slip
@@ -163,19 +275,18 @@ void LoopTrack::processBlock(const juce::AudioBuffer<float> &input,
         }
 
         // Offset sample from the grid
-        if (slipOffset.load() != 0) {
-            applySlip(playerOutput);
+        if (const int offset = slipOffset.load(); offset != 0) {
+            applySlip(playerOutput, offset);
         }
 
-        applyDspProcessing(playerOutput);
+        // Volume/pan are applied once, downstream in MixerEngine
 
-        // Mix into output
-        for (int ch = 0; ch < output.getNumChannels(); ++ch) {
-            int sourceCh = ch % playerOutput.getNumChannels();
+        // Mix into output (player output has the same layout as the track)
+        for (int ch = 0; ch < numChannels; ++ch) {
             output.addFrom(ch,
                            0,
                            playerOutput,
-                           sourceCh,
+                           ch,
                            0,
                            numSamples);
         }
@@ -188,10 +299,12 @@ void LoopTrack::processBlock(const juce::AudioBuffer<float> &input,
 
     // === Input Monitoring ===
     // When armed but not recording, pass live input through at reduced gain
-    if (isArmedForRecording.load() && !isRecordingActive.load()) {
+    const bool monitoring = isArmedForRecording.load() && !isRecordingActive.load();
+    if (monitoring) {
         constexpr float monitorGain = 0.5f;
-        for (int ch = 0; ch < output.getNumChannels(); ++ch) {
-            int sourceCh = ch % input.getNumChannels();
+        for (int ch = 0; ch < numChannels; ++ch) {
+            // fixed layouts are only dispatched when the input has at least as many channels
+            const int sourceCh = fixedLayout ? ch : ch % input.getNumChannels();
             output.addFrom(ch,
                            0,
                            input,
@@ -201,54 +314,10 @@ void LoopTrack::processBlock(const juce::AudioBuffer<float> &input,
                            monitorGain);
         }
     }
-}
-
-/**
- * Applies volume and pan DSP to an audio buffer
- * @param bufferToProcess - Audio buffer to process in-place
- *
- * Features:
- * - Linear ramp for volume changes (avoids clicks/pops)
- * - Equal-power panning for stereo signals
- */
-void LoopTrack::applyDspProcessing(juce::AudioBuffer<float> &bufferToProcess) {
-
-    const int numSamples = bufferToProcess.getNumSamples();
-    const int numChannels = bufferToProcess.getNumChannels();
-
-    // Apply volume smoothing
-    // Convert dB to linear gain and apply ramp
-    float targetGain = juce::Decibels::decibelsToGain(currentVolumeDb.load());
-    float targetPan = currentPan.load();
-
-    volumeSmoother.setValue(targetGain);
-    panSmoother.setValue(targetPan);
-
-    // Apply with QuadraticOutEasing
-    for (int s = 0; s < numSamples; ++s) {
-        float gain = volumeSmoother.getNextValue();
-        float pan = panSmoother.getNextValue();
-
-        if (numChannels == 2) {
-            // Stereo
-            float leftGain, rightGain;
-            if (pan <= 0.0f) {
-                leftGain = gain;
-                rightGain = gain * (1.0f + pan);
-            } else {
-                leftGain = gain * (1.0f - pan);
-                rightGain = gain;
-            }
 
-            bufferToProcess.getWritePointer(0)[s] *= leftGain;
-            bufferToProcess.getWritePointer(1)[s] *= rightGain;
-        } else {
-            // Mono - only apply volume
-            for (int ch = 0; ch < numChannels; ++ch) {
-                bufferToProcess.getWritePointer(ch)[s] *= gain;
-            }
-        }
-    }
+    // === Insert Effects ===
+    // Bypassed slots cost nothing; with no new signal the chain only runs while its tail rings out
+    fxChain.process(output, !(shouldPlay || monitoring));
 }
 
 void LoopTrack::armForRecording(bool isArmed) {
@@ -260,18 +329,26 @@ void LoopTrack::startRecording(juce::int64 globalSample) {
     if(!isArmedForRecording.load()) return;
 
     recordingStartGlobalSample.store(globalSample);
+    takeLatency = recordLatencySamples.load();
+    latencySkipRemaining = takeLatency;
+    latencyTailRemaining = 0;
     isRecordingActive.store(true);
     currentState.store(State::Recording);
 
     // Clear previous loop
     recordingBuffer.reset();
     loopLengthSamples.store(0);
-    player.clear();
+    dropPlayerAudio();
     playerLoaded = false;
 }
 
 void LoopTrack::stopRecording() {
-    isRecordingActive.store (false);
+    // A take that is ending still has its last takeLatency samples to come in,
+    // and plays on from wherever the timeline is by then
+    if (isRecordingActive.exchange(false)) {
+        latencyTailRemaining = takeLatency;
+        realignPending = true;
+    }
 
     if (hasLoop()) {
         currentState.store(State::Playing);
@@ -287,13 +364,13 @@ void LoopTrack::startPlayback() {
 
     // Play and update state
     isPlaybackActive.store(true);
-    player.play();
+    player->play();
     currentState.store(State::Playing);
 }
 
 void LoopTrack::stopPlayback() {
     isPlaybackActive.store(false);
-    player.stop();
+    player->stop();
 
     if (currentState.load() != State::Recording) {
         currentState.store(hasLoop() ? State::Stopped : State::Empty);
@@ -307,33 +384,45 @@ void LoopTrack::stop() {
 
 /**
  * Clears all track data and resets to empty state
- * Safe to call from any thread
+ * On the audio thread, swap in an empty player first so nothing is freed there
  */
 void LoopTrack::clear() {
+    unload();
+    resetSettings();
+}
+
+/**
+ * Drops the loop and its recording, keeping the track's settings
+ */
+void LoopTrack::unload() {
     stop();
 
     recordingBuffer.reset();
     undoBuffer.reset();
-    player.clear();
+    dropPlayerAudio();
 
-    // Reset all states
+    loopLengthSamples = 0;
+    recordingStartGlobalSample.store(0);
+    currentState.store(State::Empty);
+    hasUndo = false;
+    playerLoaded = false;
+    latencyTailRemaining = 0;
+}
+
+/**
+ * Volume, pan, mute, solo, reverse and slip back to their defaults (atomics, any thread)
+ */
+void LoopTrack::resetSettings() {
     currentVolumeDb.store(TrackConfig::DEFAULT_VOLUME_DB);
     currentPan.store(TrackConfig::DEFAULT_PAN);
     muteState.store(false);
     soloState.store(false);
     reverseState.store(false);
     slipOffset.store(0);
+}
 
-    // Reset smoothers
-    volumeSmoother.setValueUnsmoothed(
-            juce::Decibels::decibelsToGain(currentVolumeDb.load()));
-    panSmoother.setValueUnsmoothed(currentPan.load());
-
-    loopLengthSamples = 0;
-    recordingStartGlobalSample.store(0);
-    currentState.store(State::Empty);
-    hasUndo = false;
-    playerLoaded = false;
+void LoopTrack::setRecordLatency(int samples) noexcept {
+    recordLatencySamples.store(juce::jmax(0, samples));
 }
 
 void LoopTrack::setLoopLength(int samples) {
@@ -348,6 +437,7 @@ void LoopTrack::setLoopLength(int samples) {
         recordingBuffer.pop(currentReady - samples);
     }
     loadRecordingToPlayer();
+    realignPending = true;          // the new player starts at its first sample
 }
 
 void LoopTrack::multiplyLoop() {
@@ -406,23 +496,57 @@ void LoopTrack::setReverse(bool reverse) { reverseState.store(reverse); }
 void LoopTrack::setSlip(int samples) { slipOffset.store(samples); }
 
 // === Private Helpers ===
+/**
+ * Empties the player. A command has already swapped in an empty one on the audio
+ * thread, so this only clears in place off it, where nothing else reads the player.
+ */
+void LoopTrack::dropPlayerAudio() {
+    if (player->getBuffer().getNumSamples() > 0) {
+        player->clear();
+    }
+    audioGeneration.fetch_add(1, std::memory_order_release);
+}
+
 void LoopTrack::loadRecordingToPlayer() {
     int loopLen = loopLengthSamples.load();
     if (loopLen <= 0) return;
 
     int channels = recordingBuffer.getNumChannels();
 
+    // Runs on the audio thread once per take, when the loop length is set, and for loop edits.
+    // gin::SamplePlayer owns a copy of the loop, so handing it over allocates.
+    const AudioThreadGuard::ScopedAllowance loopHandover;
+
     // Get temporary buffer from pool
     gin::ScratchBuffer temp(channels, loopLen);
 
     // Peek at recording buffer
     if (recordingBuffer.peek(temp, 0, loopLen)) {
-        // Load into gin::SamplePlayer
-        player.setBuffer(temp, sampleRate);
+        // Into a new player: the installed one's audio may still be read by a save or the UI.
+        // LoopManager takes the old one after every command and segment; a direct caller
+        // off the audio thread just frees the previous one here.
+        auto loaded = createPlayer(temp, sampleRate);
+        if (currentState.load() == State::Playing) {
+            loaded->play();
+        }
+        replacedPlayer = swapPlayer(std::move(loaded));
         playerLoaded = true;
     }
 }
 
+void LoopTrack::alignPlayerToTimeline(juce::int64 timelineSample) {
+    const int loopLen = loopLengthSamples.load();
+    if (loopLen <= 0) return;
+
+    auto phase = (timelineSample - recordingStartGlobalSample.load()) % loopLen;
+    if (phase < 0) phase += loopLen;
+
+    // the player counts in source samples (loaded files may be at another rate)
+    const double sourceRate = player->getSourceSampleRate();
+    const double ratio = (sourceRate > 0.0 && sampleRate > 0.0) ? sourceRate / sampleRate : 1.0;
+    player->setPosition(static_cast<double>(phase) * ratio);
+}
+
 void LoopTrack::saveUndo() {
     int currentLen = loopLengthSamples.load();
     if (currentLen > 0) {
@@ -453,35 +577,36 @@ void LoopTrack::applyReverse(juce::AudioBuffer<float> &buffer) {
  * Implements circular buffer rotation for slip feature
  * Example: [1,2,3,4] with offset=2 becomes [3,4,1,2]
  */
-void LoopTrack::applySlip(juce::AudioBuffer<float>& buffer) {
-
-    int offset = slipOffset.load();
-    if (offset == 0) return;
+void LoopTrack::applySlip(juce::AudioBuffer<float>& buffer, int offset) {
 
     const int numSamples = buffer.getNumSamples();
     offset = offset % numSamples;
     if (offset < 0) offset += numSamples;
     if (offset == 0) return;
 
-    // Create temporary copy
-    gin::ScratchBuffer temp(buffer);
-
-    // Apply rotation
+    // Rotate in place: samples from the offset onwards move to the start
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* dest = buffer.getWritePointer(ch);
-        auto* src = temp.getReadPointer(ch);
-
-        // Copy second part to beginning
-        std::memcpy(dest,
-                    src + offset,
-                    static_cast<size_t>(numSamples - offset) * sizeof(float));
-        // Copy first part to end
-        std::memcpy(dest + (numSamples - offset),
-                    src,
-                    static_cast<size_t>(offset) * sizeof(float));
+        auto* data = buffer.getWritePointer(ch);
+        std::rotate(data, data + offset, data + numSamples);
     }
 }
 
+/**
+ * True when processBlock would neither record, play back nor monitor input,
+ * so LoopManager can skip the track entirely for this block.
+ */
+bool LoopTrack::isIdle() const noexcept {
+    const State state = currentState.load();
+    const bool recording = isRecordingActive.load();
+
+    if (state == State::Recording && recording) return false;
+    if (latencyTailRemaining > 0) return false;                     // the take's last input is still coming
+    if ((state == State::Playing || state == State::Recording) && hasLoop()) return false;
+    if (isArmedForRecording.load() && !recording) return false;     // input monitoring
+    if (fxChain.hasTail()) return false;                            // delay still ringing out
+    return true;
+}
+
 juce::String LoopTrack::getStateString() const {
     switch (currentState.load()) {
         case State::Empty:          return "Empty";
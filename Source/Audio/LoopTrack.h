@@ -3,7 +3,7 @@
 // Represents a single independent loop track with a state machine
 // - Integrate the CircularBuffer + volume/pan + record/play state
 // - Where audio data gets processed.
-// - DSP and effects chain will eventually go here as well.
+// - Insert effects run through the per-track TrackFxChain.
 //
 #pragma once
 // JUCE modules
@@ -14,6 +14,8 @@
 #include "gin_dsp/gin_dsp.h"
 // Project includes
 #include "SyncEngine.h"
+#include "TrackFxChain.h"
+#include "../Utils/AudioThreadGuard.h"
 #include "../Utils/TrackConfig.h"
 
 /**
@@ -22,8 +24,8 @@
  * Gin components used directly:
  * - gin::AudioFifo: Lock-free recording buffer
  * - gin::SamplePlayer: Professional playback engine
- * - gin::SmoothedValue: Click-free parameter changes
- * - gin::ScratchBuffer: Temporary buffers from pool (no allocations!)
+ * - gin::ScratchBuffer: Temporary buffers from pool, for edits off the audio thread
+ *   (the pool locks and can grow, so per-block scratch is owned by the track)
  */
 class LoopTrack {
 public:
@@ -53,7 +55,9 @@ public:
     void startPlayback();
     void stopPlayback();
     void stop();
-    void clear();                                               // Clear loop
+    void clear();                                               // Clear loop and settings
+    void unload();                                              // Clear loop, keep settings
+    void resetSettings();                                       // Settings back to defaults
 
     // === DSP Controls (per Track)===
     void setVolumeDb(float volumeDb);
@@ -63,6 +67,9 @@ public:
     void setReverse(bool reverse);                              // REQUIRED FEATURE 2 from OSU project page
     void setSlip(int samples);                                  // REQUIRED FEATURE 3 from OSU project page
     void setLoopLength (int samples);
+    // Round-trip I/O latency, in samples: a take starts this much later in the input
+    // and runs this much past the stop, so it lines up with what was playing (any thread)
+    void setRecordLatency(int samples) noexcept;
 
     // === Loop Manipulation
     void multiplyLoop();                                        // double loop length
@@ -80,15 +87,40 @@ public:
     bool isSoloed() const noexcept { return soloState.load(); }
     bool isReversed() const noexcept { return reverseState.load(); }
     int getSlipOffset() const noexcept { return slipOffset.load(); }
+    int getRecordLatency() const noexcept { return recordLatencySamples.load(); }
     float getCurrentVolumeDb() const noexcept { return currentVolumeDb.load(); }
+    float getCurrentGain() const noexcept {
+        return juce::Decibels::decibelsToGain(currentVolumeDb.load(), TrackConfig::MIN_VOLUME_DB);
+    }
     float getCurrentPan() const noexcept { return currentPan.load(); }
     juce::String getStateString() const;
+    bool isIdle() const noexcept;                               // nothing to record, play, monitor or ring out
+
+    // === Insert effects (configure from any thread) ===
+    TrackFxChain& getFxChain() noexcept { return fxChain; }
+    const TrackFxChain& getFxChain() const noexcept { return fxChain; }
 
     // === Audio data access for FileHandler ===
+    // The getters read the player the audio thread last installed, never the one it is
+    // swapping: an installed player's audio doesn't change, and one swapped out is only
+    // freed on the message thread (LoopManager::reclaimRetiredPlayers()), so on that
+    // thread the buffer returned stays valid until the next reclaim.
     void setAudioBuffer(const juce::AudioSampleBuffer &newBuffer, double sourceSampleRate);
-    const juce::AudioSampleBuffer& getAudioBuffer() const { return player.getBuffer(); }
-    double getSourceSampleRate() const { return player.getSourceSampleRate(); }
-    bool hasAudio() const { return player.getBuffer().getNumSamples() > 0; }
+    const juce::AudioSampleBuffer& getAudioBuffer() const { return getInstalledPlayer().getBuffer(); }
+    double getSourceSampleRate() const { return getInstalledPlayer().getSourceSampleRate(); }
+    bool hasAudio() const { return getAudioBuffer().getNumSamples() > 0; }
+    // Changes whenever the audio is replaced or cleared; a save compares it to skip clean tracks
+    uint32_t getAudioGeneration() const noexcept { return audioGeneration.load(std::memory_order_acquire); }
+
+    // === Player handover (build off the audio thread, swap on it) ===
+    std::unique_ptr<gin::SamplePlayer> createPlayer() const;
+    std::unique_ptr<gin::SamplePlayer> createPlayer(const juce::AudioSampleBuffer& buffer,
+                                                    double sourceSampleRate) const;
+    std::unique_ptr<gin::SamplePlayer> swapPlayer(std::unique_ptr<gin::SamplePlayer> replacement) noexcept;
+    std::unique_ptr<gin::SamplePlayer> setPlayer(std::unique_ptr<gin::SamplePlayer> loadedPlayer);
+    void adoptAudioAsLoop(int downbeatOffset);                  // loaded audio becomes the loop
+    // The player a take or loop edit replaced on the audio thread, for LoopManager to retire
+    std::unique_ptr<gin::SamplePlayer> takeReplacedPlayer() noexcept { return std::move(replacedPlayer); }
 
 
     // === Sync info (for manager to read/write) ===
@@ -106,7 +138,10 @@ private:
     bool playerLoaded = false;
     gin::AudioFifo recordingBuffer;
     gin::AudioFifo undoBuffer;
-    gin::SamplePlayer player;
+    std::unique_ptr<gin::SamplePlayer> player;                  // swapped by pointer, never rebuilt on the audio thread
+    std::atomic<gin::SamplePlayer*> installedPlayer { nullptr };  // player, published for the message thread
+    std::unique_ptr<gin::SamplePlayer> replacedPlayer;          // left by loadRecordingToPlayer() until taken
+    juce::AudioBuffer<float> playerScratch;                     // sized in prepareToPlay, one block of player output
 
     // === States (atomic for thread safety) ===
     std::atomic<State> currentState {State::Empty };
@@ -117,31 +152,55 @@ private:
     // === Loop metadata ===
     std::atomic<int> loopLengthSamples {0 };                          // Current loop length measured by sample rate
     std::atomic<juce::int64> recordingStartGlobalSample { 0 };
+    std::atomic<uint32_t> audioGeneration { 0 };                      // bumped by every change to the player's audio
+
+    // === Latency compensation ===
+    std::atomic<int> recordLatencySamples { 0 };
+    int takeLatency = 0;                                        // latched when the take starts (audio thread)
+    int latencySkipRemaining = 0;                               // input still ahead of the take's first sample
+    int latencyTailRemaining = 0;                               // input still owed after the stop
 
 
     // === DSP ===
-    gin::EasedValueSmoother<float, gin::QuadraticOutEasing> volumeSmoother;
-    gin::EasedValueSmoother<float, gin::QuadraticOutEasing> panSmoother;
+    // Volume is a per-track trim in dB; MixerEngine folds it into its gain ramp
     std::atomic<float> currentVolumeDb { TrackConfig::DEFAULT_VOLUME_DB };
     std::atomic<float> currentPan { TrackConfig::DEFAULT_PAN };
     std::atomic<bool> muteState { false };
     std::atomic<bool> soloState { false };
     std::atomic<bool> reverseState { false };
     std::atomic<int> slipOffset { 0 };
+    TrackFxChain fxChain;                                       // post-playback/monitoring inserts
 
     // === Sample rate ===
     double sampleRate = 0.0;
 
+    // === Timeline (audio thread) ===
+    juce::uint32 timelineGeneration = 0;                        // last SyncEngine jump the player followed
+    bool realignPending = false;                                // the loop moved against the timeline
+
+    // === Layout-specialised processing (chosen in prepareToPlay) ===
+    using ProcessFn = void (LoopTrack::*)(const juce::AudioBuffer<float>&,
+                                          juce::AudioBuffer<float>&,
+                                          const SyncEngine&);
+    ProcessFn processForLayout = nullptr;
+    int preparedChannels = 0;
+
     // === Undo ===
     bool hasUndo = false;
     int undoLoopLength = 0;
 
     // === Private Helpers ===
+    template <int NumChannels>
+    void processBlockForLayout(const juce::AudioBuffer<float>& input,
+                               juce::AudioBuffer<float>& output,
+                               const SyncEngine& syncEngine);
     static void applyReverse(juce::AudioBuffer<float>& buffer);  // Helper for reverse
-    void applySlip(juce::AudioBuffer<float>& buffer);     // Helper for slip
-    void applyDspProcessing(juce::AudioBuffer<float>& buffer);
+    static void applySlip(juce::AudioBuffer<float>& buffer, int offset);     // Helper for slip
+    gin::SamplePlayer& getInstalledPlayer() const noexcept { return *installedPlayer.load(std::memory_order_acquire); }
+    void dropPlayerAudio();
     void saveUndo();
     void loadRecordingToPlayer();
+    void alignPlayerToTimeline(juce::int64 timelineSample);
 
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopTrack)
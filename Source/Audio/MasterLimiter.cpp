@@ -0,0 +1,208 @@
+#include "MasterLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+void MasterLimiter::prepare(double sampleRateIn, int maxBlockSizeIn, int numChannelsIn)
+{
+    sampleRate = sampleRateIn;
+    maxBlockSize = juce::jmax(1, maxBlockSizeIn);
+    numChannels = juce::jmax(0, numChannelsIn);
+
+    lookaheadSamples = sampleRate > 0.0
+        ? juce::jmax(1, static_cast<int>(std::ceil(TrackConfig::LIMITER_LOOKAHEAD_SECONDS * sampleRate)))
+        : 1;
+    latencySamples = lookaheadSamples + kInterpolatorDelay;
+
+    computeCoefficients();
+    setCeilingDb(TrackConfig::LIMITER_CEILING_DB);
+    setReleaseSeconds(releaseSeconds);
+
+    detectorBuffers.assign(static_cast<size_t>(numChannels),
+                           std::vector<float>(static_cast<size_t>(kTapsPerPhase - 1 + maxBlockSize), 0.0f));
+    delayBuffers.assign(static_cast<size_t>(numChannels),
+                        std::vector<float>(static_cast<size_t>(latencySamples + maxBlockSize), 0.0f));
+    peakScratch.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    phaseScratch.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    gainScratch.assign(static_cast<size_t>(maxBlockSize), 1.0f);
+
+    // hold window covers lookahead + 1 samples so both neighbours of an inter-sample peak are held
+    holdValues.assign(static_cast<size_t>(lookaheadSamples + 2), 1.0f);
+    holdPositions.assign(static_cast<size_t>(lookaheadSamples + 2), 0);
+    averageHistory.assign(static_cast<size_t>(lookaheadSamples), 1.0f);
+
+    reset();
+}
+
+void MasterLimiter::reset() noexcept
+{
+    for (auto& buffer : detectorBuffers)
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+    for (auto& buffer : delayBuffers)
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+
+    holdFront = 0;
+    holdCount = 0;
+    detectorPosition = 0;
+
+    std::fill(averageHistory.begin(), averageHistory.end(), 1.0f);
+    averageIndex = 0;
+    averageSum = static_cast<double>(averageHistory.size());
+    envelope = 1.0f;
+}
+
+void MasterLimiter::setCeilingDb(float ceilingDb) noexcept
+{
+    ceilingGain = juce::Decibels::decibelsToGain(juce::jmin(0.0f, ceilingDb));
+}
+
+void MasterLimiter::setReleaseSeconds(double seconds) noexcept
+{
+    releaseSeconds = juce::jmax(0.001, seconds);
+    releaseCoeff = sampleRate > 0.0
+        ? static_cast<float>(std::exp(-1.0 / (releaseSeconds * sampleRate)))
+        : 0.0f;
+}
+
+/**
+ * Windowed-sinc polyphase interpolator. Phase p estimates the signal at
+ * (n - kInterpolatorDelay - p / kOversampling); phase 0 is an exact delay.
+ */
+void MasterLimiter::computeCoefficients() noexcept
+{
+    constexpr double halfSpan = kTapsPerPhase / 2.0;
+
+    for (int phase = 0; phase < kOversampling; ++phase)
+    {
+        const double centre = kInterpolatorDelay + static_cast<double>(phase) / kOversampling;
+        double sum = 0.0;
+
+        for (int tap = 0; tap < kTapsPerPhase; ++tap)
+        {
+            const double t = static_cast<double>(tap) - centre;
+            const double sinc = std::abs(t) < 1.0e-9
+                ? 1.0
+                : std::sin(juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+            const double window = std::abs(t) < halfSpan
+                ? 0.5 * (1.0 + std::cos(juce::MathConstants<double>::pi * t / halfSpan))
+                : 0.0;
+
+            phaseCoefficients[static_cast<size_t>(phase)][static_cast<size_t>(tap)] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+
+        // unity DC gain per phase
+        for (auto& coefficient : phaseCoefficients[static_cast<size_t>(phase)])
+            coefficient = static_cast<float>(coefficient / sum);
+    }
+}
+
+void MasterLimiter::process(juce::AudioBuffer<float>& buffer) noexcept
+{
+    if (numChannels == 0 || sampleRate <= 0.0)
+        return;
+
+    // hosts may send blocks larger than announced; never allocate here
+    const int totalSamples = buffer.getNumSamples();
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+        processChunk(buffer, start, juce::jmin(maxBlockSize, totalSamples - start));
+}
+
+void MasterLimiter::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    // 1. true-peak estimate per (delayed) sample, linked across channels
+    detectTruePeaks(buffer, startSample, numSamples);
+
+    // 2. gain envelope: required gain -> min-hold -> release -> moving average
+    const auto averageLength = static_cast<double>(averageHistory.size());
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float peak = peakScratch[static_cast<size_t>(i)];
+        const float required = peak > ceilingGain ? ceilingGain / peak : 1.0f;
+        const float held = pushHold(required);
+
+        // attack is instant here (the moving average shapes it); release is exponential
+        envelope = held < envelope ? held : held + releaseCoeff * (envelope - held);
+
+        auto& oldest = averageHistory[static_cast<size_t>(averageIndex)];
+        averageSum += static_cast<double>(envelope) - static_cast<double>(oldest);
+        oldest = envelope;
+        averageIndex = (averageIndex + 1) % static_cast<int>(averageHistory.size());
+
+        gainScratch[static_cast<size_t>(i)] = static_cast<float>(averageSum / averageLength);
+    }
+
+    // 3. delay the audio by the full latency and apply the gain
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        auto& delay = delayBuffers[static_cast<size_t>(ch)];
+        auto* data = buffer.getWritePointer(ch, startSample);
+
+        juce::FloatVectorOperations::copy(delay.data() + latencySamples, data, numSamples);
+        juce::FloatVectorOperations::multiply(data, delay.data(), gainScratch.data(), numSamples);
+        std::memmove(delay.data(), delay.data() + numSamples, static_cast<size_t>(latencySamples) * sizeof(float));
+    }
+}
+
+void MasterLimiter::detectTruePeaks(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    constexpr int historyLength = kTapsPerPhase - 1;
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+    juce::FloatVectorOperations::clear(peakScratch.data(), numSamples);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        auto& history = detectorBuffers[static_cast<size_t>(ch)];
+        juce::FloatVectorOperations::copy(history.data() + historyLength, buffer.getReadPointer(ch, startSample), numSamples);
+
+        for (const auto& coefficients : phaseCoefficients)
+        {
+            // FIR as one vector multiply-add per tap over the whole block
+            juce::FloatVectorOperations::clear(phaseScratch.data(), numSamples);
+            for (int tap = 0; tap < kTapsPerPhase; ++tap)
+                juce::FloatVectorOperations::addWithMultiply(phaseScratch.data(),
+                                                             history.data() + (historyLength - tap),
+                                                             coefficients[static_cast<size_t>(tap)],
+                                                             numSamples);
+
+            juce::FloatVectorOperations::abs(phaseScratch.data(), phaseScratch.data(), numSamples);
+            juce::FloatVectorOperations::max(peakScratch.data(), peakScratch.data(), phaseScratch.data(), numSamples);
+        }
+
+        std::memmove(history.data(), history.data() + numSamples, static_cast<size_t>(historyLength) * sizeof(float));
+    }
+}
+
+float MasterLimiter::pushHold(float requiredGain) noexcept
+{
+    const auto capacity = static_cast<int>(holdValues.size());
+    const juce::int64 windowLength = lookaheadSamples + 1;
+
+    // drop queued values that can never be the minimum again
+    while (holdCount > 0)
+    {
+        const int back = (holdFront + holdCount - 1) % capacity;
+        if (holdValues[static_cast<size_t>(back)] < requiredGain)
+            break;
+        --holdCount;
+    }
+
+    const int slot = (holdFront + holdCount) % capacity;
+    holdValues[static_cast<size_t>(slot)] = requiredGain;
+    holdPositions[static_cast<size_t>(slot)] = detectorPosition;
+    ++holdCount;
+
+    // drop values that have left the window
+    while (holdPositions[static_cast<size_t>(holdFront)] <= detectorPosition - windowLength)
+    {
+        holdFront = (holdFront + 1) % capacity;
+        --holdCount;
+    }
+
+    ++detectorPosition;
+    return holdValues[static_cast<size_t>(holdFront)];
+}
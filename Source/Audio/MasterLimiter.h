@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "../Utils/TrackConfig.h"
+
+/**
+ * Lookahead true-peak limiter for the master bus.
+ *
+ * - Peaks are detected on a 4x oversampled (polyphase FIR) estimate of the signal,
+ *   so inter-sample overs are caught, not just sample peaks.
+ * - The required gain is min-held across the lookahead window and then smoothed
+ *   with a moving average of the same length, so the gain is fully down by the
+ *   time a peak leaves the delay line. Release is exponential.
+ * - Detection and gain application use FloatVectorOperations; only the envelope
+ *   recursion runs per sample.
+ *
+ * The latency is fixed after prepare() and should be reported to the host.
+ */
+class MasterLimiter
+{
+public:
+    MasterLimiter() = default;
+
+    // Allocates all buffers. Message thread.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset() noexcept;
+
+    // Limits the buffer in place (delayed by getLatencySamples()). Audio thread.
+    void process(juce::AudioBuffer<float>& buffer) noexcept;
+
+    void setCeilingDb(float ceilingDb) noexcept;
+    void setReleaseSeconds(double seconds) noexcept;
+
+    int getLatencySamples() const noexcept { return latencySamples; }
+    float getCeilingGain() const noexcept { return ceilingGain; }
+
+private:
+    static constexpr int kOversampling = 4;
+    static constexpr int kTapsPerPhase = 8;
+    // Interpolated phases describe the signal this many samples in the past.
+    static constexpr int kInterpolatorDelay = kTapsPerPhase / 2 - 1;
+
+    std::array<std::array<float, kTapsPerPhase>, kOversampling> phaseCoefficients{};
+
+    double sampleRate = 0.0;
+    int maxBlockSize = 0;
+    int numChannels = 0;
+    int lookaheadSamples = 0;
+    int latencySamples = 0;
+
+    float ceilingGain = 1.0f;
+    double releaseSeconds = TrackConfig::LIMITER_RELEASE_SECONDS;
+    float releaseCoeff = 0.0f;
+
+    // Per channel: [interpolator history | block] and [audio delay | block].
+    std::vector<std::vector<float>> detectorBuffers;
+    std::vector<std::vector<float>> delayBuffers;
+    std::vector<float> peakScratch;
+    std::vector<float> phaseScratch;
+    std::vector<float> gainScratch;
+
+    // Sliding-window minimum over lookahead + 1 samples (monotonic deque on a ring).
+    std::vector<float> holdValues;
+    std::vector<juce::int64> holdPositions;
+    int holdFront = 0;
+    int holdCount = 0;
+    juce::int64 detectorPosition = 0;
+
+    // Moving-average attack smoothing over the lookahead window.
+    std::vector<float> averageHistory;
+    int averageIndex = 0;
+    double averageSum = 0.0;
+    float envelope = 1.0f;
+
+    void computeCoefficients() noexcept;
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+    void detectTruePeaks(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+    float pushHold(float requiredGain) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterLimiter)
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Fused copy -> gain -> pan -> sum kernel used by MixerEngine.
+ *
+ * The old mixer path cleared and copied each track into a working buffer,
+ * multiplied by the gain ramp, ran a juce::dsp::Panner and then summed into
+ * the master: four passes over memory per track. This kernel reads the track
+ * source once per output channel and accumulates the gained/panned samples
+ * directly into the master bus, handling loop wrap-around and mono->stereo.
+ */
+namespace MixKernel
+{
+    constexpr int kMaxOutputChannels = 2;
+    constexpr int kDynamicChannels = 0;     // layout read from the buffers at runtime
+
+    /** Linear gain ramp across one block (sample 0 = start, last sample = end). */
+    struct Ramp
+    {
+        float start = 1.0f;
+        float end = 1.0f;
+
+        bool isConstant() const noexcept { return start == end; }
+        bool isSilent() const noexcept { return start == 0.0f && end == 0.0f; }
+    };
+
+    using ChannelRamps = std::array<Ramp, kMaxOutputChannels>;
+
+    /** Same law as juce::dsp::PannerRule::squareRoot3dB (unity gain at centre). */
+    inline void computePanGains(float pan, float& leftGain, float& rightGain) noexcept
+    {
+        const float normalisedPan = 0.5f * (juce::jlimit(-1.0f, 1.0f, pan) + 1.0f);
+        leftGain  = std::sqrt(1.0f - normalisedPan) * juce::MathConstants<float>::sqrt2;
+        rightGain = std::sqrt(normalisedPan) * juce::MathConstants<float>::sqrt2;
+    }
+
+    inline void fillRamp(float* dest, const Ramp& ramp, int numSamples) noexcept
+    {
+        if (numSamples == 1)
+        {
+            dest[0] = ramp.end;
+            return;
+        }
+
+        const float step = (ramp.end - ramp.start) / static_cast<float>(numSamples - 1);
+        for (int sample = 0; sample < numSamples; ++sample)
+            dest[sample] = ramp.start + step * static_cast<float>(sample);
+    }
+
+    /** Per-sample increment of a ramp spread over numSamples. */
+    inline float rampStep(const Ramp& ramp, int numSamples) noexcept
+    {
+        return numSamples > 1 ? (ramp.end - ramp.start) / static_cast<float>(numSamples - 1) : 0.0f;
+    }
+
+    /**
+     * Mono source into a stereo master: each source sample is read once and
+     * written to both sides, with both ramps evaluated inline (no scratch).
+     * `rampOffset` is the position of src[0] within the block's ramp.
+     */
+    inline void accumulateMonoToStereo(const float* src, float* left, float* right, int count,
+                                       const Ramp& leftRamp, const Ramp& rightRamp,
+                                       int rampOffset, int numSamples) noexcept
+    {
+        const float leftStart = numSamples > 1 ? leftRamp.start : leftRamp.end;
+        const float rightStart = numSamples > 1 ? rightRamp.start : rightRamp.end;
+        const float leftStep = rampStep(leftRamp, numSamples);
+        const float rightStep = rampStep(rightRamp, numSamples);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const float position = static_cast<float>(rampOffset + i);
+            const float sample = src[i];
+            left[i]  += sample * (leftStart + leftStep * position);
+            right[i] += sample * (rightStart + rightStep * position);
+        }
+    }
+
+    /**
+     * Accumulates one looping track into the master bus.
+     * @tparam SourceChannels   Track channel count, or kDynamicChannels to read it at runtime
+     * @tparam OutputChannels   Master channel count, or kDynamicChannels to read it at runtime
+     * @param source            Track audio (mono or stereo), read as a loop
+     * @param master            Master bus, accumulated into (not cleared)
+     * @param numSamples        Samples to render this block
+     * @param blockStartSample  Global sample position used to align loop reads
+     * @param ramps             Per output channel gain ramp (fader * pan law)
+     * @param rampScratch       Scratch for at least numSamples floats
+     *
+     * Fixed layouts have compile-time channel loops the compiler can unroll and
+     * vectorise. Audio thread safe: no allocation, source is read once per output channel
+     * (once in total for mono -> stereo).
+     */
+    template <int SourceChannels, int OutputChannels>
+    inline void accumulateTrackForLayout(const juce::AudioBuffer<float>& source,
+                                         juce::AudioBuffer<float>& master,
+                                         int numSamples,
+                                         std::int64_t blockStartSample,
+                                         const ChannelRamps& ramps,
+                                         float* rampScratch) noexcept
+    {
+        static_assert(SourceChannels >= 0 && SourceChannels <= kMaxOutputChannels, "Unsupported track layout");
+        static_assert(OutputChannels >= 0 && OutputChannels <= kMaxOutputChannels, "Unsupported master layout");
+
+        const int sourceSamples = source.getNumSamples();
+        const int sourceChannels = SourceChannels != kDynamicChannels ? SourceChannels : source.getNumChannels();
+
+        if (sourceSamples <= 0 || sourceChannels <= 0 || numSamples <= 0)
+            return;
+
+        jassert(SourceChannels == kDynamicChannels || source.getNumChannels() == SourceChannels);
+        jassert(OutputChannels == kDynamicChannels || master.getNumChannels() == OutputChannels);
+
+        int sourceStart = 0;
+        if (sourceSamples >= numSamples)
+            sourceStart = static_cast<int>(blockStartSample % static_cast<std::int64_t>(sourceSamples));
+
+        // block2 is the wrapped part read from the start of the loop
+        const int block1 = juce::jmin(numSamples, sourceSamples - sourceStart);
+        const int block2 = juce::jmin(numSamples - block1, sourceSamples);
+
+        if constexpr (SourceChannels == 1 && OutputChannels == 2)
+        {
+            const float* src = source.getReadPointer(0);
+            float* left = master.getWritePointer(0);
+            float* right = master.getWritePointer(1);
+
+            accumulateMonoToStereo(src + sourceStart, left, right, block1, ramps[0], ramps[1], 0, numSamples);
+            if (block2 > 0)
+                accumulateMonoToStereo(src, left + block1, right + block1, block2, ramps[0], ramps[1], block1, numSamples);
+            return;
+        }
+
+        const int outputChannels = OutputChannels != kDynamicChannels
+                                       ? OutputChannels
+                                       : juce::jmin(master.getNumChannels(), kMaxOutputChannels);
+
+        for (int channel = 0; channel < outputChannels; ++channel)
+        {
+            const auto& ramp = ramps[static_cast<size_t>(channel)];
+            if (ramp.isSilent())
+                continue;
+
+            // replicate mono tracks across stereo so panning still works as expected.
+            int sourceChannel = channel;
+            if constexpr (SourceChannels == 1)
+                sourceChannel = 0;
+            else if constexpr (SourceChannels == kDynamicChannels)
+                sourceChannel = (sourceChannels == 1) ? 0 : juce::jmin(channel, sourceChannels - 1);
+
+            const float* src = source.getReadPointer(sourceChannel);
+            float* dest = master.getWritePointer(channel);
+
+            if (ramp.isConstant())
+            {
+                juce::FloatVectorOperations::addWithMultiply(dest, src + sourceStart, ramp.start, block1);
+                if (block2 > 0)
+                    juce::FloatVectorOperations::addWithMultiply(dest + block1, src, ramp.start, block2);
+            }
+            else
+            {
+                fillRamp(rampScratch, ramp, numSamples);
+                juce::FloatVectorOperations::addWithMultiply(dest, src + sourceStart, rampScratch, block1);
+                if (block2 > 0)
+                    juce::FloatVectorOperations::addWithMultiply(dest + block1, src, rampScratch + block1, block2);
+            }
+        }
+    }
+
+    /**
+     * Post-fader send: every source channel is summed into a mono bus with equal
+     * weight and one shared ramp (gain * send level). Same loop wrap as above.
+     */
+    inline void accumulateSend(const juce::AudioBuffer<float>& source,
+                               float* sendBus,
+                               int numSamples,
+                               std::int64_t blockStartSample,
+                               const Ramp& ramp,
+                               float* rampScratch) noexcept
+    {
+        const int sourceSamples = source.getNumSamples();
+        const int sourceChannels = source.getNumChannels();
+        if (sourceSamples <= 0 || sourceChannels <= 0 || numSamples <= 0 || ramp.isSilent())
+            return;
+
+        int sourceStart = 0;
+        if (sourceSamples >= numSamples)
+            sourceStart = static_cast<int>(blockStartSample % static_cast<std::int64_t>(sourceSamples));
+
+        const int block1 = juce::jmin(numSamples, sourceSamples - sourceStart);
+        const int block2 = juce::jmin(numSamples - block1, sourceSamples);
+
+        const float channelWeight = 1.0f / static_cast<float>(sourceChannels);
+        const Ramp weighted { ramp.start * channelWeight, ramp.end * channelWeight };
+        if (!weighted.isConstant())
+            fillRamp(rampScratch, weighted, numSamples);
+
+        for (int channel = 0; channel < sourceChannels; ++channel)
+        {
+            const float* src = source.getReadPointer(channel);
+            if (weighted.isConstant())
+            {
+                juce::FloatVectorOperations::addWithMultiply(sendBus, src + sourceStart, weighted.start, block1);
+                if (block2 > 0)
+                    juce::FloatVectorOperations::addWithMultiply(sendBus + block1, src, weighted.start, block2);
+            }
+            else
+            {
+                juce::FloatVectorOperations::addWithMultiply(sendBus, src + sourceStart, rampScratch, block1);
+                if (block2 > 0)
+                    juce::FloatVectorOperations::addWithMultiply(sendBus + block1, src, rampScratch + block1, block2);
+            }
+        }
+    }
+
+    using AccumulateFn = void (*)(const juce::AudioBuffer<float>&, juce::AudioBuffer<float>&,
+                                  int, std::int64_t, const ChannelRamps&, float*);
+
+    /** Runtime-layout version, used when a buffer doesn't match the prepared layout. */
+    inline void accumulateTrack(const juce::AudioBuffer<float>& source,
+                                juce::AudioBuffer<float>& master,
+                                int numSamples,
+                                std::int64_t blockStartSample,
+                                const ChannelRamps& ramps,
+                                float* rampScratch) noexcept
+    {
+        accumulateTrackForLayout<kDynamicChannels, kDynamicChannels>(source, master, numSamples,
+                                                                     blockStartSample, ramps, rampScratch);
+    }
+
+    /** Picks the specialisation for a layout. Call once when preparing, not per block. */
+    inline AccumulateFn selectAccumulator(int sourceChannels, int outputChannels) noexcept
+    {
+        if (outputChannels == 2)
+        {
+            if (sourceChannels == 2) return &accumulateTrackForLayout<2, 2>;
+            if (sourceChannels == 1) return &accumulateTrackForLayout<1, 2>;
+        }
+        else if (outputChannels == 1)
+        {
+            if (sourceChannels == 2) return &accumulateTrackForLayout<2, 1>;
+            if (sourceChannels == 1) return &accumulateTrackForLayout<1, 1>;
+        }
+        return &accumulateTrack;
+    }
+}
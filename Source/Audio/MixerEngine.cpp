@@ -1,25 +1,47 @@
 #include "MixerEngine.h"
 
+#include <algorithm>
+
 namespace
 {
-constexpr int kStereoChannels = 2;
 constexpr double kSmoothingSeconds = 0.01;
-constexpr float kClipMin = -1.0f;
-constexpr float kClipMax = 1.0f;
+constexpr double kPanSmoothingSeconds = 0.05; // matches juce::dsp::Panner
 }
 
-MixerEngine::MixerEngine()
+MixerEngine::MixerEngine(int numTracksIn)
+    : numTracks(static_cast<size_t>(TrackConfig::clampNumTracks(numTracksIn)))
 {
     // starting with safe defaults
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    parameterSnapshot.resize(numTracks);
+    attachedParams.assign(static_cast<size_t>(MixerParameterSnapshot::NumFields) * numTracks, nullptr);
+
+    trackTrimGains.assign(numTracks, 1.0f);
+    lastVolDb.assign(numTracks, 0.0f);
+    lastPan.assign(numTracks, 0.0f);
+
+    float centreLeft = 1.0f;
+    float centreRight = 1.0f;
+    MixKernel::computePanGains(0.0f, centreLeft, centreRight);
+
+    gainSmoothers.resize(numTracks, 1.0f);
+    panLeftSmoothers.resize(numTracks, centreLeft);
+    panRightSmoothers.resize(numTracks, centreRight);
+    sendSmoothers.resize(numTracks, 0.0f);
+
+    // everything goes straight to the master until routed elsewhere
+    editedRouting.trackDestination.assign(numTracks, TrackConfig::MASTER_BUS);
+    editedRouting.groupDestination.fill(TrackConfig::MASTER_BUS);
+    pendingSchedule = editedRouting;
+    liveSchedule = editedRouting;
+
+    for (size_t g = 0; g < groupGainTargets.size(); ++g)
     {
-        volParams[i] = nullptr;
-        panParams[i] = nullptr;
-        muteParams[i] = nullptr;
-        soloParams[i] = nullptr;
-        
-        volumeSmoothers[i].setCurrentAndTargetValue(1.0f);
+        groupGainTargets[g].store(1.0f, std::memory_order_relaxed);
+        groupPanTargets[g].store(0.0f, std::memory_order_relaxed);
     }
+    groupGainSmoothers.resize(groupGainTargets.size(), 1.0f);
+    groupPanLeftSmoothers.resize(groupGainTargets.size(), centreLeft);
+    groupPanRightSmoothers.resize(groupGainTargets.size(), centreRight);
 }
 
 MixerEngine::~MixerEngine()
@@ -27,29 +49,65 @@ MixerEngine::~MixerEngine()
     detachParameters();
 }
 
-void MixerEngine::prepare(double sampleRateIn, int samplesPerBlock)
+void MixerEngine::prepare(double sampleRateIn, int samplesPerBlock, int trackChannels, int outputChannels)
 {
     // setup for audio thread
     sampleRate = sampleRateIn;
     blockSize = samplesPerBlock;
     gainRampScratch.assign(static_cast<size_t>(juce::jmax(1, blockSize)), 1.0f);
+    sendBuffer.assign(static_cast<size_t>(juce::jmax(1, blockSize)), 0.0f);
+
+    // choose the mono/stereo specialisation once instead of branching per block
+    preparedTrackChannels = trackChannels;
+    preparedOutputChannels = outputChannels;
+    accumulator = MixKernel::selectAccumulator(trackChannels, outputChannels);
+    groupAccumulator = MixKernel::selectAccumulator(outputChannels, outputChannels);
 
-    juce::dsp::ProcessSpec spec{};
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
-    spec.numChannels = static_cast<juce::uint32>(kStereoChannels);
+    // releaseResources() prepares with a zero rate; the limiter keeps its last setup then
+    if (sampleRate > 0.0)
+    {
+        masterLimiter.prepare(sampleRate, juce::jmax(1, blockSize), outputChannels);
+        reverbBus.prepare(sampleRate);
 
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+        for (auto& fx : groupFx)
+            fx.prepare(sampleRate, juce::jmax(1, blockSize), outputChannels);
+    }
+    else
     {
-        volumeSmoothers[i].reset(sampleRate, kSmoothingSeconds); // ~10ms
-        volumeSmoothers[i].setCurrentAndTargetValue(1.0f);
-        panners[i].setRule(juce::dsp::PannerRule::squareRoot3dB);
-        panners[i].prepare(spec);
-        panners[i].setPan(0.0f);
-
-        trackWorkingBuffers[i].setSize(kStereoChannels, blockSize, false, false, true);
-        trackWorkingBuffers[i].clear();
+        reverbBus.releaseResources();
     }
+
+    float centreLeft = 1.0f;
+    float centreRight = 1.0f;
+    MixKernel::computePanGains(0.0f, centreLeft, centreRight);
+
+    gainSmoothers.reset(sampleRate, kSmoothingSeconds); // ~10ms
+    panLeftSmoothers.reset(sampleRate, kPanSmoothingSeconds);
+    panRightSmoothers.reset(sampleRate, kPanSmoothingSeconds);
+    sendSmoothers.reset(sampleRate, kSmoothingSeconds);
+
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        gainSmoothers.setCurrentAndTargetValue(i, 1.0f);
+        panLeftSmoothers.setCurrentAndTargetValue(i, centreLeft);
+        panRightSmoothers.setCurrentAndTargetValue(i, centreRight);
+        sendSmoothers.setCurrentAndTargetValue(i, 0.0f);
+    }
+
+    groupGainSmoothers.reset(sampleRate, kSmoothingSeconds);
+    groupPanLeftSmoothers.reset(sampleRate, kPanSmoothingSeconds);
+    groupPanRightSmoothers.reset(sampleRate, kPanSmoothingSeconds);
+
+    for (size_t g = 0; g < groupBuffers.size(); ++g)
+    {
+        groupBuffers[g].setSize(juce::jmax(1, outputChannels), juce::jmax(1, blockSize));
+        groupBuffers[g].clear();
+        groupPanLeftSmoothers.setCurrentAndTargetValue(g, centreLeft);
+        groupPanRightSmoothers.setCurrentAndTargetValue(g, centreRight);
+    }
+
+    // nothing has been output yet, so the first block can start at its target gains
+    snapGainsOnNextBlock = true;
 }
 
 void MixerEngine::attachParameters(juce::AudioProcessorValueTreeState& apvts)
@@ -57,23 +115,37 @@ void MixerEngine::attachParameters(juce::AudioProcessorValueTreeState& apvts)
     detachParameters();
     attachedApvts = &apvts;
 
+    static constexpr const char* fieldSuffixes[MixerParameterSnapshot::NumFields] = {
+        "Volume", "Pan", "Mute", "Solo", "Send"
+    };
+
+    slotForParameterIndex.assign(static_cast<size_t>(apvts.processor.getParameters().size()), -1);
+    parameterSnapshot.resetToDefaults();
+
     // hook APVTS params here (value names might change later, these are temporary)
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    for (size_t i = 0; i < numTracks; ++i)
     {
         auto idx = juce::String(i + 1);
         auto prefix = "Track" + idx + "_";
 
-        volParams[i]  = apvts.getRawParameterValue(prefix + "Volume");
-        panParams[i]  = apvts.getRawParameterValue(prefix + "Pan");
-        muteParams[i] = apvts.getRawParameterValue(prefix + "Mute");
-        soloParams[i] = apvts.getRawParameterValue(prefix + "Solo");
+        for (int f = 0; f < MixerParameterSnapshot::NumFields; ++f)
+        {
+            auto* param = apvts.getParameter(prefix + fieldSuffixes[f]);
+            if (param == nullptr)
+                continue;
 
-        apvts.addParameterListener(prefix + "Mute", this);
-        apvts.addParameterListener(prefix + "Solo", this);
+            const auto slot = static_cast<size_t>(f) * numTracks + i;
+            attachedParams[slot] = param;
 
-    }
+            const int parameterIndex = param->getParameterIndex();
+            if (juce::isPositiveAndBelow(parameterIndex, static_cast<int>(slotForParameterIndex.size())))
+                slotForParameterIndex[static_cast<size_t>(parameterIndex)] = static_cast<int>(slot);
 
-    refreshAnySoloStateFromParams();
+            parameterSnapshot.write(i, static_cast<MixerParameterSnapshot::Field>(f),
+                                    param->convertFrom0to1(param->getValue()));
+            param->addListener(this);
+        }
+    }
 }
 
 void MixerEngine::detachParameters()
@@ -81,14 +153,14 @@ void MixerEngine::detachParameters()
     if (attachedApvts == nullptr)
         return;
 
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    for (auto*& param : attachedParams)
     {
-        auto idx = juce::String(i + 1);
-        auto prefix = "Track" + idx + "_";
-        attachedApvts->removeParameterListener(prefix + "Mute", this);
-        attachedApvts->removeParameterListener(prefix + "Solo", this);
+        if (param != nullptr)
+            param->removeListener(this);
+        param = nullptr;
     }
 
+    slotForParameterIndex.clear();
     attachedApvts = nullptr;
 }
 
@@ -97,54 +169,175 @@ void MixerEngine::setGlobalSampleCounter(std::atomic<std::int64_t>* counter) noe
     globalSampleCounter = counter;
 }
 
-void MixerEngine::copyTrackIntoWorkingBuffer(size_t trackIndex,
-                                             const juce::AudioBuffer<float>* sourceTrack,
-                                             int numSamples,
-                                             std::int64_t blockStartSample)
+void MixerEngine::setTrackTrimGain(size_t track, float linearGain) noexcept
 {
-    auto& workingBuffer = trackWorkingBuffers[trackIndex];
-    if (workingBuffer.getNumSamples() != numSamples)
-        workingBuffer.setSize(kStereoChannels, numSamples, false, false, true);
+    if (track < numTracks)
+        trackTrimGains[track] = juce::jmax(0.0f, linearGain);
+}
 
-    workingBuffer.clear();
+void MixerEngine::setMasterLimiterEnabled(bool shouldBeEnabled) noexcept
+{
+    limiterEnabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
 
-    if (sourceTrack == nullptr)
-        return;
+int MixerEngine::getLatencySamples() const noexcept
+{
+    return limiterEnabled.load(std::memory_order_relaxed) ? masterLimiter.getLatencySamples() : 0;
+}
 
-    const int sourceSamples = sourceTrack->getNumSamples();
-    const int sourceChannels = sourceTrack->getNumChannels();
+void MixerEngine::loadReverbImpulseResponse(const juce::AudioBuffer<float>& impulseResponse, double irSampleRate)
+{
+    reverbBus.loadImpulseResponse(impulseResponse, irSampleRate);
+}
 
-    if (sourceSamples <= 0 || sourceChannels <= 0)
-        return;
+// === Group buses ===
 
-    const int channelsToCopy = juce::jmin(sourceChannels, workingBuffer.getNumChannels());
-    int sourceStart = 0;
+bool MixerEngine::setTrackOutput(size_t track, int destination)
+{
+    if (track >= numTracks || destination < TrackConfig::MASTER_BUS || destination >= TrackConfig::MAX_GROUP_BUSES)
+        return false;
 
-    if (sourceSamples >= numSamples)
-        sourceStart = static_cast<int>(blockStartSample % static_cast<std::int64_t>(sourceSamples));
+    editedRouting.trackDestination[track] = destination;
+    rescheduleRouting();
+    return true;
+}
 
-    const int block1 = juce::jmin(numSamples, sourceSamples - sourceStart);
-    const int block2 = numSamples - block1;
+bool MixerEngine::setGroupOutput(int group, int destination)
+{
+    if (group < 0 || group >= TrackConfig::MAX_GROUP_BUSES
+        || destination < TrackConfig::MASTER_BUS || destination >= TrackConfig::MAX_GROUP_BUSES)
+        return false;
 
-    for (int channel = 0; channel < channelsToCopy; ++channel)
+    // every group has one output, so a cycle means the destination chain leads back here
+    for (int next = destination; next != TrackConfig::MASTER_BUS;
+         next = editedRouting.groupDestination[static_cast<size_t>(next)])
     {
-        // replicate mono tracks across stereo so panning still works as expected.
-        const int sourceChannel = (sourceChannels == 1) ? 0 : channel;
-        auto* destData = workingBuffer.getWritePointer(channel);
+        if (next == group)
+            return false;
+    }
 
-        if (block1 > 0)
-        {
-            const auto* srcData = sourceTrack->getReadPointer(sourceChannel, sourceStart);
-            juce::FloatVectorOperations::copy(destData, srcData, block1);
-        }
+    editedRouting.groupDestination[static_cast<size_t>(group)] = destination;
+    rescheduleRouting();
+    return true;
+}
+
+int MixerEngine::getTrackOutput(size_t track) const noexcept
+{
+    return track < numTracks ? editedRouting.trackDestination[track] : TrackConfig::MASTER_BUS;
+}
+
+int MixerEngine::getGroupOutput(int group) const noexcept
+{
+    if (group < 0 || group >= TrackConfig::MAX_GROUP_BUSES)
+        return TrackConfig::MASTER_BUS;
+    return editedRouting.groupDestination[static_cast<size_t>(group)];
+}
 
-        if (block2 > 0)
+void MixerEngine::setGroupGain(int group, float linearGain) noexcept
+{
+    if (group >= 0 && group < TrackConfig::MAX_GROUP_BUSES)
+        groupGainTargets[static_cast<size_t>(group)].store(juce::jmax(0.0f, linearGain), std::memory_order_relaxed);
+}
+
+void MixerEngine::setGroupPan(int group, float pan) noexcept
+{
+    if (group >= 0 && group < TrackConfig::MAX_GROUP_BUSES)
+        groupPanTargets[static_cast<size_t>(group)].store(juce::jlimit(-1.0f, 1.0f, pan), std::memory_order_relaxed);
+}
+
+/**
+ * Orders the groups that can receive audio so each one runs after every group
+ * feeding it. Groups have a single output, so the graph is a forest rooted at
+ * the master and ordering by distance from the master (deepest first) is a
+ * topological order. Unreachable groups are left out and cost nothing per block.
+ */
+void MixerEngine::rescheduleRouting()
+{
+    constexpr int numGroups = TrackConfig::MAX_GROUP_BUSES;
+    std::array<bool, numGroups> used{};
+    std::array<int, numGroups> depth{};
+
+    for (const int destination : editedRouting.trackDestination)
+    {
+        for (int g = destination; g != TrackConfig::MASTER_BUS && !used[static_cast<size_t>(g)];
+             g = editedRouting.groupDestination[static_cast<size_t>(g)])
+            used[static_cast<size_t>(g)] = true;
+    }
+
+    int numScheduled = 0;
+    for (int g = 0; g < numGroups; ++g)
+    {
+        if (!used[static_cast<size_t>(g)])
+            continue;
+
+        for (int next = editedRouting.groupDestination[static_cast<size_t>(g)]; next != TrackConfig::MASTER_BUS;
+             next = editedRouting.groupDestination[static_cast<size_t>(next)])
+            ++depth[static_cast<size_t>(g)];
+
+        // insertion sort, deepest first, stable by group index
+        int position = numScheduled++;
+        while (position > 0 && depth[static_cast<size_t>(editedRouting.groupOrder[static_cast<size_t>(position - 1)])] < depth[static_cast<size_t>(g)])
         {
-            const int wrappedCopy = juce::jmin(block2, sourceSamples);
-            const auto* srcData = sourceTrack->getReadPointer(sourceChannel, 0);
-            juce::FloatVectorOperations::copy(destData + block1, srcData, wrappedCopy);
+            editedRouting.groupOrder[static_cast<size_t>(position)] = editedRouting.groupOrder[static_cast<size_t>(position - 1)];
+            --position;
         }
+        editedRouting.groupOrder[static_cast<size_t>(position)] = g;
     }
+    editedRouting.numScheduledGroups = numScheduled;
+
+    const juce::SpinLock::ScopedLockType lock(scheduleLock);
+    pendingSchedule = editedRouting;    // same sizes, so no reallocation
+    scheduleDirty.store(true, std::memory_order_release);
+}
+
+void MixerEngine::applyPendingSchedule() noexcept
+{
+    if (!scheduleDirty.load(std::memory_order_acquire))
+        return;
+
+    // if the message thread is mid-publish, keep the current schedule for one more block
+    const juce::SpinLock::ScopedTryLockType lock(scheduleLock);
+    if (!lock.isLocked())
+        return;
+
+    std::copy(pendingSchedule.trackDestination.begin(), pendingSchedule.trackDestination.end(),
+              liveSchedule.trackDestination.begin());
+    liveSchedule.groupDestination = pendingSchedule.groupDestination;
+    liveSchedule.groupOrder = pendingSchedule.groupOrder;
+    liveSchedule.numScheduledGroups = pendingSchedule.numScheduledGroups;
+    scheduleDirty.store(false, std::memory_order_relaxed);
+}
+
+float MixerEngine::computeTargetGain(size_t trackIndex, float faderGain, bool trackAudible) const noexcept
+{
+    // mute/solo is a gain of zero so it fades through the same ramp as the fader
+    if (!trackAudible)
+        return 0.0f;
+
+    return juce::jmax(0.0f, faderGain) * trackTrimGains[trackIndex];
+}
+
+MixKernel::ChannelRamps MixerEngine::computePanRamps(SmoothedValueBank& panLeft, SmoothedValueBank& panRight,
+                                                   size_t index, float startGain, float endGain,
+                                                   float pan, int numSamples) noexcept
+{
+    float leftTarget = 1.0f;
+    float rightTarget = 1.0f;
+    MixKernel::computePanGains(pan, leftTarget, rightTarget);
+
+    panLeft.setTargetValue(index, leftTarget);
+    panRight.setTargetValue(index, rightTarget);
+
+    const float leftStart = panLeft.getCurrentValue(index);
+    const float rightStart = panRight.getCurrentValue(index);
+    const float leftEnd = panLeft.skip(index, numSamples);
+    const float rightEnd = panRight.skip(index, numSamples);
+
+    // gain and pan ramps are both short and linear, so their product is ramped end to end
+    MixKernel::ChannelRamps ramps;
+    ramps[0] = { startGain * leftStart, endGain * leftEnd };
+    ramps[1] = { startGain * rightStart, endGain * rightEnd };
+    return ramps;
 }
 
 void MixerEngine::process(const std::vector<juce::AudioBuffer<float>*>& inputTracks,
@@ -153,146 +346,202 @@ void MixerEngine::process(const std::vector<juce::AudioBuffer<float>*>& inputTra
     if (masterOutput.getNumSamples() == 0)
         return;
 
+    // Scratch is sized in prepare(). The processor slices longer host blocks down to
+    // the prepared size, so these only grow for direct callers that skip that; in a
+    // guard build the allocation is reported if it ever happens on the audio thread.
     int numSamples = masterOutput.getNumSamples();
     if (static_cast<int>(gainRampScratch.size()) < numSamples)
         gainRampScratch.resize(static_cast<size_t>(numSamples), 1.0f);
+    if (static_cast<int>(sendBuffer.size()) < numSamples)
+        sendBuffer.resize(static_cast<size_t>(numSamples), 0.0f);
+
+    // routing changes were scheduled on the message thread; just pick up the result
+    applyPendingSchedule();
+    for (int n = 0; n < liveSchedule.numScheduledGroups; ++n)
+    {
+        const auto group = static_cast<size_t>(liveSchedule.groupOrder[static_cast<size_t>(n)]);
+        auto& groupBuffer = groupBuffers[group];
+        if (groupBuffer.getNumSamples() < numSamples)
+            groupBuffer.setSize(groupBuffer.getNumChannels(), numSamples, false, false, true);
+        groupBuffer.clear(0, numSamples);
+        groupReceivedAudio[group] = false;
+    }
 
     const std::int64_t blockStartSample = globalSampleCounter == nullptr
         ? 0
         : globalSampleCounter->load(std::memory_order_relaxed);
 
-    // master buffer is rebuilt every block by summing trackWorkingBuffers
+    // master buffer is rebuilt every block by accumulating each track into it
     masterOutput.clear();
-
-    const bool anySoloActive = isAnySoloActive();
-
-    // read params per block (audio thread), process each track, then sum into master
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    juce::FloatVectorOperations::clear(sendBuffer.data(), numSamples);
+    bool anySendActive = false;
+
+    // one snapshot per block (audio thread); nothing below touches the parameters themselves
+    parameterSnapshot.update();
+    const auto& params = parameterSnapshot.latest();
+    const float* volumes = params[MixerParameterSnapshot::Volume];
+    const float* pans = params[MixerParameterSnapshot::Pan];
+    const float* mutes = params[MixerParameterSnapshot::Mute];
+    const float* solos = params[MixerParameterSnapshot::Solo];
+    const float* sends = params[MixerParameterSnapshot::Send];
+
+    const bool anySoloActive = params.anySolo;
+    const bool masterMatchesLayout = masterOutput.getNumChannels() == preparedOutputChannels;
+
+    // accumulate each track into its destination bus
+    for (size_t i = 0; i < numTracks; ++i)
     {
-        float volValue = 1.0f;
-        float pan = 0.0f;
-
-        if (volParams[i] != nullptr)
-            volValue = volParams[i]->load();
-
-        if (panParams[i] != nullptr)
-            pan = panParams[i]->load();
+        const float volValue = volumes[i];
+        const float pan = pans[i];
 
         lastVolDb[i] = volValue;
         lastPan[i] = pan;
 
-        const bool trackMuted = muteParams[i] != nullptr && muteParams[i]->load() > 0.5f;
-        const bool trackSoloed = soloParams[i] != nullptr && soloParams[i]->load() > 0.5f;
+        const bool trackMuted = mutes[i] > 0.5f;
+        const bool trackSoloed = solos[i] > 0.5f;
         const bool trackAudible = anySoloActive ? trackSoloed : !trackMuted;
-        if (!trackAudible)
-            continue;
-
-        const juce::AudioBuffer<float>* sourceTrack =
-            i < inputTracks.size() ? inputTracks[i] : nullptr;
-        copyTrackIntoWorkingBuffer(i, sourceTrack, numSamples, blockStartSample);
 
-        // Per-track gain smoothing avoids zipper noise from rapid UI changes
-        volumeSmoothers[i].setTargetValue(volValue);
-        float startGain = volumeSmoothers[i].getCurrentValue();
-        volumeSmoothers[i].skip(numSamples);
-        float endGain = volumeSmoothers[i].getCurrentValue();
+        // Fader, track trim and mute/solo share one smoother so the
+        // block is scaled by a single ramp (avoids zipper noise and mute clicks)
+        const float targetGain = computeTargetGain(i, volValue, trackAudible);
+        if (snapGainsOnNextBlock)
+            gainSmoothers.setCurrentAndTargetValue(i, targetGain);
+        else
+            gainSmoothers.setTargetValue(i, targetGain);
 
-        auto& workingBuffer = trackWorkingBuffers[i];
+        const float startGain = gainSmoothers.getCurrentValue(i);
+        const float endGain = gainSmoothers.skip(i, numSamples);
 
-        if (startGain == endGain)
-        {
-            for (int ch = 0; ch < workingBuffer.getNumChannels(); ++ch)
-                juce::FloatVectorOperations::multiply(workingBuffer.getWritePointer(ch), startGain, numSamples);
-        }
+        // post-fader send level, smoothed separately so send moves don't touch the dry ramp
+        const float sendTarget = juce::jlimit(0.0f, 1.0f, sends[i]);
+        if (snapGainsOnNextBlock)
+            sendSmoothers.setCurrentAndTargetValue(i, sendTarget);
         else
-        {
-            if (numSamples == 1)
-            {
-                gainRampScratch[0] = endGain;
-            }
-            else
-            {
-                const float step = (endGain - startGain) / static_cast<float>(numSamples - 1);
-                float gain = startGain;
-                for (int sample = 0; sample < numSamples; ++sample)
-                {
-                    gainRampScratch[static_cast<size_t>(sample)] = gain;
-                    gain += step;
-                }
-            }
-
-            for (int ch = 0; ch < workingBuffer.getNumChannels(); ++ch)
-                juce::FloatVectorOperations::multiply(workingBuffer.getWritePointer(ch), gainRampScratch.data(), numSamples);
-        }
+            sendSmoothers.setTargetValue(i, sendTarget);
+        const float sendStart = sendSmoothers.getCurrentValue(i);
+        const float sendEnd = sendSmoothers.skip(i, numSamples);
+
+        // fully faded out (muted, not soloed, or fader down): nothing to add
+        if (startGain == 0.0f && endGain == 0.0f)
+            continue;
 
-        // JUCE DSP panner handles stereo panning per track
-        panners[i].setPan(juce::jlimit(-1.0f, 1.0f, pan));
-        juce::dsp::AudioBlock<float> block(workingBuffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        panners[i].process(context);
+        const juce::AudioBuffer<float>* sourceTrack =
+            i < inputTracks.size() ? inputTracks[i] : nullptr;
+        if (sourceTrack == nullptr)
+            continue;
 
-        const int channelsToSum = juce::jmin(masterOutput.getNumChannels(), workingBuffer.getNumChannels());
-        for (int channel = 0; channel < channelsToSum; ++channel)
+        // straight to the master, or into a group bus (always in the prepared layout)
+        const int destination = liveSchedule.trackDestination[i];
+        const bool toMaster = destination == TrackConfig::MASTER_BUS;
+        auto& destinationBus = toMaster ? masterOutput : groupBuffers[static_cast<size_t>(destination)];
+        if (!toMaster)
+            groupReceivedAudio[static_cast<size_t>(destination)] = true;
+
+        // one read of the source per channel: gain, pan and sum happen in the same pass
+        const auto ramps = computePanRamps(panLeftSmoothers, panRightSmoothers, i, startGain, endGain, pan, numSamples);
+        const auto accumulate = ((masterMatchesLayout || !toMaster) && sourceTrack->getNumChannels() == preparedTrackChannels)
+                                    ? accumulator
+                                    : &MixKernel::accumulateTrack;
+        accumulate(*sourceTrack, destinationBus, numSamples, blockStartSample, ramps, gainRampScratch.data());
+
+        const MixKernel::Ramp sendRamp { startGain * sendStart, endGain * sendEnd };
+        if (!sendRamp.isSilent())
         {
-            auto* masterData = masterOutput.getWritePointer(channel);
-            const auto* trackData = workingBuffer.getReadPointer(channel);
-            juce::FloatVectorOperations::addWithMultiply(masterData, trackData, 1.0f, numSamples);
+            MixKernel::accumulateSend(*sourceTrack, sendBuffer.data(), numSamples, blockStartSample,
+                                      sendRamp, gainRampScratch.data());
+            anySendActive = true;
         }
     }
 
-    // keep consistent headroom when multiple full-scale tracks are active
-    for (int channel = 0; channel < masterOutput.getNumChannels(); ++channel)
-        juce::FloatVectorOperations::multiply(masterOutput.getWritePointer(channel), masterHeadroomScale, numSamples);
+    // groups run in schedule order, so each is complete before it is summed onwards
+    mixGroups(masterOutput, numSamples);
+
+    // one shared reverb for every track, returned into the master before the limiter
+    reverbBus.processReturn(sendBuffer.data(), masterOutput, numSamples, !anySendActive);
+
+    snapGainsOnNextBlock = false;
+
+    // lookahead true-peak limiter keeps the master under the ceiling without clipping
+    if (limiterEnabled.load(std::memory_order_relaxed))
+        masterLimiter.process(masterOutput);
+}
+
+void MixerEngine::mixGroups(juce::AudioBuffer<float>& masterOutput, int numSamples) noexcept
+{
+    const bool masterMatchesLayout = masterOutput.getNumChannels() == preparedOutputChannels;
 
-    // simple safety limiter: hard clip at 0 dBFS
-    for (int channel = 0; channel < masterOutput.getNumChannels(); ++channel)
+    for (int n = 0; n < liveSchedule.numScheduledGroups; ++n)
     {
-        auto* data = masterOutput.getWritePointer(channel);
-        juce::FloatVectorOperations::clip(data, data, kClipMin, kClipMax, numSamples);
+        const auto group = static_cast<size_t>(liveSchedule.groupOrder[static_cast<size_t>(n)]);
+
+        const float targetGain = groupGainTargets[group].load(std::memory_order_relaxed);
+        if (snapGainsOnNextBlock)
+            groupGainSmoothers.setCurrentAndTargetValue(group, targetGain);
+        else
+            groupGainSmoothers.setTargetValue(group, targetGain);
+
+        const float startGain = groupGainSmoothers.getCurrentValue(group);
+        const float endGain = groupGainSmoothers.skip(group, numSamples);
+        const auto ramps = computePanRamps(groupPanLeftSmoothers, groupPanRightSmoothers, group, startGain, endGain,
+                                           groupPanTargets[group].load(std::memory_order_relaxed), numSamples);
+
+        // nothing routed in this block and no insert tail left: the group is silent
+        auto& fx = groupFx[group];
+        const bool receivedAudio = groupReceivedAudio[group];
+        if (!receivedAudio && !fx.hasTail())
+            continue;
+
+        // view of this block only; the bus may be longer than the block
+        juce::AudioBuffer<float> block(groupBuffers[group].getArrayOfWritePointers(),
+                                       groupBuffers[group].getNumChannels(), numSamples);
+        fx.process(block, !receivedAudio);
+
+        if (startGain == 0.0f && endGain == 0.0f)
+            continue;
+
+        const int destination = liveSchedule.groupDestination[group];
+        const bool toMaster = destination == TrackConfig::MASTER_BUS;
+        auto& destinationBus = toMaster ? masterOutput : groupBuffers[static_cast<size_t>(destination)];
+        if (!toMaster)
+            groupReceivedAudio[static_cast<size_t>(destination)] = true;
+
+        // the block view starts at sample 0, so read it from the start rather than as a loop
+        const auto accumulate = (masterMatchesLayout || !toMaster) ? groupAccumulator : &MixKernel::accumulateTrack;
+        accumulate(block, destinationBus, numSamples, 0, ramps, gainRampScratch.data());
     }
 }
 
 float MixerEngine::getLastVolDb(size_t track) const
 {
-    if (track >= TrackConfig::MAX_TRACKS)
+    if (track >= numTracks)
         return 0.0f;
     return lastVolDb[track];
 }
 
 float MixerEngine::getLastPan(size_t track) const
 {
-    if (track >= TrackConfig::MAX_TRACKS)
+    if (track >= numTracks)
         return 0.0f;
     return lastPan[track];
 }
 
-bool MixerEngine::isAnySoloActive() const
-{
-    return isAnyTrackSoloed.load(std::memory_order_relaxed);
-}
-
 bool MixerEngine::getIsAnyTrackSoloed() const noexcept
 {
-    return isAnyTrackSoloed.load(std::memory_order_relaxed);
+    return parameterSnapshot.isAnySoloActive();
 }
 
-void MixerEngine::parameterChanged(const juce::String& parameterID, float newValue)
+// Runs on whichever thread changed the parameter (message thread or host automation).
+void MixerEngine::parameterValueChanged(int parameterIndex, float newValue)
 {
-    juce::ignoreUnused(newValue);
-    if (parameterID.endsWith("_Solo") || parameterID.endsWith("_Mute"))
-        refreshAnySoloStateFromParams();
-}
+    if (!juce::isPositiveAndBelow(parameterIndex, static_cast<int>(slotForParameterIndex.size())))
+        return;
 
-void MixerEngine::refreshAnySoloStateFromParams() noexcept
-{
-    bool anySolo = false;
-    for (size_t i = 0; i < TrackConfig::MAX_TRACKS; ++i)
-    {
-        if (soloParams[i] != nullptr && soloParams[i]->load() > 0.5f)
-        {
-            anySolo = true;
-            break;
-        }
-    }
-    isAnyTrackSoloed.store(anySolo, std::memory_order_relaxed);
+    const int slot = slotForParameterIndex[static_cast<size_t>(parameterIndex)];
+    if (slot < 0)
+        return;
+
+    const auto slotIndex = static_cast<size_t>(slot);
+    parameterSnapshot.write(slotIndex % numTracks,
+                            static_cast<MixerParameterSnapshot::Field>(slotIndex / numTracks),
+                            attachedParams[slotIndex]->convertFrom0to1(newValue));
 }
@@ -9,19 +9,56 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include "ConvolutionReverbBus.h"
+#include "MasterLimiter.h"
+#include "MixKernel.h"
+#include "MixerParameterSnapshot.h"
+#include "SmoothedValueBank.h"
+#include "TrackFxChain.h"
 #include "../Utils/TrackConfig.h"
 
-class MixerEngine : private juce::AudioProcessorValueTreeState::Listener {
+class MixerEngine : private juce::AudioProcessorParameter::Listener {
 public:
-    static constexpr float kDefaultHeadroomScale = 0.25f;
-
-    MixerEngine();
+    // The track count is fixed for the engine's lifetime (set at project creation).
+    explicit MixerEngine(int numTracks = TrackConfig::DEFAULT_NUM_TRACKS);
     ~MixerEngine() override;
 
-    void prepare(double sampleRate, int samplesPerBlock);
+    size_t getNumTracks() const noexcept { return numTracks; }
+
+    // Channel counts pick the compile-time specialised mix kernel once, here.
+    void prepare(double sampleRate, int samplesPerBlock,
+                 int trackChannels = TrackConfig::DEFAULT_TRACK_CHANNELS,
+                 int outputChannels = MixKernel::kMaxOutputChannels);
     void attachParameters(juce::AudioProcessorValueTreeState& apvts);
     void detachParameters();
     void setGlobalSampleCounter(std::atomic<std::int64_t>* counter) noexcept;
+    // Per-track trim (linear) from LoopTrack, folded into the mixer gain ramp. Audio thread.
+    void setTrackTrimGain(size_t track, float linearGain) noexcept;
+    // Master true-peak limiter (on by default). Disabling it passes the raw sum through.
+    // This changes getLatencySamples(), which the owner must report to the host again.
+    void setMasterLimiterEnabled(bool shouldBeEnabled) noexcept;
+    // Latency added to the master bus, for AudioProcessor::setLatencySamples().
+    int getLatencySamples() const noexcept;
+    // The limiter's lookahead whether or not it is enabled: the most getLatencySamples() can be.
+    int getLimiterLatencySamples() const noexcept { return masterLimiter.getLatencySamples(); }
+    // Shared send reverb. Message thread; the bus starts with a generated default IR.
+    void loadReverbImpulseResponse(const juce::AudioBuffer<float>& impulseResponse, double sampleRate);
+    const ConvolutionReverbBus& getReverbBus() const noexcept { return reverbBus; }
+
+    // === Group buses ===
+    // Tracks and groups route to TrackConfig::MASTER_BUS or to a group index. Message
+    // thread: each change reschedules the graph once and the audio thread picks the
+    // new schedule up at the start of the next block.
+    bool setTrackOutput(size_t track, int destination);
+    bool setGroupOutput(int group, int destination);   // false if it is out of range or would make a cycle
+    int getTrackOutput(size_t track) const noexcept;
+    int getGroupOutput(int group) const noexcept;
+    // Group fader (linear) and pan, smoothed like the track ones. Any thread.
+    void setGroupGain(int group, float linearGain) noexcept;
+    void setGroupPan(int group, float pan) noexcept;
+    // Inserts on the group's summed signal, processed before its fader.
+    TrackFxChain& getGroupFxChain(int group) noexcept { return groupFx[static_cast<size_t>(group)]; }
+
     void process(const std::vector<juce::AudioBuffer<float>*>& inputTracks,
                  juce::AudioBuffer<float>& masterOutput);
     float getLastVolDb(size_t track) const;
@@ -29,38 +66,89 @@ public:
     bool getIsAnyTrackSoloed() const noexcept;
 
 private:
-    // APVTS parameter pointers (safe for audio-thread reads via atomic load).
-    std::array<std::atomic<float>*, TrackConfig::MAX_TRACKS> volParams{};
-    std::array<std::atomic<float>*, TrackConfig::MAX_TRACKS> panParams{};
-    std::array<std::atomic<float>*, TrackConfig::MAX_TRACKS> muteParams{};
-    std::array<std::atomic<float>*, TrackConfig::MAX_TRACKS> soloParams{};
-
-    // Per-track smoothing/history.
-    std::array<juce::LinearSmoothedValue<float>, TrackConfig::MAX_TRACKS> volumeSmoothers;
-    std::array<juce::dsp::Panner<float>, TrackConfig::MAX_TRACKS> panners;
-    std::array<float, TrackConfig::MAX_TRACKS> lastVolDb{};
-    std::array<float, TrackConfig::MAX_TRACKS> lastPan{};
-
-    // Scratch buffers used each block before summing into master.
-    std::array<juce::AudioBuffer<float>, TrackConfig::MAX_TRACKS> trackWorkingBuffers{};
+    const size_t numTracks;
+
+    // Per-track state is structure-of-arrays: each field is one contiguous run
+    // over all tracks, so the per-block pass reads memory linearly as tracks grow.
+    // Track parameters, published by the listeners and read once per block.
+    MixerParameterSnapshot parameterSnapshot;
+    // Attached parameters by slot (field * numTracks + track); nullptr when missing.
+    std::vector<juce::RangedAudioParameter*> attachedParams;
+    // Processor parameter index -> slot, so a change notification needs no string compare.
+    std::vector<int> slotForParameterIndex;
+
+    // Per-track smoothing/history. One smoother per track carries the combined
+    // fader * trim * mute/solo gain so the block gets a single ramp.
+    SmoothedValueBank gainSmoothers;
+    std::vector<float> trackTrimGains;
+    // Pan law gains (squareRoot3dB), smoothed like juce::dsp::Panner did.
+    SmoothedValueBank panLeftSmoothers;
+    SmoothedValueBank panRightSmoothers;
+    // Post-fader send level to the reverb bus.
+    SmoothedValueBank sendSmoothers;
+    std::vector<float> lastVolDb;
+    std::vector<float> lastPan;
+
+    // Routing graph. Edits happen on the message thread and are scheduled there
+    // (groups ordered so every source runs before its destination); the audio
+    // thread only ever copies a finished schedule.
+    struct RoutingSchedule
+    {
+        std::vector<int> trackDestination;
+        std::array<int, TrackConfig::MAX_GROUP_BUSES> groupDestination{};
+        std::array<int, TrackConfig::MAX_GROUP_BUSES> groupOrder{};    // groups that receive audio
+        int numScheduledGroups = 0;
+    };
+
+    RoutingSchedule editedRouting;      // message thread
+    RoutingSchedule pendingSchedule;    // guarded by scheduleLock
+    RoutingSchedule liveSchedule;       // audio thread
+    juce::SpinLock scheduleLock;        // audio thread only ever try-locks
+    std::atomic<bool> scheduleDirty{false};
+
+    // Group bus state, indexed by group.
+    std::array<juce::AudioBuffer<float>, TrackConfig::MAX_GROUP_BUSES> groupBuffers;
+    std::array<TrackFxChain, TrackConfig::MAX_GROUP_BUSES> groupFx;
+    std::array<std::atomic<float>, TrackConfig::MAX_GROUP_BUSES> groupGainTargets;
+    std::array<std::atomic<float>, TrackConfig::MAX_GROUP_BUSES> groupPanTargets;
+    SmoothedValueBank groupGainSmoothers;
+    SmoothedValueBank groupPanLeftSmoothers;
+    SmoothedValueBank groupPanRightSmoothers;
+    std::array<bool, TrackConfig::MAX_GROUP_BUSES> groupReceivedAudio{};
+
+    // Scratch for per-channel gain ramps used by the fused mix kernel.
     std::vector<float> gainRampScratch;
+    // Mono sum of the track sends, fed to the reverb bus.
+    std::vector<float> sendBuffer;
+    ConvolutionReverbBus reverbBus;
+
+    // Kernel specialised for the prepared track/master layout.
+    MixKernel::AccumulateFn accumulator = &MixKernel::accumulateTrack;
+    MixKernel::AccumulateFn groupAccumulator = &MixKernel::accumulateTrack;
+    int preparedTrackChannels = TrackConfig::DEFAULT_TRACK_CHANNELS;
+    int preparedOutputChannels = MixKernel::kMaxOutputChannels;
+
+    // Replaces the old fixed headroom scale + hard clip at 0 dBFS.
+    MasterLimiter masterLimiter;
+    std::atomic<bool> limiterEnabled{true};
 
     double sampleRate = 0.0;
     int blockSize = 0;
-    float masterHeadroomScale = kDefaultHeadroomScale;
-    std::atomic<bool> isAnyTrackSoloed{false};
+    bool snapGainsOnNextBlock = true;
 
     // Optional shared clock from SyncEngine/AudioProcessor.
     std::atomic<std::int64_t>* globalSampleCounter = nullptr;
     juce::AudioProcessorValueTreeState* attachedApvts = nullptr;
 
-    void copyTrackIntoWorkingBuffer(size_t trackIndex,
-                                    const juce::AudioBuffer<float>* sourceTrack,
-                                    int numSamples,
-                                    std::int64_t blockStartSample);
-    void parameterChanged(const juce::String& parameterID, float newValue) override;
-    void refreshAnySoloStateFromParams() noexcept;
-    bool isAnySoloActive() const;
+    float computeTargetGain(size_t trackIndex, float faderGain, bool trackAudible) const noexcept;
+    static MixKernel::ChannelRamps computePanRamps(SmoothedValueBank& panLeft, SmoothedValueBank& panRight,
+                                                   size_t index, float startGain, float endGain,
+                                                   float pan, int numSamples) noexcept;
+    void rescheduleRouting();
+    void applyPendingSchedule() noexcept;
+    void mixGroups(juce::AudioBuffer<float>& masterOutput, int numSamples) noexcept;
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerEngine)
 };
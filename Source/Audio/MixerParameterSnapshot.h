@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+/**
+ * The mixer's per-track parameters (volume, pan, mute, solo, send), published
+ * as one snapshot under a sequence lock.
+ *
+ * Writers are the parameter listeners: they may run on the message thread, on a
+ * host automation thread, or on the audio thread itself when the host applies
+ * automation inside process() (VST3 does). A write claims the sequence with a
+ * compare-and-swap from even to odd, stores its value and bumps it back to even.
+ * A writer that loses the race never waits for the other one: it parks its value
+ * in a pending slot, and whoever claims the sequence next (another write, or
+ * update() at the start of the next block) publishes it. The solo count is kept
+ * with it, so "is any track soloed" is part of the same snapshot instead of a
+ * separate scan.
+ *
+ * The audio thread calls update() once per block. When the sequence has not
+ * moved it costs one atomic load. Otherwise it copies the shared values into a
+ * private structure-of-arrays and checks that no write overlapped the copy; a
+ * torn copy is dropped and the previous snapshot is kept for one more block, so
+ * the reader never waits and never sees mute and solo from different moments.
+ *
+ * Shared storage is field-major with every field starting on its own cache
+ * line, so 64 tracks of one field fill four lines.
+ *
+ * resize() allocates; everything else is realtime safe.
+ */
+class MixerParameterSnapshot
+{
+public:
+    enum Field
+    {
+        Volume = 0,
+        Pan,
+        Mute,
+        Solo,
+        Send,
+        NumFields
+    };
+
+    // Audio-thread copy, one contiguous run per field.
+    struct Values
+    {
+        std::array<std::vector<float>, NumFields> fields;
+        bool anySolo = false;
+
+        const float* operator[](Field field) const noexcept { return fields[static_cast<size_t>(field)].data(); }
+    };
+
+    // Value each field holds until its parameter reports one (or when it is missing).
+    static constexpr float defaultValue(Field field) noexcept { return field == Volume ? 1.0f : 0.0f; }
+
+    void resize(size_t numTracksIn)
+    {
+        numTracks = numTracksIn;
+        fieldStride = (numTracks + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+        shared.reset(new Line[NumFields * fieldStride / kFloatsPerLine]);
+        pending.reset(new Line[NumFields * fieldStride / kFloatsPerLine]);
+
+        for (auto& values : live.fields)
+            values.resize(numTracks);
+        for (auto& values : staging.fields)
+            values.resize(numTracks);
+
+        resetToDefaults();
+    }
+
+    size_t size() const noexcept { return numTracks; }
+
+    // Puts every field back to its default and drops parked writes. Message thread, while
+    // no listener is attached; it may only have to wait for an update() to finish.
+    void resetToDefaults() noexcept
+    {
+        std::uint32_t sequenceBefore = 0;
+        while (!tryBeginWrite(sequenceBefore))
+            juce::Thread::yield();
+
+        hasPending.store(false, std::memory_order_relaxed);
+        for (int f = 0; f < NumFields; ++f)
+        {
+            const auto field = static_cast<Field>(f);
+            for (size_t track = 0; track < numTracks; ++track)
+            {
+                slot(field, track).store(defaultValue(field), std::memory_order_relaxed);
+                pendingSlot(field, track).store(kNoValue, std::memory_order_relaxed);
+            }
+        }
+        soloCount = 0;
+        anySolo.store(false, std::memory_order_relaxed);
+
+        endWrite(sequenceBefore);
+    }
+
+    // Publishes one denormalised parameter value. Any thread except the audio reader's own update().
+    // Returns false when another writer held the sequence: the value is parked and published by
+    // the next write or update() instead.
+    bool write(size_t track, Field field, float value) noexcept
+    {
+        if (track >= numTracks)
+            return true;
+
+        std::uint32_t sequenceBefore = 0;
+        if (!tryBeginWrite(sequenceBefore))
+        {
+            pendingSlot(field, track).store(value, std::memory_order_relaxed);
+            hasPending.store(true, std::memory_order_release);
+            return false;
+        }
+
+        // parked values are older than this one, so they go first
+        publishPending();
+        publish(field, track, value);
+
+        endWrite(sequenceBefore);
+        return true;
+    }
+
+    // Latest published solo state, for the UI. Any thread.
+    bool isAnySoloActive() const noexcept { return anySolo.load(std::memory_order_relaxed); }
+
+    // Audio thread, once per block: picks up the latest snapshot if a complete one is available.
+    // Returns true when the values changed.
+    bool update() noexcept
+    {
+        // a write that lost the race last block; if a writer holds the sequence now, next block
+        std::uint32_t claimed = 0;
+        if (hasPending.load(std::memory_order_acquire) && tryBeginWrite(claimed))
+        {
+            publishPending();
+            endWrite(claimed);
+        }
+
+        const auto sequenceBefore = sequence.load(std::memory_order_acquire);
+        if (sequenceBefore == lastReadSequence || (sequenceBefore & 1u) != 0)
+            return false;
+
+        for (int f = 0; f < NumFields; ++f)
+        {
+            const auto field = static_cast<Field>(f);
+            auto* destination = staging.fields[static_cast<size_t>(f)].data();
+            for (size_t track = 0; track < numTracks; ++track)
+                destination[track] = slot(field, track).load(std::memory_order_relaxed);
+        }
+        staging.anySolo = anySolo.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != sequenceBefore)
+            return false;
+
+        std::swap(live, staging);     // swaps vector storage only, never allocates
+        lastReadSequence = sequenceBefore;
+        return true;
+    }
+
+    // Snapshot taken by the last successful update(). Audio thread.
+    const Values& latest() const noexcept { return live; }
+
+private:
+    static constexpr size_t kFloatsPerLine = 16;
+    static constexpr float kNoValue = -std::numeric_limits<float>::infinity();    // empty pending slot
+
+    struct alignas(64) Line
+    {
+        std::array<std::atomic<float>, kFloatsPerLine> values;
+    };
+
+    size_t numTracks = 0;
+    size_t fieldStride = 0;
+    std::unique_ptr<Line[]> shared;
+    std::unique_ptr<Line[]> pending;     // values whose writer lost the race, kNoValue when empty
+
+    alignas(64) std::atomic<std::uint32_t> sequence{0};
+    std::atomic<bool> anySolo{false};
+    std::atomic<bool> hasPending{false};
+    int soloCount = 0;                   // only touched while the sequence is claimed
+
+    // Reader side; only the audio thread touches these.
+    alignas(64) std::uint32_t lastReadSequence = ~0u;
+    Values live;
+    Values staging;
+
+    std::atomic<float>& slot(Field field, size_t track) const noexcept
+    {
+        const size_t index = static_cast<size_t>(field) * fieldStride + track;
+        return shared[index / kFloatsPerLine].values[index % kFloatsPerLine];
+    }
+
+    std::atomic<float>& pendingSlot(Field field, size_t track) const noexcept
+    {
+        const size_t index = static_cast<size_t>(field) * fieldStride + track;
+        return pending[index / kFloatsPerLine].values[index % kFloatsPerLine];
+    }
+
+    // One attempt to take the sequence from even to odd; fails if another writer holds it.
+    bool tryBeginWrite(std::uint32_t& sequenceBefore) noexcept
+    {
+        sequenceBefore = sequence.load(std::memory_order_relaxed);
+        if ((sequenceBefore & 1u) != 0
+            || !sequence.compare_exchange_strong(sequenceBefore, sequenceBefore + 1,
+                                                 std::memory_order_acquire, std::memory_order_relaxed))
+            return false;
+
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    // With the sequence claimed.
+    void publish(Field field, size_t track, float value) noexcept
+    {
+        auto& target = slot(field, track);
+        if (field == Solo)
+        {
+            const bool wasSoloed = target.load(std::memory_order_relaxed) > 0.5f;
+            const bool isSoloed = value > 0.5f;
+            soloCount += static_cast<int>(isSoloed) - static_cast<int>(wasSoloed);
+            anySolo.store(soloCount > 0, std::memory_order_relaxed);
+        }
+        target.store(value, std::memory_order_relaxed);
+    }
+
+    // With the sequence claimed. The flag is cleared first, so a value parked during the
+    // scan either gets picked up by it or leaves the flag set for the next claim.
+    void publishPending() noexcept
+    {
+        if (!hasPending.exchange(false, std::memory_order_acquire))
+            return;
+
+        for (int f = 0; f < NumFields; ++f)
+        {
+            const auto field = static_cast<Field>(f);
+            for (size_t track = 0; track < numTracks; ++track)
+            {
+                const float value = pendingSlot(field, track).exchange(kNoValue, std::memory_order_relaxed);
+                if (value != kNoValue)
+                    publish(field, track, value);
+            }
+        }
+    }
+
+    void endWrite(std::uint32_t sequenceBefore) noexcept
+    {
+        sequence.store(sequenceBefore + 2, std::memory_order_release);
+    }
+};
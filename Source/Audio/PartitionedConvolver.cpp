@@ -0,0 +1,104 @@
+#include "PartitionedConvolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+void PartitionedConvolver::prepare(int blockSizeIn, const juce::AudioBuffer<float>& impulseResponse,
+                                   int segmentStart, int segmentLength)
+{
+    jassert(juce::isPowerOfTwo(blockSizeIn));
+
+    blockSize = blockSizeIn;
+    fftSize = blockSize * 2;
+    spectrumFloats = (blockSize + 1) * 2;
+
+    const int available = juce::jmax(0, impulseResponse.getNumSamples() - segmentStart);
+    const int length = juce::jlimit(0, available, segmentLength);
+    numPartitions = juce::jmax(1, (length + blockSize - 1) / blockSize);
+
+    fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(static_cast<double>(fftSize))));
+    inputWindow.assign(static_cast<size_t>(fftSize), 0.0f);
+    fftBuffer.assign(static_cast<size_t>(fftSize * 2), 0.0f);
+    inputSpectra.assign(static_cast<size_t>(numPartitions * spectrumFloats), 0.0f);
+
+    // IR partitions: blockSize samples, zero padded to fftSize, transformed once
+    irSpectra.assign(static_cast<size_t>(juce::jmax(1, impulseResponse.getNumChannels())),
+                     std::vector<float>(static_cast<size_t>(numPartitions * spectrumFloats), 0.0f));
+
+    for (int channel = 0; channel < impulseResponse.getNumChannels(); ++channel)
+    {
+        const float* ir = impulseResponse.getReadPointer(channel, juce::jmin(segmentStart, impulseResponse.getNumSamples()));
+        auto& spectra = irSpectra[static_cast<size_t>(channel)];
+
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            const int offset = partition * blockSize;
+            const int count = juce::jlimit(0, blockSize, length - offset);
+
+            std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+            if (count > 0)
+                juce::FloatVectorOperations::copy(fftBuffer.data(), ir + offset, count);
+
+            fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+            std::copy(fftBuffer.begin(), fftBuffer.begin() + spectrumFloats,
+                      spectra.begin() + partition * spectrumFloats);
+        }
+    }
+
+    reset();
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    std::fill(inputWindow.begin(), inputWindow.end(), 0.0f);
+    std::fill(inputSpectra.begin(), inputSpectra.end(), 0.0f);
+    fdlHead = 0;
+}
+
+void PartitionedConvolver::processBlock(const float* input, float* const* outputs) noexcept
+{
+    // slide the overlap-save window and transform it
+    juce::FloatVectorOperations::copy(inputWindow.data(), inputWindow.data() + blockSize, blockSize);
+    juce::FloatVectorOperations::copy(inputWindow.data() + blockSize, input, blockSize);
+
+    juce::FloatVectorOperations::copy(fftBuffer.data(), inputWindow.data(), fftSize);
+    juce::FloatVectorOperations::clear(fftBuffer.data() + fftSize, fftSize);
+    fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    // newest spectrum goes to the front of the frequency-domain delay line
+    fdlHead = (fdlHead + numPartitions - 1) % numPartitions;
+    juce::FloatVectorOperations::copy(inputSpectra.data() + fdlHead * spectrumFloats, fftBuffer.data(), spectrumFloats);
+
+    const int numBins = blockSize + 1;
+    for (size_t channel = 0; channel < irSpectra.size(); ++channel)
+    {
+        const auto& spectra = irSpectra[channel];
+        juce::FloatVectorOperations::clear(fftBuffer.data(), fftSize * 2);
+
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            const int slot = (fdlHead + partition) % numPartitions;
+            multiplyAccumulate(fftBuffer.data(),
+                               inputSpectra.data() + slot * spectrumFloats,
+                               spectra.data() + partition * spectrumFloats,
+                               numBins);
+        }
+
+        // the second half of the circular result is the valid (non-aliased) part
+        fft->performRealOnlyInverseTransform(fftBuffer.data());
+        juce::FloatVectorOperations::copy(outputs[channel], fftBuffer.data() + blockSize, blockSize);
+    }
+}
+
+void PartitionedConvolver::multiplyAccumulate(float* accumulator, const float* a, const float* b, int numBins) noexcept
+{
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float ar = a[2 * bin];
+        const float ai = a[2 * bin + 1];
+        const float br = b[2 * bin];
+        const float bi = b[2 * bin + 1];
+        accumulator[2 * bin]     += ar * br - ai * bi;
+        accumulator[2 * bin + 1] += ar * bi + ai * br;
+    }
+}
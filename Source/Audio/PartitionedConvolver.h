@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Uniformly partitioned overlap-save convolution of a mono input with one
+ * segment of a (mono or stereo) impulse response.
+ *
+ * The IR segment is split into blockSize partitions whose spectra are computed
+ * once in prepare(). Each processBlock() call consumes exactly blockSize input
+ * samples, pushes one spectrum into the frequency-domain delay line and
+ * produces blockSize output samples per IR channel. Output for an input block
+ * is available once that block is complete, i.e. blockSize samples of latency.
+ *
+ * ConvolutionReverbBus runs two of these: small partitions for the head on the
+ * audio thread and large partitions for the tail on a background thread.
+ */
+class PartitionedConvolver
+{
+public:
+    PartitionedConvolver() = default;
+
+    // Allocates everything. blockSize must be a power of two. Not realtime safe.
+    void prepare(int blockSize, const juce::AudioBuffer<float>& impulseResponse,
+                 int segmentStart, int segmentLength);
+    void reset() noexcept;
+
+    // Consumes getBlockSize() samples, writes getBlockSize() samples to each output channel.
+    void processBlock(const float* input, float* const* outputs) noexcept;
+
+    int getBlockSize() const noexcept { return blockSize; }
+    int getNumOutputChannels() const noexcept { return static_cast<int>(irSpectra.size()); }
+    int getNumPartitions() const noexcept { return numPartitions; }
+
+private:
+    int blockSize = 0;
+    int fftSize = 0;
+    int spectrumFloats = 0;     // interleaved re/im of the blockSize + 1 non-negative bins
+    int numPartitions = 0;
+    int fdlHead = 0;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> inputWindow;                 // [previous block | current block]
+    std::vector<float> fftBuffer;                   // 2 * fftSize, as juce::dsp::FFT requires
+    std::vector<float> inputSpectra;                // ring of numPartitions spectra
+    std::vector<std::vector<float>> irSpectra;      // per IR channel, numPartitions spectra
+
+    static void multiplyAccumulate(float* accumulator, const float* a, const float* b, int numBins) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
@@ -0,0 +1,192 @@
+#include "RealtimeWorkerPool.h"
+
+#include <thread>
+
+#include "../Utils/AudioThreadGuard.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+constexpr int kWorkerSleepMs = 1;
+
+inline void cpuRelax() noexcept
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #else
+    std::this_thread::yield();
+   #endif
+}
+
+constexpr std::uint64_t packRange(std::uint32_t generation, int next, int end) noexcept
+{
+    return (static_cast<std::uint64_t>(generation) << 32)
+         | (static_cast<std::uint64_t>(next & 0xffff) << 16)
+         | static_cast<std::uint64_t>(end & 0xffff);
+}
+
+constexpr std::uint32_t rangeGeneration(std::uint64_t state) noexcept { return static_cast<std::uint32_t>(state >> 32); }
+constexpr int rangeNext(std::uint64_t state) noexcept { return static_cast<int>((state >> 16) & 0xffff); }
+constexpr int rangeEnd(std::uint64_t state) noexcept { return static_cast<int>(state & 0xffff); }
+}
+
+class RealtimeWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(RealtimeWorkerPool& ownerIn, int participantIn)
+        : juce::Thread("Track Render " + juce::String(participantIn)),
+          owner(ownerIn),
+          participant(participantIn)
+    {
+    }
+
+    void run() override { owner.workerLoop(*this, participant); }
+
+private:
+    RealtimeWorkerPool& owner;
+    const int participant;
+};
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    stop();
+}
+
+void RealtimeWorkerPool::start(int numWorkers, double sampleRate, int samplesPerBlock)
+{
+    stop();
+
+    const int count = juce::jlimit(0, kMaxParticipants - 1, numWorkers);
+    numParticipants = count + 1;
+
+    // keep spinning for two block periods after a batch before dropping to sleeps
+    const double blockMicros = sampleRate > 0.0 && samplesPerBlock > 0
+        ? 1.0e6 * samplesPerBlock / sampleRate
+        : 1.0e4;
+    idleSpinMicros.store(static_cast<int>(2.0 * blockMicros), std::memory_order_relaxed);
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i + 1);
+
+        auto options = juce::Thread::RealtimeOptions{};
+        if (sampleRate > 0.0 && samplesPerBlock > 0)
+            options = options.withApproximateAudioProcessingTime(samplesPerBlock, sampleRate);
+
+        if (!worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+
+        workers.push_back(std::move(worker));
+    }
+}
+
+void RealtimeWorkerPool::stop()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+    numParticipants = 1;
+}
+
+void RealtimeWorkerPool::run(int numTasks, TaskFunction task, void* context) noexcept
+{
+    jassert(numTasks <= kMaxTasks);
+    numTasks = juce::jlimit(0, kMaxTasks, numTasks);
+    if (numTasks == 0)
+        return;
+
+    // Previous batch is complete here, so nobody reads these until the new generation is visible
+    currentTask = task;
+    currentContext = context;
+    remainingTasks.store(numTasks, std::memory_order_relaxed);
+
+    const std::uint32_t batch = generation.load(std::memory_order_relaxed) + 1;
+    for (int p = 0; p < numParticipants; ++p)
+    {
+        const int begin = numTasks * p / numParticipants;
+        const int end = numTasks * (p + 1) / numParticipants;
+        ranges[p].state.store(packRange(batch, begin, end), std::memory_order_relaxed);
+    }
+    generation.store(batch, std::memory_order_release);
+
+    const int ranHere = drain(batch, 0);
+
+    // Every task is claimed now; wait for the ones still running on workers
+    if (remainingTasks.fetch_sub(ranHere, std::memory_order_acq_rel) != ranHere)
+        while (remainingTasks.load(std::memory_order_acquire) != 0)
+            cpuRelax();
+}
+
+bool RealtimeWorkerPool::claim(TaskRange& range, std::uint32_t batchGeneration, int& taskIndex) noexcept
+{
+    auto state = range.state.load(std::memory_order_acquire);
+
+    while (rangeGeneration(state) == batchGeneration && rangeNext(state) < rangeEnd(state))
+    {
+        const int next = rangeNext(state);
+        if (range.state.compare_exchange_weak(state, packRange(batchGeneration, next + 1, rangeEnd(state)),
+                                              std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            taskIndex = next;
+            return true;
+        }
+    }
+    return false;
+}
+
+int RealtimeWorkerPool::drain(std::uint32_t batchGeneration, int participant) noexcept
+{
+    int ran = 0;
+    int taskIndex = 0;
+
+    // own range first (contiguous tracks stay on one core), then steal from the others
+    for (int offset = 0; offset < numParticipants; ++offset)
+    {
+        auto& range = ranges[(participant + offset) % numParticipants];
+        while (claim(range, batchGeneration, taskIndex))
+        {
+            currentTask(currentContext, taskIndex);
+            ++ran;
+        }
+    }
+    return ran;
+}
+
+void RealtimeWorkerPool::workerLoop(Worker& worker, int participant)
+{
+    // same float environment as the audio thread, so results match serial rendering bit for bit
+    juce::ScopedNoDenormals noDenormals;
+
+    std::uint32_t lastBatch = generation.load(std::memory_order_acquire);
+    auto lastWorkTicks = juce::Time::getHighResolutionTicks();
+
+    while (!worker.threadShouldExit())
+    {
+        const auto batch = generation.load(std::memory_order_acquire);
+        if (batch != lastBatch)
+        {
+            lastBatch = batch;
+
+            // tasks are audio-thread work and are held to the same contract
+            const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
+            const int ran = drain(batch, participant);
+            if (ran > 0)
+                remainingTasks.fetch_sub(ran, std::memory_order_acq_rel);
+
+            lastWorkTicks = juce::Time::getHighResolutionTicks();
+            continue;
+        }
+
+        const auto idleMicros = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - lastWorkTicks) * 1.0e6;
+        if (idleMicros < idleSpinMicros.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+        else
+            worker.wait(kWorkerSleepMs);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+/**
+ * Fixed set of pre-spawned threads that help the audio thread run a batch of
+ * independent tasks inside one callback.
+ *
+ * run() splits the tasks into one contiguous range per participant (the
+ * caller plus every worker). Each participant drains its own range, then steals
+ * from the others, so a worker that is asleep or descheduled only costs the
+ * work it has not claimed yet: the caller picks that up itself.
+ *
+ * Nothing on the caller's path locks, allocates or signals an OS primitive.
+ * Tasks are claimed with a CAS on a per-range word that carries the batch
+ * generation, so a worker running late can never claim a task from a newer
+ * batch. The only wait is at the end of run(), for tasks already claimed by a
+ * worker to finish.
+ *
+ * Workers spin (yielding) while batches keep arriving and fall back to short
+ * sleeps after two idle block periods, so an idle pool costs next to nothing.
+ */
+class RealtimeWorkerPool
+{
+public:
+    // Plain function pointer so a batch never allocates.
+    using TaskFunction = void (*)(void* context, int taskIndex);
+
+    RealtimeWorkerPool() = default;
+    ~RealtimeWorkerPool();
+
+    // Spawns numWorkers threads. Message thread, while the audio callback is stopped.
+    void start(int numWorkers, double sampleRate, int samplesPerBlock);
+    void stop();
+
+    int getNumWorkers() const noexcept { return static_cast<int>(workers.size()); }
+
+    // Runs task(context, i) for every i in [0, numTasks) and returns once all are done.
+    // Audio thread; the caller always takes part, so this works with no workers too.
+    void run(int numTasks, TaskFunction task, void* context) noexcept;
+
+private:
+    class Worker;
+
+    static constexpr int kMaxParticipants = 16;
+    static constexpr int kMaxTasks = 0xffff;
+
+    // One claimable range of task indices: [generation:32 | next:16 | end:16].
+    struct alignas(64) TaskRange
+    {
+        std::atomic<std::uint64_t> state { 0 };
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    TaskRange ranges[kMaxParticipants];
+    int numParticipants = 1;
+
+    // Published before generation is bumped; only read after a successful claim.
+    TaskFunction currentTask = nullptr;
+    void* currentContext = nullptr;
+
+    alignas(64) std::atomic<std::uint32_t> generation { 0 };
+    alignas(64) std::atomic<int> remainingTasks { 0 };
+
+    std::atomic<int> idleSpinMicros { 0 };
+
+    // Claims and runs tasks for the given batch; returns the number run.
+    int drain(std::uint32_t batchGeneration, int participant) noexcept;
+    bool claim(TaskRange& range, std::uint32_t batchGeneration, int& taskIndex) noexcept;
+    void workerLoop(Worker& worker, int participant);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeWorkerPool)
+};
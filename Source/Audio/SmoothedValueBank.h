@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * A bank of linear smoothers, one per track, stored as structure-of-arrays.
+ *
+ * Behaves like one juce::LinearSmoothedValue<float> per index, but current
+ * values, targets, steps and countdowns each live in their own contiguous
+ * array. MixerEngine walks every track once per block, so with 64 tracks the
+ * smoothing pass touches a few cache lines instead of 64 scattered objects.
+ *
+ * resize() allocates; everything else is realtime safe.
+ */
+class SmoothedValueBank
+{
+public:
+    void resize(size_t numValues, float initialValue)
+    {
+        current.assign(numValues, initialValue);
+        target.assign(numValues, initialValue);
+        step.assign(numValues, 0.0f);
+        countdown.assign(numValues, 0);
+    }
+
+    // Same meaning as LinearSmoothedValue::reset(sampleRate, rampLengthSeconds); stops any ramp.
+    void reset(double sampleRate, double rampLengthSeconds) noexcept
+    {
+        if (sampleRate > 0.0 && rampLengthSeconds > 0.0)
+            stepsToTarget = static_cast<int>(std::floor(rampLengthSeconds * sampleRate));
+
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            current[i] = target[i];
+            countdown[i] = 0;
+        }
+    }
+
+    size_t size() const noexcept { return current.size(); }
+
+    float getCurrentValue(size_t index) const noexcept { return current[index]; }
+    float getTargetValue(size_t index) const noexcept { return target[index]; }
+    bool isSmoothing(size_t index) const noexcept { return countdown[index] > 0; }
+
+    void setCurrentAndTargetValue(size_t index, float newValue) noexcept
+    {
+        current[index] = target[index] = newValue;
+        countdown[index] = 0;
+    }
+
+    void setTargetValue(size_t index, float newValue) noexcept
+    {
+        if (newValue == target[index])
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue(index, newValue);
+            return;
+        }
+
+        target[index] = newValue;
+        countdown[index] = stepsToTarget;
+        step[index] = (newValue - current[index]) / static_cast<float>(stepsToTarget);
+    }
+
+    // Advances one value by numSamples and returns the new current value.
+    float skip(size_t index, int numSamples) noexcept
+    {
+        if (numSamples >= countdown[index])
+        {
+            current[index] = target[index];
+            countdown[index] = 0;
+            return current[index];
+        }
+
+        current[index] += step[index] * static_cast<float>(numSamples);
+        countdown[index] -= numSamples;
+        return current[index];
+    }
+
+private:
+    std::vector<float> current;
+    std::vector<float> target;
+    std::vector<float> step;
+    std::vector<int> countdown;
+    int stepsToTarget = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread (e.g. message thread -> audio thread).
+ *
+ * A ring of Capacity slots with a read and a write index, each on its own
+ * cache line and each written by one side only. push() and pop() are wait
+ * free: one acquire load of the other side's index, one release store of their
+ * own. Elements are copied in and out, so keep them small and trivially
+ * copyable; hand large objects over by pointer.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are copied between threads without locks");
+
+public:
+    static constexpr size_t kCapacity = Capacity;
+
+    // Producer. False when the queue is full.
+    bool push(const T& item) noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        slots[write & kMask] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. False when the queue is empty.
+    bool pop(T& item) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        item = slots[read & kMask];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; a snapshot that may be stale by the time it is used.
+    size_t getNumReady() const noexcept
+    {
+        // read first: it can never pass a write index loaded after it
+        const auto read = readIndex.load(std::memory_order_acquire);
+        return writeIndex.load(std::memory_order_acquire) - read;
+    }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+
+    alignas(64) std::atomic<size_t> writeIndex { 0 };
+    alignas(64) std::atomic<size_t> readIndex { 0 };
+    alignas(64) std::array<T, Capacity> slots {};
+};
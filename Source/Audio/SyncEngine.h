@@ -4,12 +4,16 @@
 #pragma once
 #include "juce_audio_basics/juce_audio_basics.h"
 #include "atomic"
+#include "limits"
+#include "TempoMap.h"
 #include "../Utils/TrackConfig.h"
 
 
 /**
  * Global synchronization engine for all loop tracks
  * - Timing logic/data
+ * - Tempo/meter map: edited on the message thread, published to the audio thread
+ *   through a try-locked copy (same pattern as the mixer's routing schedule)
  */
 class SyncEngine {
 public:
@@ -19,12 +23,148 @@ public:
     void prepare(double sr, int /*samplesPerBlock*/) {
         sampleRate = sr;
         globalSample.store(0);
+        currentTicks.store(0);
+        blockStartSample = 0;
+        hostLooping = false;
+        loopWrapPending = false;
+
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        pendingMap.setSampleRate(sr);
+        liveMap = pendingMap;
+        lastLiveTempoSample = -1;
+        mapDirty.store(false);
     }
 
+    // Audio thread: picks up a pending map edit, then moves the clock on
+    // (unless a followed host is stopped). A host loop wrap reached by the
+    // previous call takes effect here, at the start of the next slice.
     void advance(int numSamples) {
-        globalSample.fetch_add(numSamples);
+        if (mapDirty.load(std::memory_order_acquire) && !hostSyncEnabled.load(std::memory_order_relaxed)) {
+            const juce::SpinLock::ScopedTryLockType lock(mapLock);
+            if (lock.isLocked()) {
+                applyPendingTempo();
+                liveMap = pendingMap;
+                mapDirty.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        if (loopWrapPending) {
+            loopWrapPending = false;
+            relocate(hostLoopStart);
+        }
+
+        blockStartSample = globalSample.load(std::memory_order_relaxed);
+        if (!transportRolling.load(std::memory_order_relaxed))
+            return;
+
+        const auto now = blockStartSample + numSamples;
+        globalSample.store(now);
+        currentTicks.store(liveMap.sampleToTicks(static_cast<double>(now)), std::memory_order_relaxed);
+
+        if (hostLooping && blockStartSample < hostLoopEnd && now >= hostLoopEnd)
+            loopWrapPending = true;
+    }
+
+    // === Host transport sync ===
+    // When enabled, syncToHost() locks position, tempo, meter and play state to the
+    // host each block; the tempo map edited here waits until it is switched off again.
+    void setHostSyncEnabled(bool shouldFollowHost) noexcept {
+        if (hostSyncEnabled.exchange(shouldFollowHost) == shouldFollowHost)
+            return;
+
+        if (!shouldFollowHost) {
+            transportRolling.store(true);
+
+            // hand the audio thread our own map back
+            const juce::SpinLock::ScopedLockType lock(mapLock);
+            mapDirty.store(true, std::memory_order_release);
+        }
     }
 
+    bool isHostSyncEnabled() const noexcept { return hostSyncEnabled.load(std::memory_order_relaxed); }
+
+    // False while a followed host is stopped: the clock holds and loops don't play
+    bool isTransportRolling() const noexcept { return transportRolling.load(std::memory_order_relaxed); }
+
+    // Audio thread, once per host block before any advance(). Each call re-anchors the
+    // live map at the host's position, so tempo ramps follow block by block without
+    // drift, and a jump in the host's sample position (relocation, loop wrap) moves
+    // the clock to it. Constant time: nothing here searches.
+    void syncToHost(const juce::AudioPlayHead::PositionInfo& info) noexcept {
+        if (!hostSyncEnabled.load(std::memory_order_relaxed))
+            return;
+
+        transportRolling.store(info.getIsPlaying(), std::memory_order_relaxed);
+
+        const auto hostSample = info.getTimeInSamples();
+        if (hostSample.hasValue()) {
+            loopWrapPending = false;
+            if (*hostSample != globalSample.load(std::memory_order_relaxed))
+                relocate(*hostSample);
+        }
+
+        const auto position = static_cast<double>(globalSample.load(std::memory_order_relaxed));
+        const auto bpm = info.getBpm();
+        if (bpm.hasValue() && *bpm > 0.0) {
+            const auto ppq = info.getPpqPosition();
+            const auto ticks = ppq.hasValue() ? TempoMap::beatsToTicks(*ppq) : liveMap.sampleToTicks(position);
+            liveMap.followTempo(position, ticks, *bpm);
+            tempoBPM.store(static_cast<float>(*bpm), std::memory_order_relaxed);
+        }
+
+        if (const auto signature = info.getTimeSignature()) {
+            const TempoMap::Meter meter { signature->numerator, signature->denominator };
+            if (liveMap.getMeterAtTick(0) != meter)
+                liveMap.setMeterAt(0, meter);
+        }
+
+        hostLooping = false;
+        if (const auto loop = info.getLoopPoints(); loop.hasValue() && info.getIsLooping()) {
+            hostLoopStart = static_cast<juce::int64>(std::llround(liveMap.ticksToSample(TempoMap::beatsToTicks(loop->ppqStart))));
+            hostLoopEnd = static_cast<juce::int64>(std::llround(liveMap.ticksToSample(TempoMap::beatsToTicks(loop->ppqEnd))));
+            hostLooping = hostLoopEnd > hostLoopStart;
+        }
+    }
+
+    // Audio thread: samples until the host's loop end, so the caller can split its
+    // block there and let the next advance() wrap (INT_MAX when not looping)
+    int getSamplesUntilLoopWrap() const noexcept {
+        const auto now = globalSample.load(std::memory_order_relaxed);
+        if (!hostLooping || loopWrapPending || now < hostLoopStart || now >= hostLoopEnd
+            || !transportRolling.load(std::memory_order_relaxed))
+            return std::numeric_limits<int>::max();
+
+        return static_cast<int>(std::min<juce::int64>(hostLoopEnd - now, std::numeric_limits<int>::max()));
+    }
+
+    // === Timeline (audio thread and render workers) ===
+    // Start of the block being rendered: advance() has already moved globalSample past it
+    juce::int64 getBlockStartSample() const noexcept { return blockStartSample; }
+
+    // Where the next advance() starts (after a pending host loop wrap)
+    juce::int64 getUpcomingSample() const noexcept {
+        return loopWrapPending ? hostLoopStart : globalSample.load(std::memory_order_relaxed);
+    }
+
+    // First beat / bar line at or after the given sample, on the live map
+    juce::int64 getNextBeatSample(juce::int64 fromSample) const noexcept {
+        const auto ticks = liveMap.sampleToTicks(static_cast<double>(fromSample));
+        const auto beat = ticks >= 0 ? (ticks + TempoMap::kTicksPerBeat - 1) / TempoMap::kTicksPerBeat
+                                     : ticks / TempoMap::kTicksPerBeat;
+        return firstSampleAtOrAfter(fromSample, (beat - 1) * TempoMap::kTicksPerBeat, beat * TempoMap::kTicksPerBeat);
+    }
+
+    juce::int64 getNextBarSample(juce::int64 fromSample) const noexcept {
+        const auto ticks = liveMap.sampleToTicks(static_cast<double>(fromSample));
+        const auto bar = liveMap.ticksToBar(ticks);
+        if (bar.tickInBar == 0)
+            return fromSample;
+        return firstSampleAtOrAfter(fromSample, liveMap.barToTicks(bar.bar), liveMap.barToTicks(bar.bar + 1));
+    }
+
+    // Bumped whenever the clock jumps; tracks compare it to re-phase their loops
+    juce::uint32 getTimelineGeneration() const noexcept { return timelineGeneration; }
+
     // === Thread-safe getters for UI ===
     juce::int64 getGlobalSample() const noexcept {
         return globalSample.load();
@@ -38,15 +178,76 @@ public:
         return sampleRate;
     }
 
+    // Musical position at the end of the last block, exact (fixed point, see TempoMap)
+    TempoMap::Ticks getCurrentTicks() const noexcept {
+        return currentTicks.load(std::memory_order_relaxed);
+    }
+
+    double getBeatPosition() const noexcept {
+        return TempoMap::ticksToBeats(getCurrentTicks());
+    }
+
     // === Tempo/BPM management ===
+    // Live tempo change: the audio thread inserts it at the position where it picks
+    // it up, so the beat position carries on from there and the past keeps its tempo.
     void setTempo(float bpm) noexcept {
+        if (!(bpm > 0.0f)) return;
         tempoBPM.store(bpm);
+
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        pendingTempo = bpm;
+        mapDirty.store(true, std::memory_order_release);
+    }
+
+    // A single tempo for the whole timeline (loading a project); drops tempo changes, keeps the meter.
+    void setConstantTempo(float bpm) noexcept {
+        tempoBPM.store(bpm);
+
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        pendingTempo = 0.0;
+        lastLiveTempoSample = -1;
+        pendingMap.setConstantTempo(bpm);
+        mapDirty.store(true, std::memory_order_release);
     }
 
+    // Tempo last set (or followed from the host)
     float getTempo() const noexcept {
         return tempoBPM.load();
     }
 
+    // === Tempo/meter map (message thread) ===
+    void setTempoMap(const TempoMap& newMap) noexcept {
+        tempoBPM.store(static_cast<float>(newMap.getTempoAtTick(0)));
+
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        pendingTempo = 0.0;
+        lastLiveTempoSample = -1;
+        pendingMap = newMap;
+        pendingMap.setSampleRate(sampleRate);
+        mapDirty.store(true, std::memory_order_release);
+    }
+
+    TempoMap getTempoMap() const noexcept {
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        return pendingMap;
+    }
+
+    // Time signature from the first bar; false if the meter is invalid
+    bool setTimeSignature(int numerator, int denominator) noexcept {
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        if (!pendingMap.setMeterAt(0, { numerator, denominator }))
+            return false;
+
+        mapDirty.store(true, std::memory_order_release);
+        return true;
+    }
+
+    TempoMap::Meter getTimeSignature() const noexcept {
+        const juce::SpinLock::ScopedLockType lock(mapLock);
+        return pendingMap.getMeterAtTick(0);
+    }
+
+    // Rounded, at the base tempo: for display and coarse sizing only
     int getSamplesPerBeat() const noexcept {
         float bpm = tempoBPM.load();
         if (bpm <= 0) return 0;
@@ -58,15 +259,110 @@ public:
         return static_cast<int>(std::round(samplesPerBeat));
     }
 
-    int getSamplesPerBar(int beatsPerBar = 4) const noexcept {
-        return static_cast<int>(getSamplesPerBeat() * beatsPerBar);
+    // Length of the first bar, in the current time signature
+    int getSamplesPerBar() const noexcept {
+        const auto meter = getTimeSignature();
+        return static_cast<int>(std::round(getSamplesPerBeat() * 4.0 * meter.numerator / meter.denominator));
+    }
+
+    // === Audio thread ===
+    // Smallest whole number of beats starting at startSample that covers minSamples,
+    // measured on the live map (so tempo changes inside the span count). 0 without a sample rate.
+    int getBeatAlignedLength(juce::int64 startSample, int minSamples) const noexcept {
+        if (minSamples <= 0 || liveMap.getSampleRate() <= 0.0)
+            return 0;
+
+        const auto start = static_cast<double>(startSample);
+        const auto startTick = liveMap.sampleToTicks(start);
+        const auto endTick = liveMap.sampleToTicks(start + minSamples);
+
+        // the tolerance absorbs the half-tick rounding at either end
+        const auto beats = std::max<juce::int64>(1, static_cast<juce::int64>(
+            std::ceil(TempoMap::ticksToBeats(endTick - startTick) - 1.0e-6)));
+        const auto end = liveMap.ticksToSample(startTick + beats * TempoMap::kTicksPerBeat);
+
+        return static_cast<int>(std::llround(end - liveMap.ticksToSample(startTick)));
     }
 
+    const TempoMap& getLiveTempoMap() const noexcept { return liveMap; }
+
 private:
+    // sampleToTicks rounds, so a position on the line may land a tick past it
+    juce::int64 firstSampleAtOrAfter(juce::int64 fromSample, TempoMap::Ticks previousLine, TempoMap::Ticks nextLine) const noexcept {
+        const auto previous = static_cast<juce::int64>(std::llround(liveMap.ticksToSample(previousLine)));
+        if (previous >= fromSample)
+            return previous;
+        return static_cast<juce::int64>(std::llround(liveMap.ticksToSample(nextLine)));
+    }
+
+    // Audio thread, under mapLock: a live tempo change starts at the current position.
+    // Changes in quick succession are one gesture (a slider drag) and add one segment,
+    // not one per block. A full map is re-anchored instead, which keeps the position but not the past.
+    void applyPendingTempo() noexcept {
+        if (pendingTempo <= 0.0)
+            return;
+
+        const auto nowSample = globalSample.load(std::memory_order_relaxed);
+        const auto now = static_cast<double>(nowSample);
+        TempoMap::Ticks position = 0;
+        if (nowSample == lastLiveTempoSample) {
+            // nothing has played since the last change: replace it on its own tick, which
+            // sampleToTicks() may round to a neighbour of
+            position = lastLiveTempoTick;
+        } else {
+            // the gesture so far becomes one segment at its average tempo
+            position = pendingMap.sampleToTicks(now);
+            const bool sameGesture = lastLiveTempoSample >= 0 && nowSample > lastLiveTempoSample
+                                  && static_cast<double>(nowSample - lastLiveTempoSample) < kLiveTempoGestureSeconds * sampleRate
+                                  && pendingMap.mergeTempoChanges(liveGestureStartTick, position);
+            if (!sameGesture)
+                liveGestureStartTick = position;
+        }
+
+        if (!pendingMap.setTempoAt(position, pendingTempo)) {
+            pendingMap.followTempo(now, position, pendingTempo);
+            liveGestureStartTick = position;
+        }
+        lastLiveTempoSample = nowSample;
+        lastLiveTempoTick = position;
+        pendingTempo = 0.0;
+    }
+
+    void relocate(juce::int64 newPosition) noexcept {
+        globalSample.store(newPosition);
+        currentTicks.store(liveMap.sampleToTicks(static_cast<double>(newPosition)), std::memory_order_relaxed);
+        ++timelineGeneration;
+    }
+
     std::atomic<juce::int64> globalSample { 0 };
     std::atomic<float> tempoBPM {TrackConfig::DEFAULT_BPM};         // 120.0f is the default BPM
+    std::atomic<TempoMap::Ticks> currentTicks { 0 };
     double sampleRate = 0.0;
 
+    // === Tempo map (message thread edits pendingMap, audio thread reads liveMap) ===
+    mutable juce::SpinLock mapLock;
+    TempoMap pendingMap;
+    TempoMap liveMap;
+    double pendingTempo = 0.0;          // live setTempo() not yet placed on the map; guarded by mapLock
+    // where the last live change was placed and its gesture began; -1 once the map is replaced (mapLock)
+    static constexpr double kLiveTempoGestureSeconds = 0.5;
+    juce::int64 lastLiveTempoSample = -1;
+    TempoMap::Ticks lastLiveTempoTick = 0;
+    TempoMap::Ticks liveGestureStartTick = 0;
+    std::atomic<bool> mapDirty { false };
+
+    // === Host sync ===
+    std::atomic<bool> hostSyncEnabled { false };
+    std::atomic<bool> transportRolling { true };
+
+    // audio thread only (render workers read them inside the block)
+    juce::int64 blockStartSample = 0;
+    juce::uint32 timelineGeneration = 0;
+    bool hostLooping = false;
+    bool loopWrapPending = false;
+    juce::int64 hostLoopStart = 0;
+    juce::int64 hostLoopEnd = 0;
+
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SyncEngine)
 };
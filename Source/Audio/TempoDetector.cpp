@@ -0,0 +1,318 @@
+#include "TempoDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <juce_dsp/juce_dsp.h>
+
+namespace
+{
+constexpr int kFftSize = 1 << TrackConfig::TEMPO_DETECT_FFT_ORDER;
+constexpr int kHop = TrackConfig::TEMPO_DETECT_HOP_SIZE;
+constexpr int kNumBins = kFftSize / 2 + 1;
+// log(1 + k|X|): keeps quiet onsets visible next to loud ones
+constexpr float kCompression = 100.0f;
+// Frames either side of the local mean the envelope is measured against
+constexpr int kMeanRadius = 8;
+// Width of the tempo weighting, in octaves either side of the preferred tempo
+constexpr double kPriorOctaves = 1.0;
+// A Hann frame's log energy jumps as an onset reaches its half-weight point, a
+// quarter frame before the centre: flux peaks that much ahead of the onset
+constexpr int kOnsetDelay = kFftSize / 4;
+// Loudness of a beat is measured over this many samples from its onset
+constexpr int kAccentWindow = kFftSize / 2;
+
+int wrapIndex(juce::int64 index, int length) noexcept
+{
+    auto wrapped = index % length;
+    return static_cast<int>(wrapped < 0 ? wrapped + length : wrapped);
+}
+}
+
+TempoDetector::TempoDetector()
+    : juce::Thread("Tempo Detection")
+{
+}
+
+TempoDetector::~TempoDetector()
+{
+    stopThread(2000);
+}
+
+void TempoDetector::requestAnalysis(int trackIndex, const juce::AudioBuffer<float>& audio, double sampleRate,
+                                    int beatsPerBar)
+{
+    auto job = std::make_unique<Job>();
+    job->trackIndex = trackIndex;
+    job->mono = mixToMono(audio);
+    job->sampleRate = sampleRate;
+    job->beatsPerBar = beatsPerBar;
+
+    {
+        const juce::ScopedLock lock(jobLock);
+        pendingJob = std::move(job);
+        busy.store(true, std::memory_order_release);
+    }
+
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::low);
+    notify();
+
+    // a job it replaced is freed here, on the message thread
+}
+
+bool TempoDetector::takeEstimate(Estimate& estimate)
+{
+    const juce::ScopedLock lock(jobLock);
+    if (!hasFinishedEstimate)
+        return false;
+
+    estimate = finishedEstimate;
+    hasFinishedEstimate = false;
+    return true;
+}
+
+void TempoDetector::run()
+{
+    while (!threadShouldExit())
+    {
+        std::unique_ptr<Job> job;
+        {
+            const juce::ScopedLock lock(jobLock);
+            std::swap(job, pendingJob);
+        }
+
+        if (job == nullptr)
+        {
+            wait(-1);
+            continue;
+        }
+
+        auto estimate = analyseMono(job->mono, job->sampleRate, job->beatsPerBar);
+        estimate.trackIndex = job->trackIndex;
+
+        const juce::ScopedLock lock(jobLock);
+        finishedEstimate = estimate;
+        hasFinishedEstimate = true;
+        busy.store(pendingJob != nullptr, std::memory_order_release);
+    }
+}
+
+TempoDetector::Estimate TempoDetector::analyse(const juce::AudioBuffer<float>& audio, double sampleRate, int beatsPerBar)
+{
+    return analyseMono(mixToMono(audio), sampleRate, beatsPerBar);
+}
+
+std::vector<float> TempoDetector::mixToMono(const juce::AudioBuffer<float>& audio)
+{
+    const int numChannels = audio.getNumChannels();
+    std::vector<float> mono(static_cast<size_t>(audio.getNumSamples()), 0.0f);
+    if (numChannels == 0)
+        return mono;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::add(mono.data(), audio.getReadPointer(channel), audio.getNumSamples());
+    juce::FloatVectorOperations::multiply(mono.data(), 1.0f / static_cast<float>(numChannels), audio.getNumSamples());
+    return mono;
+}
+
+TempoDetector::Estimate TempoDetector::analyseMono(const std::vector<float>& mono, double sampleRate, int beatsPerBar)
+{
+    Estimate estimate;
+    estimate.sourceSampleRate = sampleRate;
+    estimate.lengthSamples = static_cast<int>(mono.size());
+    if (sampleRate <= 0.0 || beatsPerBar <= 0)
+        return estimate;
+
+    const int totalLength = static_cast<int>(mono.size());
+    const int length = juce::jmin(totalLength, static_cast<int>(TrackConfig::TEMPO_DETECT_MAX_SECONDS * sampleRate));
+    const int numFrames = length / kHop;
+    const double frameRate = sampleRate / kHop;
+
+    // beat periods in frames, and at least two of the slowest beat to compare
+    const int minLag = juce::jmax(1, static_cast<int>(std::floor(60.0 * frameRate / TrackConfig::TEMPO_DETECT_MAX_BPM)));
+    const int maxLag = juce::jmin(numFrames / 2, static_cast<int>(std::ceil(60.0 * frameRate / TrackConfig::TEMPO_DETECT_MIN_BPM)));
+    if (maxLag <= minLag + 1)
+        return estimate;
+
+    // === 1. Onset envelope: spectral flux of log-magnitude frames ===
+    juce::dsp::FFT fft(TrackConfig::TEMPO_DETECT_FFT_ORDER);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(kFftSize),
+                                               juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> frame(static_cast<size_t>(2 * kFftSize));
+    std::vector<float> previous(static_cast<size_t>(kNumBins));
+    std::vector<float> current(static_cast<size_t>(kNumBins));
+    std::vector<float> flux(static_cast<size_t>(numFrames));
+
+    // the last frame goes first, so frame 0 is compared across the loop point
+    for (int f = -1; f < numFrames; ++f)
+    {
+        const auto centre = static_cast<juce::int64>(f < 0 ? numFrames - 1 : f) * kHop;
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        for (int n = 0; n < kFftSize; ++n)
+            frame[static_cast<size_t>(n)] = mono[static_cast<size_t>(wrapIndex(centre - kFftSize / 2 + n, length))];
+
+        window.multiplyWithWindowingTable(frame.data(), static_cast<size_t>(kFftSize));
+        fft.performFrequencyOnlyForwardTransform(frame.data());
+
+        float rise = 0.0f;
+        for (size_t bin = 0; bin < current.size(); ++bin)
+        {
+            current[bin] = std::log1p(kCompression * frame[bin]);
+            rise += juce::jmax(0.0f, current[bin] - previous[bin]);
+        }
+        if (f >= 0)
+            flux[static_cast<size_t>(f)] = rise;
+        std::swap(previous, current);
+    }
+
+    // only what stands out from its neighbourhood counts as an onset
+    std::vector<float> envelope(static_cast<size_t>(numFrames));
+    double envelopeMean = 0.0;
+    for (int i = 0; i < numFrames; ++i)
+    {
+        float localSum = 0.0f;
+        for (int k = -kMeanRadius; k <= kMeanRadius; ++k)
+            localSum += flux[static_cast<size_t>(wrapIndex(i + k, numFrames))];
+
+        const float onset = juce::jmax(0.0f, flux[static_cast<size_t>(i)] - localSum / (2 * kMeanRadius + 1));
+        envelope[static_cast<size_t>(i)] = onset;
+        envelopeMean += onset;
+    }
+    envelopeMean /= numFrames;
+
+    // === 2. Beat period: circular autocorrelation, weighted towards the preferred tempo ===
+    std::vector<double> centred(envelope.begin(), envelope.end());
+    for (auto& value : centred)
+        value -= envelopeMean;
+
+    const int lastLag = juce::jmin(numFrames - 1, 2 * maxLag + 1);
+    std::vector<double> correlation(static_cast<size_t>(lastLag + 1), 0.0);
+    for (int lag = 0; lag <= lastLag; ++lag)
+    {
+        if (lag != 0 && lag < minLag - 1)
+            continue;
+
+        double sum = 0.0;
+        for (int i = 0; i < numFrames; ++i)
+            sum += centred[static_cast<size_t>(i)] * centred[static_cast<size_t>(wrapIndex(i + lag, numFrames))];
+        correlation[static_cast<size_t>(lag)] = sum;
+    }
+
+    const double energy = correlation[0];
+    if (energy <= 0.0)
+        return estimate;            // silence, or nothing but a steady tone
+
+    int bestLag = 0;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag)
+    {
+        const double bpm = 60.0 * frameRate / lag;
+        const double octaves = std::log2(bpm / TrackConfig::TEMPO_DETECT_PREFERRED_BPM) / kPriorOctaves;
+        const double doubled = 2 * lag <= lastLag ? correlation[static_cast<size_t>(2 * lag)] : 0.0;
+        const double score = std::exp(-0.5 * octaves * octaves) * (correlation[static_cast<size_t>(lag)] + 0.5 * doubled);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0)
+        return estimate;
+
+    // the peak lies between frames; a parabola through its neighbours finds it
+    double period = bestLag;
+    if (bestLag > minLag && bestLag < maxLag)
+    {
+        const double before = correlation[static_cast<size_t>(bestLag - 1)];
+        const double peak = correlation[static_cast<size_t>(bestLag)];
+        const double after = correlation[static_cast<size_t>(bestLag + 1)];
+        const double curvature = before - 2.0 * peak + after;
+        if (curvature < 0.0)
+            period += juce::jlimit(-0.5, 0.5, 0.5 * (before - after) / curvature);
+    }
+
+    estimate.bpm = 60.0 * frameRate / period;
+    estimate.confidence = static_cast<float>(juce::jlimit(0.0, 1.0, correlation[static_cast<size_t>(bestLag)] / energy));
+
+    // === 3. Whole beats: a loop should hold an exact number of them, bars if it can ===
+    if (length == totalLength)
+    {
+        const double seconds = totalLength / sampleRate;
+        const double beats = seconds * estimate.bpm / 60.0;
+
+        auto fits = [&](int candidate)
+        {
+            return candidate > 0 && std::abs(beats / candidate - 1.0) <= TrackConfig::TEMPO_DETECT_SNAP_TOLERANCE;
+        };
+
+        const int wholeBars = juce::roundToInt(beats / beatsPerBar) * beatsPerBar;
+        const int wholeBeats = juce::roundToInt(beats);
+        const int fitted = fits(wholeBars) ? wholeBars : (fits(wholeBeats) ? wholeBeats : 0);
+        const double snappedBpm = fitted > 0 ? 60.0 * fitted / seconds : 0.0;
+
+        if (snappedBpm >= TrackConfig::BPM_GLOBAL_MIN && snappedBpm <= TrackConfig::BPM_GLOBAL_MAX)
+        {
+            estimate.bpm = snappedBpm;
+            estimate.beatsPerLoop = fitted;
+            period = 60.0 * frameRate / snappedBpm;
+        }
+    }
+
+    // === 4. Beat phase from the onsets, then the downbeat from the loudest beat of the bar ===
+    auto foldedStrength = [&](double start, double step)
+    {
+        double sum = 0.0;
+        int count = 0;
+        for (double position = start; position < numFrames - 0.5; position += step, ++count)
+            sum += envelope[static_cast<size_t>(wrapIndex(juce::roundToInt(position), numFrames))];
+        return count > 0 ? sum / count : 0.0;
+    };
+
+    double beatPhase = 0.0;
+    double strongest = -1.0;
+    for (int phase = 0; phase < static_cast<int>(std::ceil(period)); ++phase)
+    {
+        const double strength = foldedStrength(phase, period);
+        if (strength > strongest)
+        {
+            strongest = strength;
+            beatPhase = phase;
+        }
+    }
+
+    const double beatSamples = period * kHop;
+    const double firstBeat = beatPhase * kHop + kOnsetDelay;
+    auto accentEnergy = [&](double onset)
+    {
+        double sum = 0.0;
+        int bars = 0;
+        for (double position = onset; position < length; position += beatSamples * beatsPerBar, ++bars)
+        {
+            const auto from = static_cast<juce::int64>(position);
+            for (int n = 0; n < kAccentWindow; ++n)
+            {
+                const float sample = mono[static_cast<size_t>(wrapIndex(from + n, length))];
+                sum += sample * sample;
+            }
+        }
+        return bars > 0 ? sum / bars : 0.0;
+    };
+
+    double downbeat = firstBeat;
+    strongest = -1.0;
+    for (int beat = 0; beat < beatsPerBar; ++beat)
+    {
+        const double onset = firstBeat + beat * beatSamples;
+        const double strength = accentEnergy(onset);
+        if (strength > strongest)
+        {
+            strongest = strength;
+            downbeat = onset;
+        }
+    }
+
+    // the first one from the start of the audio
+    estimate.downbeatSample = wrapIndex(juce::roundToInt(std::fmod(downbeat, beatSamples * beatsPerBar)), totalLength);
+    return estimate;
+}
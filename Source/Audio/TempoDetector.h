@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include "../Utils/TrackConfig.h"
+
+/**
+ * Tempo and downbeat estimation for a recorded loop or an imported file.
+ *
+ * The audio is treated as one cycle of a loop. Its onset envelope is the
+ * spectral flux of log-magnitude FFT frames, each centred on its hop and read
+ * around the loop point, so the envelope wraps as cleanly as the loop does.
+ * The circular autocorrelation of that envelope, weighted towards
+ * TEMPO_DETECT_PREFERRED_BPM to settle octave ambiguity, gives the beat period.
+ * When the audio is within TEMPO_DETECT_SNAP_TOLERANCE of a whole number of
+ * beats (preferring whole bars), the tempo is snapped so it is exactly that many.
+ * The beat phase and the downbeat are where the envelope, folded at the beat
+ * and bar periods, is strongest.
+ *
+ * requestAnalysis() copies the audio and returns; a background thread does the
+ * work and takeEstimate() hands the result back. None of it runs on, or waits
+ * for, the audio thread.
+ */
+class TempoDetector : private juce::Thread
+{
+public:
+    struct Estimate
+    {
+        int trackIndex = TrackConfig::INVALID_TRACK_ID;
+        double bpm = 0.0;
+        float confidence = 0.0f;            // 0..1, how periodic the onsets are at that tempo
+        int beatsPerLoop = 0;               // whole beats the audio spans, 0 when it doesn't fit
+        int downbeatSample = 0;             // first downbeat from the start of the audio (source samples)
+        int lengthSamples = 0;              // source samples analysed
+        double sourceSampleRate = 0.0;
+
+        bool isValid() const noexcept { return bpm > 0.0; }
+        bool fitsWholeBeats() const noexcept { return beatsPerLoop > 0; }
+    };
+
+    TempoDetector();
+    ~TempoDetector() override;
+
+    // === Message thread ===
+    // Copies a mono mix of the audio and queues it; a request that hasn't started yet is replaced.
+    void requestAnalysis(int trackIndex, const juce::AudioBuffer<float>& audio, double sampleRate,
+                         int beatsPerBar = TrackConfig::DEFAULT_BEATS_PER_BAR);
+    // True once for every finished analysis.
+    bool takeEstimate(Estimate& estimate);
+    bool isBusy() const noexcept { return busy.load(std::memory_order_acquire); }
+
+    // The analysis itself, on the calling thread.
+    static Estimate analyse(const juce::AudioBuffer<float>& audio, double sampleRate,
+                            int beatsPerBar = TrackConfig::DEFAULT_BEATS_PER_BAR);
+
+private:
+    struct Job
+    {
+        int trackIndex = TrackConfig::INVALID_TRACK_ID;
+        std::vector<float> mono;
+        double sampleRate = 0.0;
+        int beatsPerBar = TrackConfig::DEFAULT_BEATS_PER_BAR;
+    };
+
+    juce::CriticalSection jobLock;              // message thread and analysis thread only
+    std::unique_ptr<Job> pendingJob;
+    Estimate finishedEstimate;
+    bool hasFinishedEstimate = false;
+    std::atomic<bool> busy { false };
+
+    static std::vector<float> mixToMono(const juce::AudioBuffer<float>& audio);
+    static Estimate analyseMono(const std::vector<float>& mono, double sampleRate, int beatsPerBar);
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TempoDetector)
+};
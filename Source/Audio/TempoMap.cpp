@@ -0,0 +1,270 @@
+#include "TempoMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr std::int64_t floorDivide(std::int64_t value, std::int64_t divisor) noexcept
+{
+    const auto quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+}
+
+TempoMap::TempoMap() noexcept : TempoMap(TrackConfig::DEFAULT_BPM) {}
+
+TempoMap::TempoMap(double bpm) noexcept : TempoMap(bpm, Meter{}) {}
+
+TempoMap::TempoMap(double bpm, Meter meter) noexcept
+{
+    reset(bpm, meter);
+}
+
+void TempoMap::setSampleRate(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 0.0;
+    rebuildTempoAnchors();
+}
+
+void TempoMap::reset(double bpm, Meter meter) noexcept
+{
+    numMeters = 1;
+    meters[0] = MeterSegment{ 0, 0, isValidMeter(meter) ? meter : Meter{} };
+    rebuildMeterAnchors();
+
+    setConstantTempo(bpm);
+}
+
+void TempoMap::setConstantTempo(double bpm) noexcept
+{
+    numTempos = 1;
+    tempos[0] = TempoSegment{};
+    tempos[0].bpm = (bpm > 0.0 && std::isfinite(bpm)) ? bpm : static_cast<double>(TrackConfig::DEFAULT_BPM);
+    rebuildTempoAnchors();
+}
+
+bool TempoMap::setTempoAt(Ticks position, double bpm) noexcept
+{
+    if (!(bpm > 0.0) || !std::isfinite(bpm))
+        return false;
+
+    position = std::max(tempos[0].startTick, position);
+
+    const int index = findTempoByTick(position);
+    if (tempos[static_cast<size_t>(index)].startTick == position)
+    {
+        tempos[static_cast<size_t>(index)].bpm = bpm;
+    }
+    else
+    {
+        if (numTempos == kMaxTempoChanges)
+            return false;
+
+        // the new segment goes straight after the one it splits
+        std::copy_backward(tempos.begin() + index + 1, tempos.begin() + numTempos, tempos.begin() + numTempos + 1);
+        auto& inserted = tempos[static_cast<size_t>(index + 1)];
+        inserted = TempoSegment{};
+        inserted.startTick = position;
+        inserted.bpm = bpm;
+        ++numTempos;
+    }
+
+    rebuildTempoAnchors();
+    return true;
+}
+
+bool TempoMap::mergeTempoChanges(Ticks from, Ticks to) noexcept
+{
+    const int first = findTempoByTick(from);
+    if (to <= from || tempos[static_cast<size_t>(first)].startTick != from || sampleRate <= 0.0)
+        return false;
+
+    // the segment `to` falls in now starts there; the ones before it go
+    const int last = findTempoByTick(to);
+    if (last == first)
+        return true;
+
+    const double span = ticksToSample(to) - tempos[static_cast<size_t>(first)].startSample;
+    tempos[static_cast<size_t>(last)].startTick = to;
+    std::copy(tempos.begin() + last, tempos.begin() + numTempos, tempos.begin() + first + 1);
+    numTempos -= last - first - 1;
+
+    tempos[static_cast<size_t>(first)].bpm = ticksToBeats(to - from) * 60.0 * sampleRate / span;
+    rebuildTempoAnchors();
+    return true;
+}
+
+bool TempoMap::followTempo(double samplePosition, Ticks position, double bpm) noexcept
+{
+    if (!(bpm > 0.0) || !std::isfinite(bpm))
+        return false;
+
+    numTempos = 1;
+    tempos[0] = TempoSegment{};
+    tempos[0].startTick = position;
+    tempos[0].startSample = samplePosition;
+    tempos[0].bpm = bpm;
+    rebuildTempoAnchors();
+    return true;
+}
+
+bool TempoMap::setMeterAt(std::int64_t bar, Meter meter) noexcept
+{
+    if (!isValidMeter(meter))
+        return false;
+
+    bar = std::max<std::int64_t>(0, bar);
+
+    const int index = findMeterByBar(bar);
+    if (meters[static_cast<size_t>(index)].startBar == bar)
+    {
+        meters[static_cast<size_t>(index)].meter = meter;
+    }
+    else
+    {
+        if (numMeters == kMaxMeterChanges)
+            return false;
+
+        std::copy_backward(meters.begin() + index + 1, meters.begin() + numMeters, meters.begin() + numMeters + 1);
+        meters[static_cast<size_t>(index + 1)] = MeterSegment{ 0, bar, meter };
+        ++numMeters;
+    }
+
+    rebuildMeterAnchors();
+    return true;
+}
+
+// === Queries ===
+
+TempoMap::Ticks TempoMap::sampleToTicks(double samplePosition) const noexcept
+{
+    const auto& segment = tempos[static_cast<size_t>(findTempoBySample(samplePosition))];
+    return segment.startTick + std::llround((samplePosition - segment.startSample) * segment.ticksPerSample);
+}
+
+double TempoMap::ticksToSample(Ticks position) const noexcept
+{
+    const auto& segment = tempos[static_cast<size_t>(findTempoByTick(position))];
+    return segment.startSample + static_cast<double>(position - segment.startTick) * segment.samplesPerTick;
+}
+
+double TempoMap::getTempoAtTick(Ticks position) const noexcept
+{
+    return tempos[static_cast<size_t>(findTempoByTick(position))].bpm;
+}
+
+double TempoMap::getTempoAtSample(double samplePosition) const noexcept
+{
+    return tempos[static_cast<size_t>(findTempoBySample(samplePosition))].bpm;
+}
+
+double TempoMap::getSamplesPerBeatAtSample(double samplePosition) const noexcept
+{
+    return tempos[static_cast<size_t>(findTempoBySample(samplePosition))].samplesPerTick * static_cast<double>(kTicksPerBeat);
+}
+
+TempoMap::Meter TempoMap::getMeterAtTick(Ticks position) const noexcept
+{
+    return meters[static_cast<size_t>(findMeterByTick(position))].meter;
+}
+
+TempoMap::BarPosition TempoMap::ticksToBar(Ticks position) const noexcept
+{
+    const auto& segment = meters[static_cast<size_t>(findMeterByTick(position))];
+    const Ticks ticksPerBar = getTicksPerBar(segment.meter);
+    const Ticks offset = position - segment.startTick;
+    const std::int64_t bars = floorDivide(offset, ticksPerBar);
+
+    BarPosition result;
+    result.bar = segment.startBar + bars;
+    result.tickInBar = offset - bars * ticksPerBar;
+    result.meter = segment.meter;
+    return result;
+}
+
+TempoMap::Ticks TempoMap::barToTicks(std::int64_t bar) const noexcept
+{
+    const auto& segment = meters[static_cast<size_t>(findMeterByBar(bar))];
+    return segment.startTick + (bar - segment.startBar) * getTicksPerBar(segment.meter);
+}
+
+bool TempoMap::isValidMeter(Meter meter) noexcept
+{
+    const bool powerOfTwo = meter.denominator > 0 && (meter.denominator & (meter.denominator - 1)) == 0;
+    return meter.numerator >= 1 && meter.numerator <= 64 && powerOfTwo && meter.denominator <= 64;
+}
+
+TempoMap::Ticks TempoMap::beatsToTicks(double beats) noexcept
+{
+    return std::llround(beats * static_cast<double>(kTicksPerBeat));
+}
+
+// === Anchors ===
+
+void TempoMap::rebuildTempoAnchors() noexcept
+{
+    // each anchor is placed from the previous one, once per edit, never per block;
+    // the first segment keeps its own (the timeline start, or a followed host position)
+    for (int i = 0; i < numTempos; ++i)
+    {
+        auto& segment = tempos[static_cast<size_t>(i)];
+        if (i > 0)
+        {
+            const auto& previous = tempos[static_cast<size_t>(i - 1)];
+            segment.startSample = previous.startSample
+                                + static_cast<double>(segment.startTick - previous.startTick) * previous.samplesPerTick;
+        }
+
+        const double ticksPerMinute = segment.bpm * static_cast<double>(kTicksPerBeat);
+        segment.samplesPerTick = sampleRate > 0.0 ? 60.0 * sampleRate / ticksPerMinute : 0.0;
+        segment.ticksPerSample = sampleRate > 0.0 ? ticksPerMinute / (60.0 * sampleRate) : 0.0;
+    }
+}
+
+void TempoMap::rebuildMeterAnchors() noexcept
+{
+    meters[0].startTick = 0;
+    meters[0].startBar = 0;
+
+    for (int i = 1; i < numMeters; ++i)
+    {
+        const auto& previous = meters[static_cast<size_t>(i - 1)];
+        auto& segment = meters[static_cast<size_t>(i)];
+        segment.startTick = previous.startTick + (segment.startBar - previous.startBar) * getTicksPerBar(previous.meter);
+    }
+}
+
+// Each search returns the last segment starting at or before the position (the first one for earlier positions).
+
+int TempoMap::findTempoByTick(Ticks position) const noexcept
+{
+    const auto end = tempos.begin() + numTempos;
+    const auto it = std::upper_bound(tempos.begin() + 1, end, position,
+                                     [](Ticks value, const TempoSegment& segment) { return value < segment.startTick; });
+    return static_cast<int>(it - tempos.begin()) - 1;
+}
+
+int TempoMap::findTempoBySample(double samplePosition) const noexcept
+{
+    const auto end = tempos.begin() + numTempos;
+    const auto it = std::upper_bound(tempos.begin() + 1, end, samplePosition,
+                                     [](double value, const TempoSegment& segment) { return value < segment.startSample; });
+    return static_cast<int>(it - tempos.begin()) - 1;
+}
+
+int TempoMap::findMeterByTick(Ticks position) const noexcept
+{
+    const auto end = meters.begin() + numMeters;
+    const auto it = std::upper_bound(meters.begin() + 1, end, position,
+                                     [](Ticks value, const MeterSegment& segment) { return value < segment.startTick; });
+    return static_cast<int>(it - meters.begin()) - 1;
+}
+
+int TempoMap::findMeterByBar(std::int64_t bar) const noexcept
+{
+    const auto end = meters.begin() + numMeters;
+    const auto it = std::upper_bound(meters.begin() + 1, end, bar,
+                                     [](std::int64_t value, const MeterSegment& segment) { return value < segment.startBar; });
+    return static_cast<int>(it - meters.begin()) - 1;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "../Utils/TrackConfig.h"
+
+/**
+ * Tempo and meter map for the session timeline.
+ *
+ * Musical time is fixed point: one beat (a quarter note) is 2^32 ticks in an
+ * int64, so beat positions are exact integers for about two billion beats.
+ * Tempo is constant within a segment, and every segment stores the sample and
+ * tick where it starts. A conversion only scales the distance from the nearest
+ * anchor, so nothing accumulates block by block: a position six hours in is as
+ * exact as the first downbeat. Meter changes sit on bar lines and carry their
+ * starting bar and tick the same way.
+ *
+ * Lookups are binary searches over the anchors, O(log n). Storage has a fixed
+ * capacity, so copying a map to the audio thread never allocates.
+ */
+class TempoMap
+{
+public:
+    using Ticks = std::int64_t;
+
+    static constexpr int kFractionBits = 32;
+    static constexpr Ticks kTicksPerBeat = Ticks(1) << kFractionBits;
+    static constexpr int kMaxTempoChanges = 256;
+    static constexpr int kMaxMeterChanges = 64;
+
+    struct Meter
+    {
+        int numerator = TrackConfig::DEFAULT_BEATS_PER_BAR;
+        int denominator = TrackConfig::DEFAULT_BEAT_UNIT;
+
+        bool operator==(const Meter& other) const noexcept { return numerator == other.numerator && denominator == other.denominator; }
+        bool operator!=(const Meter& other) const noexcept { return !(*this == other); }
+    };
+
+    struct BarPosition
+    {
+        std::int64_t bar = 0;       // zero based
+        Ticks tickInBar = 0;
+        Meter meter;
+    };
+
+    TempoMap() noexcept;
+    explicit TempoMap(double bpm) noexcept;
+    TempoMap(double bpm, Meter meter) noexcept;
+
+    // === Editing (message thread) ===
+    // Sample anchors follow the rate; musical positions don't move.
+    void setSampleRate(double newSampleRate) noexcept;
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    // One tempo and one meter from the start.
+    void reset(double bpm, Meter meter) noexcept;
+    // Drops every tempo change and sets a single tempo; meter changes stay.
+    void setConstantTempo(double bpm) noexcept;
+    // Tempo from the given position onwards (replaces a change at the same tick;
+    // earlier positions move to the first segment). False if bpm is not positive or the map is full.
+    bool setTempoAt(Ticks position, double bpm) noexcept;
+    // One tempo through the given point, for following a host that owns the timeline
+    // (meter changes stay). False if bpm is not positive.
+    bool followTempo(double samplePosition, Ticks position, double bpm) noexcept;
+    // One tempo from `from` to `to`, the average of the changes it replaces, so the span
+    // covers the same samples and no position outside it moves. False unless a change
+    // starts at `from` and `to` is past it.
+    bool mergeTempoChanges(Ticks from, Ticks to) noexcept;
+    // Meter from the given bar onwards. False if the meter is invalid or the map is full.
+    bool setMeterAt(std::int64_t bar, Meter meter) noexcept;
+
+    int getNumTempoChanges() const noexcept { return numTempos; }
+    int getNumMeterChanges() const noexcept { return numMeters; }
+
+    // === Queries (realtime safe) ===
+    Ticks sampleToTicks(double samplePosition) const noexcept;
+    double ticksToSample(Ticks position) const noexcept;
+
+    double getTempoAtTick(Ticks position) const noexcept;
+    double getTempoAtSample(double samplePosition) const noexcept;
+    double getSamplesPerBeatAtSample(double samplePosition) const noexcept;
+
+    Meter getMeterAtTick(Ticks position) const noexcept;
+    BarPosition ticksToBar(Ticks position) const noexcept;
+    Ticks barToTicks(std::int64_t bar) const noexcept;
+
+    static Ticks getTicksPerBar(Meter meter) noexcept
+    {
+        // exact: the denominator is a power of two no larger than 4 * 2^32
+        return kTicksPerBeat * 4 / meter.denominator * meter.numerator;
+    }
+
+    static bool isValidMeter(Meter meter) noexcept;
+
+    static constexpr double ticksToBeats(Ticks position) noexcept
+    {
+        return static_cast<double>(position) / static_cast<double>(kTicksPerBeat);
+    }
+    static Ticks beatsToTicks(double beats) noexcept;
+
+private:
+    struct TempoSegment
+    {
+        Ticks startTick = 0;
+        double startSample = 0.0;
+        double bpm = TrackConfig::DEFAULT_BPM;
+        double samplesPerTick = 0.0;
+        double ticksPerSample = 0.0;
+    };
+
+    struct MeterSegment
+    {
+        Ticks startTick = 0;
+        std::int64_t startBar = 0;
+        Meter meter;
+    };
+
+    std::array<TempoSegment, kMaxTempoChanges> tempos{};
+    std::array<MeterSegment, kMaxMeterChanges> meters{};
+    int numTempos = 1;
+    int numMeters = 1;
+    double sampleRate = 0.0;
+
+    void rebuildTempoAnchors() noexcept;
+    void rebuildMeterAnchors() noexcept;
+
+    int findTempoByTick(Ticks position) const noexcept;
+    int findTempoBySample(double samplePosition) const noexcept;
+    int findMeterByTick(Ticks position) const noexcept;
+    int findMeterByBar(std::int64_t bar) const noexcept;
+};
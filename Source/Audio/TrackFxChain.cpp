@@ -0,0 +1,354 @@
+//
+// Per-track insert effect chain: filter -> EQ -> compressor -> delay.
+//
+
+#include "TrackFxChain.h"
+
+#include <cmath>
+
+namespace {
+    constexpr std::uint32_t kAllSlotsMask = (1u << TrackFxChain::kNumSlots) - 1u;
+    constexpr float kCpuSmoothing = 0.1f;               // EMA weight of the newest block
+    constexpr float kMaxDelayFeedback = 0.95f;
+    constexpr float kTailThreshold = 0.001f;            // -60 dB, where the delay tail counts as gone
+    constexpr int kMaxTailRepeats = 64;
+    constexpr double kDelayGlideSeconds = 0.05;
+    constexpr float kShelfQ = 0.7071f;
+}
+
+TrackFxChain::TrackFxChain() {
+    for (auto& micros : slotCpuMicros)
+        micros.store(0.0f);
+}
+
+/**
+ * Prepares every processor for the given layout, bypassed or not, so enabling
+ * a slot later never allocates.
+ * @param sampleRate - Current audio sample rate
+ * @param maxBlockSize - Largest block passed to the processors (bigger buffers are chunked)
+ * @param numChannels - Channels processed (extra buffer channels are left untouched)
+ */
+void TrackFxChain::prepare(double sr, int blockSize, int channels) {
+    isPrepared = false;
+    sampleRate = sr;
+    maxBlockSize = juce::jmax(1, blockSize);
+    numChannels = juce::jmax(1, channels);
+
+    if (sampleRate <= 0.0)
+        return;
+
+    const juce::dsp::ProcessSpec spec { sampleRate,
+                                        static_cast<juce::uint32>(maxBlockSize),
+                                        static_cast<juce::uint32>(numChannels) };
+
+    filter.prepare(spec);
+
+    for (auto& band : eqBands) {
+        // second-order placeholder; updateEq() overwrites it in place with the same order
+        band.state = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+        band.prepare(spec);
+    }
+
+    compressor.prepare(spec);
+    compressorMakeup.prepare(spec);
+    compressorMakeup.setRampDurationSeconds(0.01);
+
+    delayLine.setMaximumDelayInSamples(static_cast<int>(std::ceil(TrackConfig::FX_MAX_DELAY_SECONDS * sampleRate)) + 1);
+    delayLine.prepare(spec);
+    delaySamplesSmoother.reset(sampleRate, kDelayGlideSeconds);
+
+    isPrepared = true;
+    dirtyMask.store(0);
+    applyPendingChanges(kAllSlotsMask, true);
+    activeMask = enabledMask.load();
+    reset();
+}
+
+void TrackFxChain::reset() noexcept {
+    for (int slot = 0; slot < kNumSlots; ++slot)
+        resetSlot(static_cast<Slot>(slot));
+    tailSamplesRemaining.store(0, std::memory_order_relaxed);
+}
+
+// === Configuration ===
+
+void TrackFxChain::setSlotEnabled(Slot slot, bool enabled) noexcept {
+    if (enabled)
+        enabledMask.fetch_or(bitFor(slot), std::memory_order_release);
+    else
+        enabledMask.fetch_and(~bitFor(slot), std::memory_order_release);
+}
+
+bool TrackFxChain::isSlotEnabled(Slot slot) const noexcept {
+    return (enabledMask.load(std::memory_order_relaxed) & bitFor(slot)) != 0;
+}
+
+void TrackFxChain::setFilter(FilterType type, float cutoffHz, float resonance) noexcept {
+    filterType.store(static_cast<int>(type), std::memory_order_relaxed);
+    filterCutoffHz.store(cutoffHz, std::memory_order_relaxed);
+    filterResonance.store(resonance, std::memory_order_relaxed);
+    markDirty(Slot::Filter);
+}
+
+void TrackFxChain::setEq(float lowGainDb, float midFrequencyHz, float midGainDb, float midQ, float highGainDb) noexcept {
+    eqLowGainDb.store(lowGainDb, std::memory_order_relaxed);
+    eqMidFrequencyHz.store(midFrequencyHz, std::memory_order_relaxed);
+    eqMidGainDb.store(midGainDb, std::memory_order_relaxed);
+    eqMidQ.store(midQ, std::memory_order_relaxed);
+    eqHighGainDb.store(highGainDb, std::memory_order_relaxed);
+    markDirty(Slot::Eq);
+}
+
+void TrackFxChain::setCompressor(float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb) noexcept {
+    compThresholdDb.store(thresholdDb, std::memory_order_relaxed);
+    compRatio.store(ratio, std::memory_order_relaxed);
+    compAttackMs.store(attackMs, std::memory_order_relaxed);
+    compReleaseMs.store(releaseMs, std::memory_order_relaxed);
+    compMakeupDb.store(makeupDb, std::memory_order_relaxed);
+    markDirty(Slot::Compressor);
+}
+
+void TrackFxChain::setDelay(float timeMs, float feedback, float mix) noexcept {
+    delayTimeMs.store(timeMs, std::memory_order_relaxed);
+    delayFeedback.store(feedback, std::memory_order_relaxed);
+    delayMix.store(mix, std::memory_order_relaxed);
+    markDirty(Slot::Delay);
+}
+
+void TrackFxChain::markDirty(Slot slot) noexcept {
+    // release pairs with the audio thread's exchange, so it sees the values stored above
+    dirtyMask.fetch_or(bitFor(slot), std::memory_order_release);
+}
+
+// === Monitoring ===
+
+float TrackFxChain::getSlotCpuMicros(Slot slot) const noexcept {
+    return slotCpuMicros[static_cast<size_t>(slot)].load(std::memory_order_relaxed);
+}
+
+float TrackFxChain::getSlotCpuLoad(Slot slot) const noexcept {
+    const float budget = blockBudgetMicros.load(std::memory_order_relaxed);
+    return budget > 0.0f ? getSlotCpuMicros(slot) / budget : 0.0f;
+}
+
+void TrackFxChain::recordCpuTime(Slot slot, juce::int64 elapsedTicks) noexcept {
+    const auto micros = static_cast<float>(juce::Time::highResolutionTicksToSeconds(elapsedTicks) * 1.0e6);
+    auto& average = slotCpuMicros[static_cast<size_t>(slot)];
+    const float previous = average.load(std::memory_order_relaxed);
+    average.store(previous + kCpuSmoothing * (micros - previous), std::memory_order_relaxed);
+}
+
+// === Audio processing ===
+
+/**
+ * Runs the enabled slots in place on the first prepared channels of the buffer.
+ * Called on the real-time audio thread - no allocation, no locks.
+ */
+void TrackFxChain::process(juce::AudioBuffer<float>& buffer, bool inputIsSilent) noexcept {
+    if (!isPrepared)
+        return;
+
+    // Parameter changes first, so a slot coming out of bypass starts at its new settings
+    const std::uint32_t changed = dirtyMask.exchange(0, std::memory_order_acquire);
+    if (changed != 0)
+        applyPendingChanges(changed, false);
+
+    // Pick up enable/bypass changes; slots coming out of bypass start from clean state
+    const std::uint32_t mask = enabledMask.load(std::memory_order_acquire);
+    if (mask != activeMask) {
+        for (int slot = 0; slot < kNumSlots; ++slot) {
+            const auto bit = bitFor(static_cast<Slot>(slot));
+            if ((mask & bit) != 0 && (activeMask & bit) == 0)
+                resetSlot(static_cast<Slot>(slot));
+            if ((mask & bit) == 0)
+                slotCpuMicros[static_cast<size_t>(slot)].store(0.0f, std::memory_order_relaxed);
+        }
+        activeMask = mask;
+    }
+
+    // Fully bypassed: the buffer is never touched
+    if (activeMask == 0) {
+        tailSamplesRemaining.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    const int tailBefore = tailSamplesRemaining.load(std::memory_order_relaxed);
+    if (inputIsSilent && tailBefore <= 0)
+        return;
+
+    const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+    juce::dsp::AudioBlock<float> fullBlock(buffer);
+    auto channelBlock = fullBlock.getSubsetChannelBlock(0, static_cast<size_t>(channels));
+
+    std::array<juce::int64, kNumSlots> elapsedTicks {};
+
+    // hosts may send blocks larger than announced; the processors were prepared for maxBlockSize
+    for (int start = 0; start < numSamples; start += maxBlockSize) {
+        const int chunkSize = juce::jmin(maxBlockSize, numSamples - start);
+        auto block = channelBlock.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(chunkSize));
+
+        for (int slot = 0; slot < kNumSlots; ++slot) {
+            if ((activeMask & bitFor(static_cast<Slot>(slot))) == 0)
+                continue;
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            processSlot(static_cast<Slot>(slot), block);
+            elapsedTicks[static_cast<size_t>(slot)] += juce::Time::getHighResolutionTicks() - startTicks;
+        }
+    }
+
+    for (int slot = 0; slot < kNumSlots; ++slot) {
+        if ((activeMask & bitFor(static_cast<Slot>(slot))) != 0)
+            recordCpuTime(static_cast<Slot>(slot), elapsedTicks[static_cast<size_t>(slot)]);
+    }
+    blockBudgetMicros.store(static_cast<float>(numSamples * 1.0e6 / sampleRate), std::memory_order_relaxed);
+
+    // Live signal re-arms the tail; silence lets it run out
+    const int tailAfter = inputIsSilent ? juce::jmax(0, tailBefore - numSamples) : computeTailSamples();
+    tailSamplesRemaining.store(tailAfter, std::memory_order_relaxed);
+}
+
+void TrackFxChain::processSlot(Slot slot, juce::dsp::AudioBlock<float>& block) noexcept {
+    juce::dsp::ProcessContextReplacing<float> context(block);
+
+    switch (slot) {
+        case Slot::Filter:
+            filter.process(context);
+            break;
+        case Slot::Eq:
+            for (auto& band : eqBands)
+                band.process(context);
+            break;
+        case Slot::Compressor:
+            compressor.process(context);
+            compressorMakeup.process(context);
+            break;
+        case Slot::Delay:
+            processDelay(block);
+            break;
+        case Slot::NumSlots:
+            break;
+    }
+}
+
+/**
+ * Feedback delay with a dry/wet mix. The delay time glides so changes don't click.
+ */
+void TrackFxChain::processDelay(juce::dsp::AudioBlock<float>& block) noexcept {
+    const float feedback = juce::jlimit(0.0f, kMaxDelayFeedback, delayFeedback.load(std::memory_order_relaxed));
+    const float wet = juce::jlimit(0.0f, 1.0f, delayMix.load(std::memory_order_relaxed));
+    const float dry = 1.0f - wet;
+    const auto channels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t i = 0; i < numSamples; ++i) {
+        const float delaySamples = delaySamplesSmoother.getNextValue();
+        for (size_t ch = 0; ch < channels; ++ch) {
+            auto* data = block.getChannelPointer(ch);
+            const float in = data[i];
+            const float delayed = delayLine.popSample(static_cast<int>(ch), delaySamples);
+            delayLine.pushSample(static_cast<int>(ch), in + delayed * feedback);
+            data[i] = in * dry + delayed * wet;
+        }
+    }
+}
+
+// === Parameter updates (audio thread, only for slots whose dirty bit was set) ===
+
+void TrackFxChain::applyPendingChanges(std::uint32_t changed, bool snap) noexcept {
+    if ((changed & bitFor(Slot::Filter)) != 0) updateFilter();
+    if ((changed & bitFor(Slot::Eq)) != 0) updateEq();
+    if ((changed & bitFor(Slot::Compressor)) != 0) updateCompressor();
+    if ((changed & bitFor(Slot::Delay)) != 0) updateDelay(snap);
+}
+
+void TrackFxChain::resetSlot(Slot slot) noexcept {
+    switch (slot) {
+        case Slot::Filter:
+            filter.reset();
+            break;
+        case Slot::Eq:
+            for (auto& band : eqBands)
+                band.reset();
+            break;
+        case Slot::Compressor:
+            compressor.reset();
+            compressorMakeup.reset();
+            break;
+        case Slot::Delay:
+            delayLine.reset();
+            delaySamplesSmoother.setCurrentAndTargetValue(delaySamplesSmoother.getTargetValue());
+            break;
+        case Slot::NumSlots:
+            break;
+    }
+}
+
+void TrackFxChain::updateFilter() noexcept {
+    using SvfType = juce::dsp::StateVariableTPTFilterType;
+    switch (static_cast<FilterType>(filterType.load(std::memory_order_relaxed))) {
+        case FilterType::HighPass: filter.setType(SvfType::highpass); break;
+        case FilterType::BandPass: filter.setType(SvfType::bandpass); break;
+        case FilterType::LowPass:
+        default:                   filter.setType(SvfType::lowpass); break;
+    }
+
+    const auto maxCutoff = static_cast<float>(sampleRate * 0.45);
+    filter.setCutoffFrequency(juce::jlimit(20.0f, maxCutoff, filterCutoffHz.load(std::memory_order_relaxed)));
+    filter.setResonance(juce::jmax(0.1f, filterResonance.load(std::memory_order_relaxed)));
+}
+
+void TrackFxChain::updateEq() noexcept {
+    // ArrayCoefficients returns a std::array, and assigning it into an existing
+    // Coefficients object of the same order reuses its storage: no allocation here.
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+    const auto maxFrequency = static_cast<float>(sampleRate * 0.45);
+
+    *eqBands[0].state = ArrayCoefficients::makeLowShelf(sampleRate,
+                                                        juce::jmin(TrackConfig::FX_EQ_LOW_SHELF_HZ, maxFrequency),
+                                                        kShelfQ,
+                                                        juce::Decibels::decibelsToGain(eqLowGainDb.load(std::memory_order_relaxed)));
+    *eqBands[1].state = ArrayCoefficients::makePeakFilter(sampleRate,
+                                                          juce::jlimit(20.0f, maxFrequency, eqMidFrequencyHz.load(std::memory_order_relaxed)),
+                                                          juce::jmax(0.1f, eqMidQ.load(std::memory_order_relaxed)),
+                                                          juce::Decibels::decibelsToGain(eqMidGainDb.load(std::memory_order_relaxed)));
+    *eqBands[2].state = ArrayCoefficients::makeHighShelf(sampleRate,
+                                                         juce::jmin(TrackConfig::FX_EQ_HIGH_SHELF_HZ, maxFrequency),
+                                                         kShelfQ,
+                                                         juce::Decibels::decibelsToGain(eqHighGainDb.load(std::memory_order_relaxed)));
+}
+
+void TrackFxChain::updateCompressor() noexcept {
+    compressor.setThreshold(compThresholdDb.load(std::memory_order_relaxed));
+    compressor.setRatio(juce::jmax(1.0f, compRatio.load(std::memory_order_relaxed)));
+    compressor.setAttack(juce::jmax(0.1f, compAttackMs.load(std::memory_order_relaxed)));
+    compressor.setRelease(juce::jmax(1.0f, compReleaseMs.load(std::memory_order_relaxed)));
+    compressorMakeup.setGainDecibels(compMakeupDb.load(std::memory_order_relaxed));
+}
+
+void TrackFxChain::updateDelay(bool snap) noexcept {
+    const auto maxDelay = static_cast<float>(delayLine.getMaximumDelayInSamples() - 1);
+    const auto target = juce::jlimit(1.0f, maxDelay,
+                                     delayTimeMs.load(std::memory_order_relaxed) * static_cast<float>(sampleRate) / 1000.0f);
+    if (snap)
+        delaySamplesSmoother.setCurrentAndTargetValue(target);
+    else
+        delaySamplesSmoother.setTargetValue(target);
+}
+
+/**
+ * Samples until the delay feedback decays below -60 dB. Filter, EQ and
+ * compressor tails are short enough to ignore.
+ */
+int TrackFxChain::computeTailSamples() const noexcept {
+    if ((activeMask & bitFor(Slot::Delay)) == 0)
+        return 0;
+
+    const float feedback = juce::jlimit(0.0f, kMaxDelayFeedback, delayFeedback.load(std::memory_order_relaxed));
+    const int repeats = feedback > kTailThreshold
+        ? juce::jmin(kMaxTailRepeats, static_cast<int>(std::ceil(std::log(kTailThreshold) / std::log(feedback))))
+        : 0;
+    const auto delaySamples = static_cast<int>(std::ceil(delaySamplesSmoother.getTargetValue()));
+    return delaySamples * (repeats + 1);
+}
@@ -0,0 +1,132 @@
+//
+// Per-track insert effect chain: filter -> EQ -> compressor -> delay.
+// - Built on juce::dsp processors, all prepared up front in prepare()
+// - Slots are enabled/configured from any thread through atomics; the audio
+//   thread picks changes up at the start of the next block (no allocation)
+// - Bypassed slots are skipped via a bit mask, so they cost nothing per block
+//
+#pragma once
+// JUCE modules
+#include "juce_audio_basics/juce_audio_basics.h"
+#include "juce_dsp/juce_dsp.h"
+// Project includes
+#include "../Utils/TrackConfig.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Fixed-order insert chain owned by a LoopTrack or a mixer group bus.
+ *
+ * Setters only store atomics and raise a dirty flag, so UI and automation can
+ * call them at any time. Coefficients (EQ) are rebuilt on the audio thread from
+ * juce::dsp::IIR::ArrayCoefficients, which does not allocate.
+ *
+ * Each enabled slot is timed while it runs; getSlotCpuMicros()/getSlotCpuLoad()
+ * report a smoothed per-block cost. Bypassed slots are never timed and report 0.
+ */
+class TrackFxChain {
+public:
+    enum class Slot {
+        Filter = 0,
+        Eq,
+        Compressor,
+        Delay,
+        NumSlots
+    };
+    static constexpr int kNumSlots = static_cast<int>(Slot::NumSlots);
+
+    enum class FilterType {
+        LowPass = 0,
+        HighPass,
+        BandPass
+    };
+
+    TrackFxChain();
+
+    // === Audio processing ===
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);     // message thread, allocates
+    void reset() noexcept;
+    // inputIsSilent lets the chain count down its tail (delay) without scanning the buffer
+    void process(juce::AudioBuffer<float>& buffer, bool inputIsSilent = false) noexcept;
+
+    // === Configuration (any thread) ===
+    void setSlotEnabled(Slot slot, bool enabled) noexcept;
+    bool isSlotEnabled(Slot slot) const noexcept;
+    bool isAnySlotEnabled() const noexcept { return enabledMask.load(std::memory_order_relaxed) != 0; }
+
+    void setFilter(FilterType type, float cutoffHz, float resonance) noexcept;
+    void setEq(float lowGainDb, float midFrequencyHz, float midGainDb, float midQ, float highGainDb) noexcept;
+    void setCompressor(float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb) noexcept;
+    void setDelay(float timeMs, float feedback, float mix) noexcept;
+
+    // === Monitoring ===
+    float getSlotCpuMicros(Slot slot) const noexcept;   // smoothed time per block, 0 when bypassed
+    float getSlotCpuLoad(Slot slot) const noexcept;     // fraction of the block's real-time budget
+    bool hasTail() const noexcept { return tailSamplesRemaining.load(std::memory_order_relaxed) > 0; }
+
+private:
+    using EqBand = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
+                                                  juce::dsp::IIR::Coefficients<float>>;
+
+    // === Processors ===
+    juce::dsp::StateVariableTPTFilter<float> filter;
+    std::array<EqBand, 3> eqBands;                                  // low shelf, mid peak, high shelf
+    juce::dsp::Compressor<float> compressor;
+    juce::dsp::Gain<float> compressorMakeup;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
+    juce::LinearSmoothedValue<float> delaySamplesSmoother;
+
+    // === Parameters (written anywhere, read on the audio thread) ===
+    std::atomic<int> filterType { static_cast<int>(FilterType::LowPass) };
+    std::atomic<float> filterCutoffHz { TrackConfig::FX_DEFAULT_FILTER_CUTOFF_HZ };
+    std::atomic<float> filterResonance { TrackConfig::FX_DEFAULT_FILTER_RESONANCE };
+
+    std::atomic<float> eqLowGainDb { 0.0f };
+    std::atomic<float> eqMidFrequencyHz { TrackConfig::FX_EQ_DEFAULT_MID_HZ };
+    std::atomic<float> eqMidGainDb { 0.0f };
+    std::atomic<float> eqMidQ { 0.7071f };
+    std::atomic<float> eqHighGainDb { 0.0f };
+
+    std::atomic<float> compThresholdDb { TrackConfig::FX_DEFAULT_COMP_THRESHOLD_DB };
+    std::atomic<float> compRatio { TrackConfig::FX_DEFAULT_COMP_RATIO };
+    std::atomic<float> compAttackMs { TrackConfig::FX_DEFAULT_COMP_ATTACK_MS };
+    std::atomic<float> compReleaseMs { TrackConfig::FX_DEFAULT_COMP_RELEASE_MS };
+    std::atomic<float> compMakeupDb { 0.0f };
+
+    std::atomic<float> delayTimeMs { TrackConfig::FX_DEFAULT_DELAY_MS };
+    std::atomic<float> delayFeedback { TrackConfig::FX_DEFAULT_DELAY_FEEDBACK };
+    std::atomic<float> delayMix { TrackConfig::FX_DEFAULT_DELAY_MIX };
+
+    // One dirty bit per slot, set by the setters and consumed by the audio thread
+    std::atomic<std::uint32_t> dirtyMask { 0 };
+    std::atomic<std::uint32_t> enabledMask { 0 };
+    std::uint32_t activeMask = 0;                                   // audio thread's view of enabledMask
+
+    // === Monitoring ===
+    std::array<std::atomic<float>, kNumSlots> slotCpuMicros {};
+    std::atomic<float> blockBudgetMicros { 0.0f };                  // real-time length of the last block
+    std::atomic<int> tailSamplesRemaining { 0 };
+
+    double sampleRate = 0.0;
+    int maxBlockSize = 0;
+    int numChannels = 0;
+    bool isPrepared = false;
+
+    // === Private Helpers ===
+    static constexpr std::uint32_t bitFor(Slot slot) noexcept { return 1u << static_cast<int>(slot); }
+    void markDirty(Slot slot) noexcept;
+    void applyPendingChanges(std::uint32_t changed, bool snap) noexcept;
+    void resetSlot(Slot slot) noexcept;
+    void updateFilter() noexcept;
+    void updateEq() noexcept;
+    void updateCompressor() noexcept;
+    void updateDelay(bool snap) noexcept;
+    void processSlot(Slot slot, juce::dsp::AudioBlock<float>& block) noexcept;
+    void processDelay(juce::dsp::AudioBlock<float>& block) noexcept;
+    int computeTailSamples() const noexcept;
+    void recordCpuTime(Slot slot, juce::int64 elapsedTicks) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackFxChain)
+};
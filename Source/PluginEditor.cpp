@@ -9,6 +9,14 @@ AudioLoopStationEditor::AudioLoopStationEditor (AudioLoopStationAudioProcessor&
     openButton.onClick = [this] { openButtonClicked(); };
     addAndMakeVisible(openButton);
 
+    numTracksLabel.setText("Tracks", juce::dontSendNotification);
+    numTracksLabel.attachToComponent(&numTracksBox, true);
+    for (int count = TrackConfig::MIN_TRACKS; count <= TrackConfig::MAX_TRACKS; ++count)
+        numTracksBox.addItem(juce::String(count), count);
+    numTracksBox.setSelectedId(audioProcessor.getNumTracks(), juce::dontSendNotification);
+    numTracksBox.onChange = [this] { numTracksChanged(); };
+    addAndMakeVisible(numTracksBox);
+
     addAndMakeVisible(mainComponent);
 
     startTimerHz(30);
@@ -52,7 +60,10 @@ void AudioLoopStationEditor::loopButtonChanged()
 void AudioLoopStationEditor::resized()
 {
     auto bounds = getLocalBounds();
-    openButton.setBounds(bounds.removeFromTop(36).reduced(8, 4));
+    auto topBar = bounds.removeFromTop(36);
+    numTracksBox.setBounds(topBar.removeFromRight(80).reduced(8, 4));
+    topBar.removeFromRight(60);     // numTracksLabel
+    openButton.setBounds(topBar.reduced(8, 4));
     mainComponent.setBounds(bounds);
 }
 /**
@@ -67,6 +78,14 @@ void AudioLoopStationEditor::resized()
  */
 void AudioLoopStationEditor::timerCallback()
 {
+    // refused sessions and projects, files that didn't load
+    for (const auto& message : audioProcessor.takeUserMessages())
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "AudioLoopStation", message);
+
+    // a restored session or a loaded project can change the track count too
+    if (numTracksBox.getSelectedId() != audioProcessor.getNumTracks())
+        numTracksBox.setSelectedId(audioProcessor.getNumTracks(), juce::dontSendNotification);
+
     // update waveform playhead position based on global sample position
     auto& syncEngine = audioProcessor.getLoopManager().getSyncEngine();
     double globalSeconds = syncEngine.getGlobalSeconds();
@@ -106,21 +125,41 @@ void AudioLoopStationEditor::openButtonClicked()
     auto chooser = std::make_shared<juce::FileChooser>("Select an audio file...",
                                                        juce::File(),
                                                        validExtensions);
-    chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+    chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles
+                             | juce::FileBrowserComponent::canSelectMultipleItems,
         [safeThis, chooser](const juce::FileChooser& c)
         {
             if (safeThis == nullptr)
                 return;
+            auto files = c.getResults();
             auto file = c.getResult();
             if (file.existsAsFile())
             {
-                safeThis->audioProcessor.loadFileToTrack(file, 0);
+                // Several files (a kit of stems) fill the tracks in order, decoded together;
+                // any that don't fit are reported through the processor's user messages
+                if (files.size() > 1)
+                {
+                    if (!safeThis->audioProcessor.loadFilesToTracks(files, 0))
+                        return;
+                }
+                else
+                {
+                    safeThis->audioProcessor.loadFileToTrack(file, 0);
+                }
+                // the first file always goes to Track 1
                 safeThis->mainComponent.setWaveformFile(file);
                 safeThis->mainComponent.setWaveformPlaybackPosition(0.0);
             }
         });
 }
 
+void AudioLoopStationEditor::numTracksChanged()
+{
+    // the processor says why when it refuses; the timer shows that
+    if (!audioProcessor.setNumTracks(numTracksBox.getSelectedId()))
+        numTracksBox.setSelectedId(audioProcessor.getNumTracks(), juce::dontSendNotification);
+}
+
 void AudioLoopStationEditor::updateTransportButtons()
 {
     // Logic for changing button colors/text will go here
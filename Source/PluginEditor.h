@@ -34,6 +34,11 @@ private:
     juce::TextButton openButton;
     juce::ToggleButton loopingToggle;
 
+    // The project's track count; a refused change snaps back
+    juce::Label numTracksLabel;
+    juce::ComboBox numTracksBox;
+    void numTracksChanged();
+
     MainComponent mainComponent;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioLoopStationEditor)
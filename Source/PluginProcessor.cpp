@@ -1,5 +1,15 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Utils/AudioThreadGuard.h"
+
+#include <cstring>
+
+namespace
+{
+    const juce::Identifier numTracksProperty { "numTracks" };
+
+    constexpr const char* trackParameterSuffixes[] = { "Volume", "Pan", "Mute", "Solo", "Send" };
+}
 
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout AudioLoopStationAudioProcessor::createParameterLayout()
@@ -57,34 +67,97 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioLoopStationAudioProcess
             [](bool value, int) { return value ? "Soloed" : "Not Soloed"; },
             nullptr
         ));
+
+        // Send parameter (0.0 to 1.0, default 0.0) - post-fader level into the shared reverb
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(trackPrefix + "Send", 1),
+            trackPrefix + "Send",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+            TrackConfig::DEFAULT_SEND_LEVEL,
+            juce::String(),
+            juce::AudioProcessorParameter::genericParameter,
+            [](float value, int) { return juce::String(value * 100.0f, 1) + "%"; },
+            nullptr
+        ));
     }
 
-    // Global tempo/BPM parameter
+    // Global tempo/BPM parameter. Continuous, so a detected tempo is held exactly
+    // and the parameter stays the one source of truth for SyncEngine.
     layout.add(std::make_unique<juce::AudioParameterFloat>(
             juce::ParameterID("Tempo", 1),  // Use ParameterID for consistency
             "Tempo",
             juce::NormalisableRange<float>(TrackConfig::BPM_GLOBAL_MIN,
-                                           TrackConfig::BPM_GLOBAL_MAX, 0.1f),
+                                           TrackConfig::BPM_GLOBAL_MAX),
             TrackConfig::DEFAULT_BPM,
             juce::String(),
             juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 1) + " BPM"; },
+            [](float value, int) { return juce::String(value, 2) + " BPM"; },
+            nullptr
+    ));
+
+    // Follow the host's transport (position, tempo, meter, play state, loop range)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID("HostSync", 1),
+            "Host Sync",
+            false,
+            juce::String(),
+            [](bool value, int) { return value ? "Host" : "Internal"; },
+            nullptr
+    ));
+
+    // Set the tempo from the first loop or an imported file (otherwise only proposed)
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID("AutoTempo", 1),
+            "Auto Tempo",
+            true,
+            juce::String(),
+            [](bool value, int) { return value ? "Detect" : "Manual"; },
+            nullptr
+    ));
+
+    // Round trip from the output to the input, in samples (typed in or measured)
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+            juce::ParameterID("RecordOffset", 1),
+            "Record Offset",
+            0,
+            TrackConfig::MAX_RECORD_LATENCY_SAMPLES,
+            0,
+            juce::String(),
+            [](int value, int) { return juce::String(value) + " smp"; },
             nullptr
     ));
     return layout;
 }
 
 //==============================================================================
-AudioLoopStationAudioProcessor::AudioLoopStationAudioProcessor()
-        : AudioProcessor (BusesProperties()
+/**
+ * Main stereo in/out, plus one optional direct output per track (disabled by
+ * default) so hosts can take stems. Bus i + 1 carries track i; those past the
+ * project's track count stay silent.
+ */
+AudioLoopStationAudioProcessor::BusesProperties AudioLoopStationAudioProcessor::createBusesProperties()
+{
+    auto buses = BusesProperties()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
-                                  .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+            .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
 #endif
-                                  .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+            .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-),
-          loopManager(syncEngine),
+            ;
+
+#if ! JucePlugin_IsMidiEffect
+    for (int trackIndex = 0; trackIndex < TrackConfig::MAX_TRACKS; ++trackIndex)
+        buses = buses.withOutput("Track " + juce::String(trackIndex + 1), juce::AudioChannelSet::stereo(), false);
+#endif
+
+    return buses;
+}
+
+AudioLoopStationAudioProcessor::AudioLoopStationAudioProcessor(int numTracks)
+        : AudioProcessor (createBusesProperties()),
+          loopManager(syncEngine, numTracks),
+          mixerEngine(TrackConfig::MAX_TRACKS),     // tracks past the project's count have no input
           fileHandler(std::make_unique<LoopFileHandler>()),
           apvts(*this, nullptr, "PARAMETERS", createParameterLayout()) {
 
@@ -93,20 +166,29 @@ AudioLoopStationAudioProcessor::AudioLoopStationAudioProcessor()
     // Connect parameters to MixerEngine
     mixerEngine.attachParameters(apvts);
 
-    // Link tempo to SyncEngine
+    // Link tempo and host sync to SyncEngine
     apvts.addParameterListener("Tempo", this);
+    apvts.addParameterListener("HostSync", this);
+    apvts.addParameterListener("RecordOffset", this);
+
+    // Tempo detection and player reclamation are polled on the message thread
+    connectFileHandler();
+    startTimer(TrackConfig::MESSAGE_THREAD_POLL_MS);
 }
 
-AudioLoopStationAudioProcessor::~AudioLoopStationAudioProcessor()
-{
-    mixerEngine.detachParameters();
-    apvts.removeParameterListener("Tempo", this);
-}
+AudioLoopStationAudioProcessor::~AudioLoopStationAudioProcessor()
+{
+    stopTimer();
+    mixerEngine.detachParameters();
+    apvts.removeParameterListener("Tempo", this);
+    apvts.removeParameterListener("HostSync", this);
+    apvts.removeParameterListener("RecordOffset", this);
+}
 
 //==============================================================================
 /**
  * Handles parameter changes from the UI,
- * This currently only processes tempo changes.
+ * This currently only processes tempo, host sync and record offset changes.
  * Other parameters are handled directly by MixerEngine via attachParameters()
  *
  * @param parameterID  The ID of the changed parameter
@@ -115,6 +197,10 @@ AudioLoopStationAudioProcessor::~AudioLoopStationAudioProcessor()
 void AudioLoopStationAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue) {
     if (parameterID == "Tempo") {
         syncEngine.setTempo(newValue);
+    } else if (parameterID == "HostSync") {
+        syncEngine.setHostSyncEnabled(newValue >= 0.5f);
+    } else if (parameterID == "RecordOffset") {
+        updateRecordLatency();
     }
 
     // Handle any other parameter changes that won't go in MixerEngine
@@ -186,29 +272,63 @@ void AudioLoopStationAudioProcessor::changeProgramName (int index, const juce::S
 }
 
 //==============================================================================
-void AudioLoopStationAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    // Get channel config
-    int numTrackChannels = juce::jmax(1, getTotalNumOutputChannels());
+void AudioLoopStationAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    // Get channel config (tracks follow the main bus; direct outputs must match it)
+    int numTrackChannels = juce::jmax(1, getMainBusNumOutputChannels());
+
+    // Direct outputs only change with the bus layout, which hosts change between prepares
+    directOutputEnabled.assign(loopManager.getNumTracks(), 0);
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i)
+    {
+        if (auto* bus = getBus(false, static_cast<int>(i) + 1))
+            directOutputEnabled[i] = bus->isEnabled() ? 1 : 0;
+    }
+
+    // Every audio-thread buffer is sized here; processBlock never exceeds this slice length
+    preparedBlockSize = juce::jmax(1, samplesPerBlock);
+    preparedSampleRate = sampleRate;
+    transportBuffer.setSize(numTrackChannels, preparedBlockSize);
 
     // Prepare SyncEngine
     syncEngine.prepare(sampleRate, samplesPerBlock);
 
-    // Prepare LoopManager
-    loopManager.prepareToPlay(sampleRate, samplesPerBlock, numTrackChannels);
+    // Prepare LoopManager. Projects of PARALLEL_RENDER_MIN_TRACKS or more (see
+    // setNumTracks()) render tracks on helper threads as well; with the audio
+    // thread they leave one physical core for the message thread and the host.
+    loopManager.setNumRenderWorkers(TrackConfig::getNumRenderWorkers(getNumTracks(), juce::SystemStats::getNumPhysicalCpus()));
+    loopManager.prepareToPlay(sampleRate, samplesPerBlock, numTrackChannels);
 
     // Prepare MixerEngine
-    mixerEngine.prepare(sampleRate, samplesPerBlock);
+    mixerEngine.prepare(sampleRate, samplesPerBlock, numTrackChannels, numTrackChannels);
+    setLatencySamples(mixerEngine.getLatencySamples());   // master limiter lookahead
+
+    // Stem delay lines, long enough for the limiter whether it is on now or turned on later
+    const auto delayLineLength = static_cast<size_t>(mixerEngine.getLimiterLatencySamples() + preparedBlockSize);
+    const auto linesPerTrack = static_cast<size_t>(maxDirectOutputChannels);
+    directOutputDelays.assign(directOutputEnabled.size() * linesPerTrack, {});
+    for (size_t i = 0; i < directOutputEnabled.size(); ++i)
+    {
+        if (directOutputEnabled[i] == 0)
+            continue;
+        for (size_t ch = 0; ch < linesPerTrack; ++ch)
+            directOutputDelays[i * linesPerTrack + ch].assign(delayLineLength, 0.0f);
+    }
+    directOutputDelaySamples = 0;
+    updateRecordLatency();
+    latencyProbe.prepare(sampleRate);
 
     // Set initial tempo
     float tempo = apvts.getRawParameterValue("Tempo")->load();
-    syncEngine.setTempo(tempo);
+    syncEngine.setConstantTempo(tempo);
+    syncEngine.setHostSyncEnabled(apvts.getRawParameterValue("HostSync")->load() >= 0.5f);
 
     // Legacy JUCE transport not needed as everything is handled by Gin's SamplePlayer
 }
 
 void AudioLoopStationAudioProcessor::releaseResources()
 {
+    preparedSampleRate = 0.0;
     loopManager.releaseResources();
     mixerEngine.prepare(0, 0);
 }
@@ -228,54 +348,164 @@ bool AudioLoopStationAudioProcessor::isBusesLayoutSupported (const BusesLayout&
         return false;
 #endif
 
+    // Track direct outputs are either off or in the main bus layout
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+    {
+        const auto& set = layouts.getChannelSet(false, bus);
+        if (!set.isDisabled() && set != layouts.getMainOutputChannelSet())
+            return false;
+    }
+
     return true;
 #endif
 }
 
-void AudioLoopStationAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
-                                              juce::MidiBuffer& midiMessages)
-{
+void AudioLoopStationAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
+                                              juce::MidiBuffer& midiMessages)
+{
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
 
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    // Nothing below may allocate, free or lock (checked in guard builds)
+    const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
 
-    // 1. Clear only the extra output channels (standard JUCE practice)
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-
-    // 2. Process loop tracks into per-track buffers.
-    loopManager.processBlock(buffer);
-
-    // 3. Route per-track outputs through the mixer into the master output.
-    mixerEngine.process(loopManager.getTrackOutputs(), buffer);
-
-    // 4. Add Transport Source: Use a temporary buffer so we don't overwrite the loops
-    if (readerSource.get() != nullptr)
-    {
-        juce::AudioBuffer<float> transportBuffer (buffer.getNumChannels(), buffer.getNumSamples());
-        transportBuffer.clear();
-
-        juce::AudioSourceChannelInfo info(&transportBuffer, 0, transportBuffer.getNumSamples());
-        transportSource.getNextAudioBlock(info);
+    // Lock the clock to the host's transport for this block (when following it)
+    if (syncEngine.isHostSyncEnabled())
+    {
+        if (auto* playHead = getPlayHead())
+            if (const auto position = playHead->getPosition())
+                syncEngine.syncToHost(*position);
+    }
 
-        // Add the transport audio TO the loop audio instead of replacing it
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            buffer.addFrom(ch, 0, transportBuffer, ch, 0, buffer.getNumSamples());
+    // Every scratch buffer is sized for the prepared block, so a host that sends
+    // more than it announced is served in prepared-size slices instead. A slice
+    // also ends at the host's loop end, so the wrap lands on the exact sample.
+    const int totalSamples = buffer.getNumSamples();
+    const int sliceLength = preparedBlockSize > 0 ? preparedBlockSize : totalSamples;
+    for (int start = 0; start < totalSamples;)
+    {
+        const int length = juce::jmin(sliceLength, totalSamples - start, syncEngine.getSamplesUntilLoopWrap());
+        processSlice(buffer, start, length);
+        start += length;
     }
 
-    // 5. Update VU Meter: Now measuring the COMBINED output of loops + transport
+    // Update VU Meter: the COMBINED output of loops + transport over the whole block
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
     float peak = 0.0f;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    for (int ch = 0; ch < mainBuffer.getNumChannels(); ++ch)
     {
-        auto* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        auto* data = mainBuffer.getReadPointer(ch);
+        for (int i = 0; i < mainBuffer.getNumSamples(); ++i)
             peak = juce::jmax(peak, std::abs(data[i]));
     }
     outputLevel.store(peak, std::memory_order_relaxed);
 }
 
+/**
+ * Runs the engines over one slice of the host block. Bus views are built per
+ * bus (one or two channels each), so they never allocate a channel list.
+ */
+void AudioLoopStationAudioProcessor::processSlice(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // Main bus view; enabled direct outputs follow it in the same buffer
+    auto mainBus = getBusBuffer(buffer, false, 0);
+    juce::AudioBuffer<float> mainBuffer(mainBus.getArrayOfWritePointers(), mainBus.getNumChannels(),
+                                        startSample, numSamples);
+
+    auto mainNumInputChannels  = getMainBusNumInputChannels();
+    auto mainNumOutputChannels = getMainBusNumOutputChannels();
+
+    // 1. Clear only the extra output channels (standard JUCE practice)
+    for (auto i = mainNumInputChannels; i < mainNumOutputChannels; ++i)
+        mainBuffer.clear (i, 0, mainBuffer.getNumSamples());
+
+    // Round-trip measurement listens to the raw input
+    latencyProbe.listen(mainBuffer, mainNumInputChannels);
+
+    // 2. Process loop tracks into per-track buffers. Tracks with an enabled direct
+    //    output render straight into the host's bus, and the mixer reads them from there.
+    for (size_t i = 0; i < directOutputEnabled.size(); ++i)
+    {
+        if (directOutputEnabled[i] == 0)
+            continue;
+
+        auto directBus = getBusBuffer(buffer, false, static_cast<int>(i) + 1);
+        float* channels[2] = {};
+        const int numChannels = juce::jmin(directBus.getNumChannels(), 2);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch] = directBus.getWritePointer(ch, startSample);
+
+        loopManager.setTrackDirectOutput(i, channels, numChannels, numSamples);
+    }
+    loopManager.processBlock(mainBuffer);
+
+    // 3. Route per-track outputs through the mixer into the master output.
+    //    Track trims are folded into the mixer's single per-track gain ramp.
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i)
+    {
+        if (auto* track = loopManager.getTrack(i))
+            mixerEngine.setTrackTrimGain(i, track->getCurrentGain());
+    }
+    mixerEngine.process(loopManager.getTrackOutputs(), mainBuffer);
+
+    // The mixer has read the stems; they now go out as late as the limited master
+    delayDirectOutputs(buffer, startSample, numSamples);
+
+    // 4. Add Transport Source: into the prepared scratch so we don't overwrite the loops.
+    //    (AudioTransportSource takes its callback lock here; the guard will say so if this is wired up.)
+    if (readerSource.get() != nullptr)
+    {
+        const int transportChannels = juce::jmin(mainBuffer.getNumChannels(), transportBuffer.getNumChannels());
+        juce::AudioBuffer<float> transportSlice(transportBuffer.getArrayOfWritePointers(), transportChannels, numSamples);
+        transportSlice.clear();
+
+        juce::AudioSourceChannelInfo info(&transportSlice, 0, numSamples);
+        transportSource.getNextAudioBlock(info);
+
+        // Add the transport audio TO the loop audio instead of replacing it
+        for (int ch = 0; ch < transportChannels; ++ch)
+            mainBuffer.addFrom(ch, 0, transportSlice, ch, 0, numSamples);
+    }
+
+    // 5. While measuring the round trip, the output is the probe's click and silence
+    latencyProbe.emit(mainBuffer);
+}
+
+/**
+ * Delays each enabled direct output in place by the master's current latency.
+ * A change of latency (the limiter toggled) restarts the lines from silence.
+ */
+void AudioLoopStationAudioProcessor::delayDirectOutputs(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    const int delay = mixerEngine.getLatencySamples();
+    if (delay != directOutputDelaySamples)
+    {
+        for (auto& line : directOutputDelays)
+            std::fill(line.begin(), line.end(), 0.0f);
+        directOutputDelaySamples = delay;
+    }
+    if (delay == 0)
+        return;
+
+    for (size_t i = 0; i < directOutputEnabled.size(); ++i)
+    {
+        if (directOutputEnabled[i] == 0)
+            continue;
+
+        auto directBus = getBusBuffer(buffer, false, static_cast<int>(i) + 1);
+        const int numChannels = juce::jmin(directBus.getNumChannels(), maxDirectOutputChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& line = directOutputDelays[i * static_cast<size_t>(maxDirectOutputChannels) + static_cast<size_t>(ch)];
+            auto* data = directBus.getWritePointer(ch, startSample);
+
+            juce::FloatVectorOperations::copy(line.data() + delay, data, numSamples);
+            juce::FloatVectorOperations::copy(data, line.data(), numSamples);
+            std::memmove(line.data(), line.data() + numSamples, static_cast<size_t>(delay) * sizeof(float));
+        }
+    }
+}
+
 //==============================================================================
 bool AudioLoopStationAudioProcessor::hasEditor() const
 {
@@ -288,35 +518,191 @@ juce::AudioProcessorEditor* AudioLoopStationAudioProcessor::createEditor()
 }
 
 //==============================================================================
+bool AudioLoopStationAudioProcessor::setNumTracks(int numTracks)
+{
+    juce::String reason;
+    if (!canSetNumTracks(numTracks, reason))
+    {
+        postUserMessage(reason);
+        return false;
+    }
+
+    // the user's choice replaces one a host state is still waiting to apply
+    pendingStateTracks = 0;
+    resizeTracks(numTracks);
+    return true;
+}
+
+bool AudioLoopStationAudioProcessor::canSetNumTracks(int numTracks, juce::String& reason) const
+{
+    numTracks = TrackConfig::clampNumTracks(numTracks);
+    if (numTracks == getNumTracks())
+        return true;
+
+    if (fileHandler != nullptr && fileHandler->isJobRunning())
+    {
+        reason = "The number of tracks can't change while a project or file is being saved or loaded.";
+        return false;
+    }
+
+    for (int i = numTracks; i < getNumTracks(); ++i)
+    {
+        const auto* track = loopManager.getTrack(static_cast<size_t>(i));
+        if (track->hasAudio() || track->getState() == LoopTrack::State::Recording)
+        {
+            reason = "Track " + juce::String(i + 1) + " has audio, so the project can't go down to "
+                     + juce::String(numTracks) + " tracks. Clear it first.";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Changes the engine's track count with the audio callback held off. Removed
+ * tracks' parameters go back to their defaults, so a track added later starts
+ * from a clean strip.
+ */
+void AudioLoopStationAudioProcessor::resizeTracks(int numTracks)
+{
+    numTracks = TrackConfig::clampNumTracks(numTracks);
+    const int oldNumTracks = getNumTracks();
+    if (numTracks == oldNumTracks)
+        return;
+
+    suspendProcessing(true);
+    loopManager.setNumTracks(numTracks);
+
+    for (int i = numTracks; i < oldNumTracks; ++i)
+    {
+        for (const auto* suffix : trackParameterSuffixes)
+            if (auto* param = apvts.getParameter("Track" + juce::String(i + 1) + "_" + suffix))
+                param->setValueNotifyingHost(param->getDefaultValue());
+    }
+
+    // new tracks get their buffers, and the render workers follow the count
+    if (preparedSampleRate > 0.0)
+        prepareToPlay(preparedSampleRate, preparedBlockSize);
+    else
+        updateRecordLatency();
+    suspendProcessing(false);
+}
+
+/**
+ * The track count goes into the state with the parameters. A count that is
+ * still waiting to be applied is saved instead, so a host that saves in the
+ * meantime keeps the session it restored.
+ */
 void AudioLoopStationAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     auto state = apvts.copyState();
+    state.setProperty(numTracksProperty, pendingStateTracks > 0 ? pendingStateTracks : getNumTracks(), nullptr);
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
 
+/**
+ * Restores the state's track count, then its parameters (every track's are in
+ * the layout, so they all apply). A count that can't be applied yet, because a
+ * track it would remove has audio or a file job is running, is kept: it is
+ * saved in its place and the timer applies it once it can. States from before
+ * the count was saved had the default.
+ */
 void AudioLoopStationAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr) {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    if (xml == nullptr)
+        return;
+
+    auto state = juce::ValueTree::fromXml(*xml);
+    const int savedTracks = TrackConfig::clampNumTracks(state.getProperty(numTracksProperty, TrackConfig::DEFAULT_NUM_TRACKS));
+
+    juce::String reason;
+    pendingStateTracks = 0;
+    if (canSetNumTracks(savedTracks, reason))
+    {
+        resizeTracks(savedTracks);
     }
+    else
+    {
+        pendingStateTracks = savedTracks;
+        postUserMessage("This session was saved with " + juce::String(savedTracks) + " tracks. " + reason
+                        + " Until then it is still saved with " + juce::String(savedTracks) + " tracks.");
+    }
+    apvts.replaceState(state);
 }
 
-void AudioLoopStationAudioProcessor::loadFileToTrack(const juce::File &audioFile, int trackIndex) {
-    if (!fileHandler) fileHandler = std::make_unique<LoopFileHandler>();
+void AudioLoopStationAudioProcessor::postUserMessage(const juce::String& message)
+{
+    DBG(message);
+    const juce::ScopedLock lock(userMessageLock);
+    userMessages.add(message);
+}
 
-    auto index = static_cast<size_t>(trackIndex);
+juce::StringArray AudioLoopStationAudioProcessor::takeUserMessages()
+{
+    juce::StringArray messages;
+    const juce::ScopedLock lock(userMessageLock);
+    std::swap(messages, userMessages);
+    return messages;
+}
+
+void AudioLoopStationAudioProcessor::loadFileToTrack(const juce::File &audioFile, int trackIndex) {
+    if (!fileHandler) {
+        fileHandler = std::make_unique<LoopFileHandler>();
+        connectFileHandler();
+    }
 
-    if (auto* track = loopManager.getTrack(index))
+    // Decoded in the background; the timer hands it to the track
+    if (fileHandler->loadAudioFileAsync(audioFile, loopManager, static_cast<size_t>(trackIndex)))
     {
-        if (fileHandler->loadAudioFile(audioFile, *track))
-        {
-            DBG("Successfully loaded " + audioFile.getFileName() + " to Track " + juce::String(trackIndex + 1));
-        }
+        DBG("Loading " + audioFile.getFileName() + " to Track " + juce::String(trackIndex + 1));
     }
 }
 
+bool AudioLoopStationAudioProcessor::loadFilesToTracks(const juce::Array<juce::File>& audioFiles, int firstTrackIndex) {
+    if (!fileHandler) {
+        fileHandler = std::make_unique<LoopFileHandler>();
+        connectFileHandler();
+    }
+
+    // Decoded side by side in the background; each track gets its file as soon as it is ready.
+    // Files beyond the last track are left out and reported to the user.
+    if (!fileHandler->loadAudioFilesAsync(audioFiles, loopManager, static_cast<size_t>(firstTrackIndex)))
+        return false;
+
+    DBG("Loading " + juce::String(audioFiles.size()) + " files from Track " + juce::String(firstTrackIndex + 1));
+    return true;
+}
+
+bool AudioLoopStationAudioProcessor::saveProject(const juce::File& destination)
+{
+    return fileHandler != nullptr && fileHandler->saveProjectAsync(destination, loopManager, syncEngine);
+}
+
+/**
+ * The session takes the project's track count: more tracks before the load,
+ * so it fits, and fewer once it has succeeded, since until then the tracks
+ * that go still hold the session's audio.
+ */
+bool AudioLoopStationAudioProcessor::loadProject(const juce::File& source)
+{
+    if (fileHandler == nullptr || fileHandler->isJobRunning())
+        return false;
+
+    const AlsProjectReader reader(source);
+    const int projectTracks = reader.isValid() ? LoopFileHandler::getProjectNumTracks(reader) : 0;
+    if (projectTracks > getNumTracks())
+        resizeTracks(projectTracks);
+
+    if (!fileHandler->loadProjectAsync(source, loopManager, syncEngine))
+        return false;
+
+    pendingStateTracks = 0;
+    loadingProjectTracks = projectTracks;
+    return true;
+}
+
 void AudioLoopStationAudioProcessor::startPlayback()
 {
     loopManager.startAllPlayback();
@@ -329,6 +715,173 @@ void AudioLoopStationAudioProcessor::stopPlayback()
     isPlaying_ = false;
 }
 
+//==============================================================================
+void AudioLoopStationAudioProcessor::timerCallback()
+{
+    // players the audio thread swapped out since the last tick
+    loopManager.reclaimRetiredPlayers();
+    if (loopManager.takeLaunchesHeldBack())
+        DBG("Track commands waited a block for room to hand back swapped-out players");
+
+    // tracks a background load has finished, and the end of a save
+    if (fileHandler != nullptr)
+        fileHandler->handleJobResults();
+
+    // a restored track count that had to wait
+    juce::String reason;
+    if (pendingStateTracks > 0 && canSetNumTracks(pendingStateTracks, reason))
+    {
+        resizeTracks(pendingStateTracks);
+        pendingStateTracks = 0;
+    }
+
+    watchForFirstLoop();
+
+    TempoDetector::Estimate estimate;
+    if (tempoDetector.takeEstimate(estimate))
+        handleTempoEstimate(estimate);
+
+    int measuredLatency = 0;
+    if (latencyProbe.takeResult(measuredLatency) && measuredLatency != LatencyProbe::kNoEcho)
+    {
+        if (auto* offset = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("RecordOffset")))
+            offset->setValueNotifyingHost(offset->convertTo0to1(static_cast<float>(measuredLatency)));
+    }
+}
+
+/**
+ * Plays a click from the main output and times its return on the main input;
+ * the result becomes the RecordOffset. Needs the output looped back to the input.
+ */
+void AudioLoopStationAudioProcessor::measureRecordLatency()
+{
+    latencyProbe.start();
+}
+
+void AudioLoopStationAudioProcessor::setMasterLimiterEnabled(bool shouldBeEnabled)
+{
+    mixerEngine.setMasterLimiterEnabled(shouldBeEnabled);
+    setLatencySamples(mixerEngine.getLatencySamples());
+    updateRecordLatency();
+}
+
+/**
+ * A take is moved by the interface's round trip plus the master limiter's
+ * lookahead, which delays everything the player hears by that much more.
+ */
+void AudioLoopStationAudioProcessor::updateRecordLatency()
+{
+    const auto offset = static_cast<int>(apvts.getRawParameterValue("RecordOffset")->load());
+    loopManager.setRecordLatency(offset + mixerEngine.getLatencySamples());
+}
+
+void AudioLoopStationAudioProcessor::connectFileHandler()
+{
+    fileHandler->onUserMessage = [this](const juce::String& message) { postUserMessage(message); };
+    fileHandler->onJobFinished = [this](bool succeeded)
+    {
+        // a loaded project's extra tracks are dropped; their audio was unloaded with the rest
+        if (succeeded && loadingProjectTracks > 0)
+            resizeTracks(loadingProjectTracks);
+        loadingProjectTracks = 0;
+    };
+    fileHandler->onAudioFileLoaded = [this](size_t trackIndex, const juce::AudioBuffer<float>& audio, double sampleRate)
+    {
+        tempoDetector.requestAnalysis(static_cast<int>(trackIndex), audio, sampleRate,
+                                      syncEngine.getTimeSignature().numerator);
+    };
+}
+
+/**
+ * Sends the first loop of a session to tempo detection once its take is in the
+ * player. Polled: the audio thread never reports anything here.
+ */
+void AudioLoopStationAudioProcessor::watchForFirstLoop()
+{
+    const auto numTracks = loopManager.getNumTracks();
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        const auto* track = loopManager.getTrack(i);
+        const auto index = static_cast<int>(i);
+
+        if (track->getState() == LoopTrack::State::Recording)
+        {
+            if (watchedRecordingTrack != index)
+            {
+                watchedRecordingTrack = index;
+                watchedTakeIsFirstLoop = true;
+                for (size_t other = 0; other < numTracks; ++other)
+                    if (other != i && loopManager.getTrack(other)->hasLoop())
+                        watchedTakeIsFirstLoop = false;
+            }
+        }
+        else if (watchedRecordingTrack == index)
+        {
+            // the finished take reaches the player at the audio block after recording stops
+            const auto& take = track->getAudioBuffer();
+            const bool takeLoaded = take.getNumSamples() > 0 && take.getNumSamples() == track->getLoopLengthSamples();
+            if (takeLoaded && watchedTakeIsFirstLoop)
+                tempoDetector.requestAnalysis(index, take, track->getSourceSampleRate(),
+                                              syncEngine.getTimeSignature().numerator);
+
+            if (takeLoaded || !track->hasLoop())
+                watchedRecordingTrack = TrackConfig::INVALID_TRACK_ID;
+        }
+    }
+}
+
+void AudioLoopStationAudioProcessor::handleTempoEstimate(const TempoDetector::Estimate& estimate)
+{
+    if (!estimate.isValid() || estimate.confidence < TrackConfig::TEMPO_DETECT_MIN_CONFIDENCE)
+    {
+        DBG("Tempo detection: no clear tempo in Track " + juce::String(estimate.trackIndex + 1));
+        return;
+    }
+
+    tempoProposal = estimate;
+    DBG("Tempo detection: Track " + juce::String(estimate.trackIndex + 1) + " at "
+        + juce::String(estimate.bpm, 2) + " BPM, " + juce::String(estimate.beatsPerLoop) + " beats");
+
+    // Set straight away only if nothing else already plays to the current tempo,
+    // and the host isn't the one deciding it
+    if (apvts.getRawParameterValue("AutoTempo")->load() < 0.5f || syncEngine.isHostSyncEnabled())
+        return;
+
+    for (size_t i = 0; i < loopManager.getNumTracks(); ++i)
+        if (static_cast<int>(i) != estimate.trackIndex && loopManager.getTrack(i)->hasAudio())
+            return;
+
+    acceptTempoProposal();
+}
+
+/**
+ * Sets the proposed tempo. An imported file that spans whole beats also becomes
+ * its track's loop, with its first downbeat on the bar lines.
+ */
+bool AudioLoopStationAudioProcessor::acceptTempoProposal()
+{
+    if (!tempoProposal.isValid())
+        return false;
+
+    // SyncEngine follows through parameterChanged(), with the value the host and the state keep
+    if (auto* tempo = apvts.getParameter("Tempo"))
+        tempo->setValueNotifyingHost(tempo->convertTo0to1(static_cast<float>(tempoProposal.bpm)));
+
+    const auto trackIndex = static_cast<size_t>(tempoProposal.trackIndex);
+    const auto* track = loopManager.getTrack(trackIndex);
+    if (track != nullptr && !track->hasLoop() && tempoProposal.fitsWholeBeats())
+    {
+        const double projectRate = syncEngine.getSampleRate();
+        const double ratio = projectRate > 0.0 && tempoProposal.sourceSampleRate > 0.0
+                                 ? projectRate / tempoProposal.sourceSampleRate
+                                 : 1.0;
+        loopManager.adoptTrackAudio(trackIndex, juce::roundToInt(tempoProposal.downbeatSample * ratio));
+    }
+
+    tempoProposal = {};
+    return true;
+}
+
 //==============================================================================
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
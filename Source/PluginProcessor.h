@@ -9,15 +9,20 @@
 #include "Audio/LoopManager.h"
 #include "Audio/MixerEngine.h"
 #include "Audio/LoopFileHandler.h"
+#include "Audio/TempoDetector.h"
+#include "Audio/LatencyProbe.h"
 #include "Utils/TrackConfig.h"
 
 //==============================================================================
 class AudioLoopStationAudioProcessor final : public juce::AudioProcessor,
-                                             public juce::AudioProcessorValueTreeState::Listener
+                                             public juce::AudioProcessorValueTreeState::Listener,
+                                             private juce::Timer
 {
 public:
     //==============================================================================
-    AudioLoopStationAudioProcessor();
+    // Parameters and direct outputs exist for TrackConfig::MAX_TRACKS; the engine runs
+    // the project's own count, which starts at numTracks (see setNumTracks()).
+    explicit AudioLoopStationAudioProcessor(int numTracks = TrackConfig::DEFAULT_NUM_TRACKS);
     ~AudioLoopStationAudioProcessor() override;
 
     //==============================================================================
@@ -64,20 +69,59 @@ public:
 
     // === Getters for UI ===
     LoopManager& getLoopManager() { return loopManager; }
+    int getNumTracks() const { return static_cast<int>(loopManager.getNumTracks()); }
     SyncEngine& getSyncEngine() { return syncEngine; }
 
+    // === Track count (message thread) ===
+    // Chosen when the project is created and saved with it, in the host's state and in
+    // .als projects. Tracks are added empty or removed from the end. Refused, and the
+    // user told why, while a file job runs or if a track it would remove has audio.
+    bool setNumTracks(int numTracks);
+
     // === Transport control methods ===
     void loadFileToTrack(const juce::File& audioFile, int trackIndex);
+    // Loads the files that fit from firstTrackIndex on; false if none could start loading
+    bool loadFilesToTracks(const juce::Array<juce::File>& audioFiles, int firstTrackIndex);
     void startPlayback();
     void stopPlayback();
     bool isPlaying() const { return isPlaying_; }
 
+    // === Projects (message thread) ===
+    // Saved and loaded in the background; progress and cancelling through the file handler
+    bool saveProject(const juce::File& destination);
+    bool loadProject(const juce::File& source);
+    LoopFileHandler* getFileHandler() noexcept { return fileHandler.get(); }
+
+    // === Tempo detection (message thread) ===
+    // Latest confident estimate from the first loop or an imported file. With
+    // AutoTempo on it is applied at once while no other track has audio.
+    const TempoDetector::Estimate& getTempoProposal() const noexcept { return tempoProposal; }
+    bool acceptTempoProposal();
+
+    // === Record latency ===
+    // Measures the output-to-input round trip (output looped back to the input)
+    // and stores it in RecordOffset when it comes back.
+    void measureRecordLatency();
+    bool isMeasuringRecordLatency() const noexcept { return latencyProbe.isRunning(); }
+
+    // === Messages for the user ===
+    // Posted from any thread (a refused state or project, files that didn't load);
+    // the editor takes and shows them
+    void postUserMessage(const juce::String& message);
+    juce::StringArray takeUserMessages();
+
+    // === Master limiter (message thread) ===
+    // Its lookahead is the plugin's latency, so toggling it re-reports that to the host
+    void setMasterLimiterEnabled(bool shouldBeEnabled);
+
 private:
     // === Core components ===
     SyncEngine syncEngine;                          // 1. Global timekeeper
     LoopManager loopManager;                        // 2. Manages tracks, uses the SyncEngine
     MixerEngine mixerEngine;                        // 3. Mixes tracks
     std::unique_ptr<LoopFileHandler> fileHandler;   // 4. File loading
+    TempoDetector tempoDetector;                    // 5. Background tempo analysis
+    LatencyProbe latencyProbe;                      // 6. Round-trip measurement
 
     std::atomic<float> outputLevel{0.0f};
 
@@ -88,12 +132,54 @@ private:
     // === Audio Playback Logic ==
     std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
     juce::AudioTransportSource transportSource;
+    juce::AudioBuffer<float> transportBuffer;       // sized in prepareToPlay, viewed per slice
 
     // === State ===
     std::atomic<bool> isPlaying_ {false};
 
+    juce::CriticalSection userMessageLock;
+    juce::StringArray userMessages;
+
+    // Per track: 1 when its direct output bus is enabled (refreshed in prepareToPlay)
+    std::vector<uint8_t> directOutputEnabled;
+
+    // Direct outputs are held back by the master limiter's lookahead, so stems stay
+    // aligned with the master. Per track and channel, [delay | slice] as in MasterLimiter;
+    // empty for buses that are off. Sized in prepareToPlay for the longest delay.
+    static constexpr int maxDirectOutputChannels = 2;
+    std::vector<std::vector<float>> directOutputDelays;
+    int directOutputDelaySamples = 0;           // audio thread: the delay the lines hold now
+    void delayDirectOutputs(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // === Track count ===
+    // A host state's count that couldn't be applied yet. It is saved in the state in
+    // place of the current one, and the timer applies it once it can.
+    int pendingStateTracks = 0;
+    int loadingProjectTracks = 0;       // of the project being loaded; fewer tracks once it is in
+
+    bool canSetNumTracks(int numTracks, juce::String& reason) const;
+    void resizeTracks(int numTracks);  // no checks: removed tracks lose what they hold
+
+    // === Tempo detection ===
+    TempoDetector::Estimate tempoProposal;
+    int watchedRecordingTrack = TrackConfig::INVALID_TRACK_ID;     // take being recorded, seen by the timer
+    bool watchedTakeIsFirstLoop = false;
+
+    void timerCallback() override;
+    void connectFileHandler();
+    void watchForFirstLoop();
+    void handleTempoEstimate(const TempoDetector::Estimate& estimate);
+    void updateRecordLatency();
+
+    // Largest slice the engines were prepared for; longer host blocks are split
+    int preparedBlockSize = 0;
+    double preparedSampleRate = 0.0;    // 0 while not prepared
+    void processSlice(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
     // === Parameter layout creation ===
+    // Both cover TrackConfig::MAX_TRACKS, so a project's count never changes what the host sees
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    static BusesProperties createBusesProperties();
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioLoopStationAudioProcessor)
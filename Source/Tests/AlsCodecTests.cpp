@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "../Audio/AlsCodec.h"
+
+class AlsCodecTests : public juce::UnitTest
+{
+public:
+    AlsCodecTests() : juce::UnitTest("AlsCodecTests") {}
+
+    void runTest() override
+    {
+        juce::Random random(46);
+
+        beginTest("16-bit audio round trips exactly and shrinks");
+        {
+            std::vector<float> samples(20000);
+            double phase = 0.0;
+            for (auto& sample : samples)
+            {
+                const auto value = 0.5 * std::sin(phase) + 0.01 * (random.nextDouble() - 0.5);
+                sample = static_cast<float>(std::round(value * 32767.0) / 32768.0);
+                phase += 0.03;
+            }
+
+            const auto coded = roundTrip(samples, "16-bit sine");
+            expectLessThan(coded.size(), samples.size() * sizeof(float) * 2 / 3, "Predicted and Rice coded");
+        }
+
+        beginTest("Full-precision float audio round trips bit for bit");
+        {
+            std::vector<float> samples(9000);
+            for (auto& sample : samples)
+                sample = random.nextFloat() * 2.0f - 1.0f;
+            roundTrip(samples, "Noise");
+
+            double phase = 0.0;
+            for (auto& sample : samples)
+            {
+                sample = static_cast<float>(0.8 * std::sin(phase)) * 1.0001f;
+                phase += 0.001;
+            }
+            roundTrip(samples, "Float sine");
+        }
+
+        beginTest("Silence, -0, denormals, infinities and NaN payloads survive");
+        {
+            std::vector<float> samples(5000, 0.0f);
+            const auto silence = roundTrip(samples, "Silence");
+            expectLessThan(silence.size(), samples.size() / 8 + 64, "Silence costs about a bit per sample");
+
+            samples[1] = -0.0f;
+            samples[2] = std::numeric_limits<float>::denorm_min();
+            samples[3] = -std::numeric_limits<float>::infinity();
+            samples[4] = std::numeric_limits<float>::max();
+            const uint32_t payloadNaN = 0x7fc12345u;
+            std::memcpy(&samples[4100], &payloadNaN, sizeof(float));
+            roundTrip(samples, "Specials");
+
+            roundTrip(std::vector<float>(1, 0.25f), "One sample");
+            roundTrip({}, "Empty");
+        }
+
+        beginTest("Truncated or corrupt data is rejected, not overrun");
+        {
+            std::vector<float> samples(6000);
+            for (auto& sample : samples)
+                sample = std::round((random.nextFloat() - 0.5f) * 2000.0f) / 32768.0f;
+
+            std::vector<uint8_t> coded;
+            AlsCodec::encode(samples.data(), static_cast<int>(samples.size()), coded);
+
+            std::vector<float> decoded(samples.size());
+            expect(!AlsCodec::decode(coded.data(), coded.size() - 1, decoded.data(), static_cast<int>(decoded.size())), "Truncated");
+            expect(!AlsCodec::decode(coded.data(), coded.size(), decoded.data(), static_cast<int>(decoded.size()) - 1), "Wrong length");
+
+            auto corrupt = coded;
+            corrupt[0] = 0xff;
+            expect(!AlsCodec::decode(corrupt.data(), corrupt.size(), decoded.data(), static_cast<int>(decoded.size())), "Bad block mode");
+
+            // Random damage must fail or decode something, never read or write out of bounds
+            for (int trial = 0; trial < 200; ++trial)
+            {
+                corrupt = coded;
+                corrupt[static_cast<size_t>(random.nextInt(static_cast<int>(corrupt.size())))] ^= static_cast<uint8_t>(1 + random.nextInt(255));
+                AlsCodec::decode(corrupt.data(), corrupt.size(), decoded.data(), static_cast<int>(decoded.size()));
+            }
+        }
+    }
+
+private:
+    std::vector<uint8_t> roundTrip(const std::vector<float>& samples, const juce::String& label)
+    {
+        std::vector<uint8_t> coded;
+        AlsCodec::encode(samples.data(), static_cast<int>(samples.size()), coded);
+
+        std::vector<float> decoded(samples.size(), 1.0f);
+        expect(AlsCodec::decode(coded.data(), coded.size(), decoded.data(), static_cast<int>(decoded.size())), label);
+        expect(samples.empty() || std::memcmp(decoded.data(), samples.data(), samples.size() * sizeof(float)) == 0, label);
+        return coded;
+    }
+};
+
+static AlsCodecTests alsCodecTests;
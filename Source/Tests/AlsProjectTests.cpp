@@ -0,0 +1,521 @@
+#include <cstring>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/AlsProjectReader.h"
+#include "../Audio/LoopFileHandler.h"
+#include "../Utils/ContentHash.h"
+
+class AlsProjectTests : public juce::UnitTest
+{
+public:
+    AlsProjectTests() : juce::UnitTest("AlsProjectTests") {}
+
+    void runTest() override
+    {
+        beginTest("Saved audio sits in page-aligned chunks listed in the chunk table");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            const auto first = makeAudio(2, 5000, 1);
+            const auto third = makeAudio(2, 12345, 3);
+            manager.loadTrackAudio(0, first, sampleRate);
+            manager.loadTrackAudio(2, third, sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            LoopFileHandler handler;
+            expect(handler.saveProject(project.getFile(), manager, sync));
+
+            AlsProjectReader reader(project.getFile());
+            expect(reader.isValid());
+            expectEquals(static_cast<int>(reader.getHeader().version), static_cast<int>(AlsFormat::VERSION));
+            expectEquals(static_cast<int>(reader.getHeader().numChunks), 4, "One chunk per channel");
+            expectEquals(static_cast<int>(reader.getHeader().chunkTableOffset % AlsFormat::CHUNK_TABLE_ALIGNMENT), 0);
+
+            for (const auto& chunk : reader.getChunks())
+            {
+                expectEquals(static_cast<int>(chunk.offset % AlsFormat::CHUNK_ALIGNMENT), 0, "Chunks start on a page");
+                expect(chunk.offset >= reader.getHeader().chunkTableOffset + reader.getHeader().numChunks * sizeof(AlsFormat::ChunkEntry));
+            }
+
+            // Random access: the last track first, without the others
+            expect(!reader.hasTrackAudio(1));
+            juce::AudioBuffer<float> audio;
+            expect(reader.getTrackAudio(2, audio));
+            expectBuffersEqual(audio, third, "Track 3 read in place");
+            expect(reader.getTrackAudio(0, audio));
+            expectBuffersEqual(audio, first, "Track 1 read in place");
+            expect(!reader.getTrackAudio(1, audio), "Track 2 has no audio");
+
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("A saved project loads back into the tracks, also over an older file");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            const auto second = makeAudio(1, 777, 2);
+            manager.loadTrackAudio(1, second, 44100.0);
+            manager.getTrack(1)->setPan(-0.5f);
+            processOneBlock(manager);
+
+            // an existing, longer file is replaced rather than appended to
+            juce::TemporaryFile project(".als");
+            project.getFile().replaceWithData(juce::MemoryBlock(100000, true).getData(), 100000);
+
+            LoopFileHandler handler;
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            expectLessThan(project.getFile().getSize(), static_cast<juce::int64>(100000));
+
+            SyncEngine loadedSync;
+            loadedSync.prepare(sampleRate, blockSize);
+            LoopManager loaded(loadedSync, 4);
+            loaded.prepareToPlay(sampleRate, blockSize, 2);
+
+            expect(handler.loadProject(project.getFile(), loaded, loadedSync));
+            processOneBlock(loaded);
+
+            expectBuffersEqual(loaded.getTrack(1)->getAudioBuffer(), second, "Track 2 restored");
+            expectEquals(loaded.getTrack(1)->getSourceSampleRate(), 44100.0);
+            expectEquals(loaded.getTrack(1)->getCurrentPan(), -0.5f);
+            expect(!loaded.getTrack(0)->hasAudio());
+
+            manager.reclaimRetiredPlayers();
+            loaded.reclaimRetiredPlayers();
+        }
+
+        beginTest("A project with more tracks than the session is refused and reported");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 6);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+            manager.loadTrackAudio(5, makeAudio(1, 500, 11), sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            LoopFileHandler handler;
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            expectEquals(LoopFileHandler::getProjectNumTracks(AlsProjectReader(project.getFile())), 6);
+
+            SyncEngine smallSync;
+            smallSync.prepare(sampleRate, blockSize);
+            LoopManager small(smallSync, 4);
+            small.prepareToPlay(sampleRate, blockSize, 2);
+            small.getTrack(0)->setPan(0.5f);
+
+            juce::StringArray messages;
+            handler.onUserMessage = [&messages](const juce::String& message) { messages.add(message); };
+            expect(!handler.loadProject(project.getFile(), small, smallSync), "Not loaded with tracks missing");
+            expect(handler.loadProjectAsync(project.getFile(), small, smallSync));
+            waitForJob(handler);
+            expectEquals(messages.size(), 2, "Both refusals reported");
+            expect(messages[0].contains("6 tracks"), messages[0]);
+            expectEquals(small.getTrack(0)->getCurrentPan(), 0.5f, "Session left alone");
+
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("Lossless projects are smaller and load back bit for bit");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            // 16-bit style audio codes well; full-precision noise is kept as it is
+            juce::AudioBuffer<float> quantised(2, 20000);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < quantised.getNumSamples(); ++i)
+                    quantised.setSample(ch, i, std::round(8000.0f * std::sin(0.01f * static_cast<float>(i * (ch + 1)))) / 32768.0f);
+            const auto noise = makeAudio(1, 3000, 5);
+            manager.loadTrackAudio(0, quantised, sampleRate);
+            manager.loadTrackAudio(3, noise, sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile raw(".als"), lossless(".als");
+            LoopFileHandler handler;
+            expect(handler.saveProject(raw.getFile(), manager, sync));
+            handler.setProjectCodec(AlsFormat::Codec::Lossless);
+            expect(handler.saveProject(lossless.getFile(), manager, sync));
+            expectLessThan(lossless.getFile().getSize(), raw.getFile().getSize());
+
+            AlsProjectReader reader(lossless.getFile());
+            expect(reader.isValid());
+            expect(reader.getCodec() == AlsFormat::Codec::Lossless);
+            for (const auto& chunk : reader.getChunks())
+                expectEquals(static_cast<int>(chunk.offset % AlsFormat::CHUNK_ALIGNMENT), 0, "Coded chunks stay page aligned");
+
+            SyncEngine loadedSync;
+            loadedSync.prepare(sampleRate, blockSize);
+            LoopManager loaded(loadedSync, 4);
+            loaded.prepareToPlay(sampleRate, blockSize, 2);
+
+            expect(handler.loadProject(lossless.getFile(), loaded, loadedSync));
+            processOneBlock(loaded);
+            expectBuffersEqual(loaded.getTrack(0)->getAudioBuffer(), quantised, "Both channels decoded in parallel");
+            expectBuffersEqual(loaded.getTrack(3)->getAudioBuffer(), noise, "Noise stored verbatim");
+
+            manager.reclaimRetiredPlayers();
+            loaded.reclaimRetiredPlayers();
+        }
+
+        beginTest("Long coded channels are streamed in segments and the table patched afterwards");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 2);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            // Several segments per channel, the last one partial
+            const int numSamples = 2 * TrackConfig::PROJECT_SAVE_SEGMENT_SAMPLES + 12345;
+            juce::AudioBuffer<float> audio(2, numSamples);
+            juce::Random random(47);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    audio.setSample(ch, i, static_cast<float>(random.nextInt({ -3000, 3000 })) / 32768.0f);
+            manager.loadTrackAudio(1, audio, sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            LoopFileHandler handler;
+            handler.setProjectCodec(AlsFormat::Codec::Lossless);
+            expect(handler.saveProject(project.getFile(), manager, sync));
+
+            AlsProjectReader reader(project.getFile());
+            expect(reader.isValid());
+            expectEquals(static_cast<int>(reader.getChunks().size()), 2);
+            const auto& last = reader.getChunks().back();
+            expectEquals(static_cast<juce::int64>(reader.getHeader().audioLength),
+                         static_cast<juce::int64>(last.offset + last.length - reader.getChunks().front().offset));
+            expectEquals(static_cast<juce::int64>(last.offset + last.length), project.getFile().getSize(), "Nothing after the last chunk");
+
+            juce::AudioBuffer<float> read;
+            expect(reader.getTrackAudio(1, read));
+            expectBuffersEqual(read, audio, "Segments concatenate into the channel");
+
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("Background save and load hand their results over from handleJobResults()");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setTempo(97.0f);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            const auto first = makeAudio(2, 4000, 6);
+            const auto last = makeAudio(1, 2500, 7);
+            manager.loadTrackAudio(0, first, sampleRate);
+            manager.loadTrackAudio(3, last, sampleRate);
+            manager.getTrack(3)->setVolumeDb(-9.0f);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            LoopFileHandler handler;
+            handler.setProjectCodec(AlsFormat::Codec::Lossless);
+            int finishedCalls = 0;
+            bool finishedOk = false;
+            handler.onJobFinished = [&](bool succeeded) { ++finishedCalls; finishedOk = succeeded; };
+
+            expect(handler.saveProjectAsync(project.getFile(), manager, sync));
+            expect(!handler.loadProjectAsync(project.getFile(), manager, sync), "One job at a time");
+            waitForJob(handler);
+            expectEquals(finishedCalls, 1);
+            expect(finishedOk);
+            expectEquals(handler.getJobProgress(), 1.0f);
+
+            SyncEngine loadedSync;
+            loadedSync.prepare(sampleRate, blockSize);
+            LoopManager loaded(loadedSync, 4);
+            loaded.prepareToPlay(sampleRate, blockSize, 2);
+
+            expect(handler.loadProjectAsync(project.getFile(), loaded, loadedSync));
+            waitForJob(handler);
+            expectEquals(finishedCalls, 2);
+            expect(finishedOk);
+            processOneBlock(loaded);
+
+            expectEquals(loadedSync.getTempo(), 97.0f);
+            expectEquals(loaded.getTrack(3)->getCurrentVolumeDb(), -9.0f);
+            expectBuffersEqual(loaded.getTrack(0)->getAudioBuffer(), first, "Track 1 published");
+            expectBuffersEqual(loaded.getTrack(3)->getAudioBuffer(), last, "Track 4 published");
+
+            manager.reclaimRetiredPlayers();
+            loaded.reclaimRetiredPlayers();
+        }
+
+        beginTest("A cancelled background save leaves the existing project alone");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 1);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+            manager.loadTrackAudio(0, makeAudio(2, 2 * TrackConfig::PROJECT_SAVE_SEGMENT_SAMPLES, 8), sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            project.getFile().replaceWithText("previous project");
+
+            LoopFileHandler handler;
+            handler.setProjectCodec(AlsFormat::Codec::Lossless);
+            bool finishedOk = true;
+            handler.onJobFinished = [&](bool succeeded) { finishedOk = succeeded; };
+
+            expect(handler.saveProjectAsync(project.getFile(), manager, sync));
+            handler.cancelJob();
+            waitForJob(handler);
+            expect(!finishedOk, "Reported as not saved");
+            expectEquals(project.getFile().loadFileAsString(), juce::String("previous project"));
+
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("A batch of audio files is decoded together, each file to its own track");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::TemporaryFile firstFile(".wav"), secondFile(".wav"), missing(".wav");
+            const auto first = makeAudio(2, 9000, 9);
+            const auto second = makeAudio(1, 70000, 10);
+            writeFloatWav(firstFile.getFile(), first);
+            writeFloatWav(secondFile.getFile(), second);
+
+            LoopFileHandler handler;
+            juce::StringArray messages;
+            handler.onUserMessage = [&messages](const juce::String& message) { messages.add(message); };
+            int filesLoaded = 0;
+            handler.onAudioFileLoaded = [&filesLoaded](size_t, const juce::AudioBuffer<float>&, double) { ++filesLoaded; };
+            bool finishedOk = false;
+            handler.onJobFinished = [&finishedOk](bool succeeded) { finishedOk = succeeded; };
+
+            // more files than tracks from track 3: the two that fit load, the rest are reported
+            expect(handler.loadAudioFilesAsync({ secondFile.getFile(), firstFile.getFile(), missing.getFile() }, manager, 2));
+            waitForJob(handler);
+            processOneBlock(manager);
+            expect(finishedOk, "The files that fit loaded");
+            expectEquals(filesLoaded, 2);
+            expectEquals(messages.size(), 1, "The file left out is reported");
+            expect(messages[0].contains(missing.getFile().getFileName()));
+            expectBuffersEqual(manager.getTrack(3)->getAudioBuffer(), first, "Second file on the last track");
+            expect(!handler.loadAudioFilesAsync({ firstFile.getFile() }, manager, 4), "No track to start from");
+
+            filesLoaded = 0;
+            messages.clear();
+            finishedOk = true;
+            expect(handler.loadAudioFilesAsync({ firstFile.getFile(), missing.getFile(), secondFile.getFile() }, manager, 1));
+            waitForJob(handler);
+            processOneBlock(manager);
+
+            expect(!finishedOk, "A missing file fails the batch");
+            expectEquals(messages.size(), 1, "The unreadable file is reported");
+            expectEquals(filesLoaded, 2, "The readable files still load");
+            expectBuffersEqual(manager.getTrack(1)->getAudioBuffer(), first, "First file on track 2");
+            expect(!manager.getTrack(2)->hasAudio());
+            expectBuffersEqual(manager.getTrack(3)->getAudioBuffer(), second, "Third file on track 4");
+
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("Saving over the last save rewrites only changed chunks");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            LoopManager manager(sync, 4);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            const auto first = makeAudio(2, 20000, 6);
+            manager.loadTrackAudio(0, first, sampleRate);
+            manager.loadTrackAudio(2, makeAudio(1, 30000, 7), sampleRate);
+            processOneBlock(manager);
+
+            juce::TemporaryFile project(".als");
+            LoopFileHandler handler;
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            const auto saved = AlsProjectReader(project.getFile()).getChunks();
+            const auto savedSize = project.getFile().getSize();
+            for (const auto& chunk : saved)
+            {
+                const auto& audio = chunk.trackIndex == 0 ? first : manager.getTrack(2)->getAudioBuffer();
+                expectEquals(static_cast<juce::int64>(chunk.contentHash),
+                             static_cast<juce::int64>(ContentHash::hash(audio.getReadPointer(chunk.channel),
+                                                                        sizeof(float) * chunk.numSamples)),
+                             "Table holds the hash of the raw samples");
+            }
+
+            // A settings change leaves every chunk where it was and appends only the metadata
+            juce::MemoryBlock before;
+            expect(project.getFile().loadFileAsData(before));
+            manager.getTrack(0)->setPan(0.25f);
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            expectLessThan(project.getFile().getSize() - savedSize, static_cast<juce::int64>(AlsFormat::CHUNK_ALIGNMENT),
+                           "No audio rewritten");
+            auto chunks = AlsProjectReader(project.getFile()).getChunks();
+            for (size_t c = 0; c < chunks.size(); ++c)
+                expectEquals(static_cast<juce::int64>(chunks[c].offset), static_cast<juce::int64>(saved[c].offset));
+
+            // Everything the old header points at is untouched, so a save that dies before
+            // writing its header still leaves the previous project
+            {
+                juce::MemoryBlock after;
+                expect(project.getFile().loadFileAsData(after));
+                expect(std::memcmp(after.begin() + AlsFormat::HEADER_SIZE, before.begin() + AlsFormat::HEADER_SIZE,
+                                   before.getSize() - AlsFormat::HEADER_SIZE) == 0, "Old metadata and audio kept");
+
+                juce::TemporaryFile interrupted(".als");
+                after.copyFrom(before.getData(), 0, AlsFormat::HEADER_SIZE);
+                expect(interrupted.getFile().replaceWithData(after.getData(), after.getSize()));
+
+                SyncEngine oldSync;
+                oldSync.prepare(sampleRate, blockSize);
+                LoopManager old(oldSync, 4);
+                old.prepareToPlay(sampleRate, blockSize, 2);
+                expect(LoopFileHandler().loadProject(interrupted.getFile(), old, oldSync));
+                processOneBlock(old);
+                expectEquals(old.getTrack(0)->getCurrentPan(), 0.0f, "Previous settings");
+                expectBuffersEqual(old.getTrack(0)->getAudioBuffer(), first, "Previous audio");
+                old.reclaimRetiredPlayers();
+            }
+
+            // New audio on one track is appended; the other track's chunks stay put
+            const auto replaced = makeAudio(1, 30000, 8);
+            manager.loadTrackAudio(2, replaced, sampleRate);
+            processOneBlock(manager);
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            chunks = AlsProjectReader(project.getFile()).getChunks();
+            expectEquals(static_cast<juce::int64>(chunks[0].offset), static_cast<juce::int64>(saved[0].offset));
+            expectEquals(static_cast<juce::int64>(chunks[1].offset), static_cast<juce::int64>(saved[1].offset));
+            expectGreaterOrEqual(static_cast<juce::int64>(chunks[2].offset), savedSize, "Changed chunk appended");
+
+            // Loading the same audio again changes the track, but not its content
+            const auto appendedSize = project.getFile().getSize();
+            manager.loadTrackAudio(0, first, sampleRate);
+            processOneBlock(manager);
+            expect(handler.saveProject(project.getFile(), manager, sync));
+            expectLessThan(project.getFile().getSize() - appendedSize, static_cast<juce::int64>(AlsFormat::CHUNK_ALIGNMENT),
+                           "Hash proves the reload unchanged");
+
+            SyncEngine loadedSync;
+            loadedSync.prepare(sampleRate, blockSize);
+            LoopManager loaded(loadedSync, 4);
+            loaded.prepareToPlay(sampleRate, blockSize, 2);
+
+            expect(handler.loadProject(project.getFile(), loaded, loadedSync));
+            processOneBlock(loaded);
+            expectBuffersEqual(loaded.getTrack(0)->getAudioBuffer(), first, "Kept chunks still read");
+            expectBuffersEqual(loaded.getTrack(2)->getAudioBuffer(), replaced, "Appended chunk read");
+            expectEquals(loaded.getTrack(0)->getCurrentPan(), 0.25f);
+
+            manager.reclaimRetiredPlayers();
+            loaded.reclaimRetiredPlayers();
+        }
+
+        beginTest("Version 1 projects are still read");
+        {
+            const auto audio = makeAudio(2, 300, 4);
+            juce::TemporaryFile project(".als");
+            writeVersion1Project(project.getFile(), 3, audio);
+
+            AlsProjectReader reader(project.getFile());
+            expect(reader.isValid());
+            expectEquals(static_cast<int>(reader.getChunks().size()), 2);
+
+            juce::AudioBuffer<float> read;
+            expect(reader.getTrackAudio(3, read));
+            expectBuffersEqual(read, audio, "Sequential blocks found by walking them");
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    static juce::AudioBuffer<float> makeAudio(int numChannels, int numSamples, int seed)
+    {
+        juce::AudioBuffer<float> audio(numChannels, numSamples);
+        juce::Random random(seed);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                audio.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+        return audio;
+    }
+
+    static void processOneBlock(LoopManager& manager)
+    {
+        juce::AudioBuffer<float> input(2, blockSize);
+        input.clear();
+        manager.processBlock(input);
+    }
+
+    // Plays the processor's timer until the handler's job is over
+    void waitForJob(LoopFileHandler& handler)
+    {
+        for (int i = 0; i < 1000 && handler.isJobRunning(); ++i)
+        {
+            juce::Thread::sleep(5);
+            handler.handleJobResults();
+        }
+        expect(!handler.isJobRunning(), "Job finished");
+    }
+
+    void expectBuffersEqual(const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected,
+                            const juce::String& label)
+    {
+        expectEquals(actual.getNumChannels(), expected.getNumChannels(), label);
+        expectEquals(actual.getNumSamples(), expected.getNumSamples(), label);
+        if (actual.getNumChannels() != expected.getNumChannels() || actual.getNumSamples() != expected.getNumSamples())
+            return;
+
+        bool same = true;
+        for (int ch = 0; ch < expected.getNumChannels(); ++ch)
+            same = same && std::memcmp(actual.getReadPointer(ch), expected.getReadPointer(ch),
+                                       sizeof(float) * static_cast<size_t>(expected.getNumSamples())) == 0;
+        expect(same, label);
+    }
+
+    static void writeFloatWav(const juce::File& file, const juce::AudioBuffer<float>& audio)
+    {
+        file.deleteFile();
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(new juce::FileOutputStream(file), sampleRate,
+                                                                            static_cast<unsigned int>(audio.getNumChannels()),
+                                                                            32, {}, 0));
+        writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    static void writeVersion1Project(const juce::File& file, int trackIndex, const juce::AudioBuffer<float>& audio)
+    {
+        const auto json = "{\"version\": 1, \"bpm\": 120, \"tracks\": [{\"index\": 0, \"hasAudio\": false}, {\"index\": "
+                          + juce::String(trackIndex) + ", \"hasAudio\": true}]}";
+
+        AlsFormat::Header header;
+        AlsFormat::initHeader(header);
+        header.version = 1;
+        header.chunkAlignment = 0;
+        header.sampleRate = static_cast<uint32_t>(sampleRate);
+        header.jsonLength = json.getNumBytesAsUTF8();
+
+        juce::FileOutputStream stream(file);
+        stream.setPosition(0);
+        stream.truncate();
+        stream.write(&header, AlsFormat::HEADER_SIZE);
+        stream.write(json.toRawUTF8(), static_cast<size_t>(header.jsonLength));
+        stream.writeInt(audio.getNumSamples());
+        stream.writeInt(audio.getNumChannels());
+        for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+            stream.write(audio.getReadPointer(ch), sizeof(float) * static_cast<size_t>(audio.getNumSamples()));
+    }
+};
+
+static AlsProjectTests alsProjectTests;
@@ -0,0 +1,192 @@
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/LoopManager.h"
+#include "../Audio/MixerEngine.h"
+#include "../Utils/AudioThreadGuard.h"
+
+class GuardDummyProcessor : public juce::AudioProcessor
+{
+public:
+    GuardDummyProcessor() = default;
+    ~GuardDummyProcessor() override = default;
+
+    const juce::String getName() const override { return "GuardDummyProcessor"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    bool isBusesLayoutSupported(const BusesLayout&) const override { return true; }
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    using juce::AudioProcessor::processBlock;
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+};
+
+static juce::AudioProcessorValueTreeState::ParameterLayout createGuardLayout(int numTracks)
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    for (int i = 0; i < numTracks; ++i)
+    {
+        const auto prefix = "Track" + juce::String(i + 1) + "_";
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            prefix + "Volume", prefix + "Volume",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            prefix + "Pan", prefix + "Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Mute", prefix + "Mute", false));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Solo", prefix + "Solo", false));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(
+            prefix + "Send", prefix + "Send",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+    }
+    return layout;
+}
+
+class AudioThreadGuardTests : public juce::UnitTest
+{
+public:
+    AudioThreadGuardTests() : juce::UnitTest("AudioThreadGuardTests") {}
+
+    void runTest() override
+    {
+        const auto previousMode = AudioThreadGuard::getMode();
+
+        beginTest("Guard reports allocations, frees and locks inside a realtime section");
+        {
+            expect(AudioThreadGuard::isEnabled(), "The test runner is built with the guard");
+            AudioThreadGuard::setMode(AudioThreadGuard::Mode::Count);
+            AudioThreadGuard::resetViolations();
+
+            // called through volatile pointers so the compiler can't elide the pair
+            void* (*volatile allocate)(std::size_t) = &::operator new;
+            void (*volatile release)(void*) = &::operator delete;
+
+            release(allocate(64));
+            expectEquals(AudioThreadGuard::getNumViolations(), 0, "Outside a section nothing is reported");
+
+            {
+                const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
+                release(allocate(64));
+            }
+            expectEquals(AudioThreadGuard::getNumViolations(), 2, "Allocation and free should both be reported");
+
+            {
+                const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
+                const AudioThreadGuard::ScopedAllowance allowance;
+                release(allocate(64));
+            }
+            expectEquals(AudioThreadGuard::getNumViolations(), 2, "An allowance should suspend the check");
+
+           #if defined(__GLIBC__)
+            std::mutex mutex;
+            {
+                const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
+                mutex.lock();
+                mutex.unlock();
+            }
+            expectEquals(AudioThreadGuard::getNumViolations(), 3, "A blocking lock should be reported");
+           #endif
+        }
+
+        beginTest("Engines render without allocating or locking on the audio thread");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+            constexpr int numChannels = 2;
+            constexpr int numTracks = 16;
+
+            // a failure prints the offending stack
+            AudioThreadGuard::setMode(AudioThreadGuard::Mode::Log);
+            AudioThreadGuard::resetViolations();
+
+            GuardDummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createGuardLayout(numTracks));
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            // samples-per-beat rounds to one block, so the loop is one block long
+            sync.setTempo(45000.0f);
+
+            LoopManager loopManager(sync, numTracks);
+            loopManager.setNumRenderWorkers(2);
+            loopManager.prepareToPlay(sampleRate, blockSize, numChannels);
+
+            MixerEngine mixer(numTracks);
+            mixer.attachParameters(apvts);
+            mixer.prepare(sampleRate, blockSize, numChannels, numChannels);
+            mixer.setTrackOutput(1, 0);
+
+            juce::AudioBuffer<float> input(numChannels, blockSize);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int s = 0; s < blockSize; ++s)
+                    input.setSample(ch, s, 0.25f * std::sin(0.2f * static_cast<float>(s)));
+
+            juce::AudioBuffer<float> silentInput(numChannels, blockSize);
+            silentInput.clear();
+            juce::AudioBuffer<float> master(numChannels, blockSize);
+            juce::AudioBuffer<float> directBus(numChannels, blockSize);
+
+            for (size_t t = 0; t < loopManager.getNumTracks(); ++t)
+            {
+                loopManager.getTrack(t)->armForRecording(true);
+                loopManager.getTrack(t)->startRecording(0);
+            }
+
+            auto renderBlock = [&](const juce::AudioBuffer<float>& blockInput)
+            {
+                juce::ScopedNoDenormals noDenormals;
+                const AudioThreadGuard::ScopedRealtimeSection realtimeSection;
+
+                loopManager.setTrackDirectOutput(2, directBus.getArrayOfWritePointers(), numChannels, blockSize);
+                loopManager.processBlock(blockInput);
+                mixer.process(loopManager.getTrackOutputs(), master);
+            };
+
+            renderBlock(input);
+
+            // message-thread edits between blocks: the audio thread only sees their results
+            for (size_t t = 0; t < loopManager.getNumTracks(); ++t)
+            {
+                auto* track = loopManager.getTrack(t);
+                track->stopRecording();
+                track->armForRecording(false);
+                track->setReverse(t % 3 == 0);
+                track->setSlip(t % 4 == 1 ? 17 : 0);
+
+                if (t % 2 == 0)
+                    track->getFxChain().setSlotEnabled(TrackFxChain::Slot::Filter, true);
+            }
+
+            for (int block = 0; block < 64; ++block)
+            {
+                if (auto* volume = apvts.getParameter("Track1_Volume"))
+                    volume->setValueNotifyingHost(static_cast<float>(block % 10) / 10.0f);
+                if (auto* send = apvts.getParameter("Track4_Send"))
+                    send->setValueNotifyingHost(0.5f);
+
+                renderBlock(silentInput);
+            }
+
+            expectEquals(AudioThreadGuard::getNumViolations(), 0, "The render path should stay inside the contract");
+            expect(master.getMagnitude(0, blockSize) > 0.0f, "The tracks should actually have been rendered");
+        }
+
+        AudioThreadGuard::setMode(previousMode);
+    }
+};
+
+static AudioThreadGuardTests audioThreadGuardTests;
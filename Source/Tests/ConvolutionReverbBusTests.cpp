@@ -0,0 +1,135 @@
+#include <cmath>
+#include <vector>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "ConvolutionReverbBus.h"
+#include "PartitionedConvolver.h"
+
+class ConvolutionReverbBusTests : public juce::UnitTest
+{
+public:
+    ConvolutionReverbBusTests() : juce::UnitTest("ConvolutionReverbBusTests") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        auto makeIr = [](int length)
+        {
+            juce::AudioBuffer<float> ir(1, length);
+            juce::Random random(1234);
+            for (int s = 0; s < length; ++s)
+                ir.setSample(0, s, (random.nextFloat() * 2.0f - 1.0f) * std::exp(-4.0f * static_cast<float>(s) / static_cast<float>(length)));
+            return ir;
+        };
+
+        beginTest("Partitioned convolver reproduces the impulse response");
+        {
+            constexpr int partition = 64;
+            const auto ir = makeIr(300);
+
+            PartitionedConvolver convolver;
+            convolver.prepare(partition, ir, 0, ir.getNumSamples());
+            expectEquals(convolver.getNumPartitions(), 5);
+
+            std::vector<float> input(partition, 0.0f);
+            std::vector<float> output(partition, 0.0f);
+            float* outputs[] = { output.data() };
+
+            float maxError = 0.0f;
+            for (int block = 0; block < 6; ++block)
+            {
+                input[0] = block == 0 ? 1.0f : 0.0f;
+                convolver.processBlock(input.data(), outputs);
+
+                for (int s = 0; s < partition; ++s)
+                {
+                    const int n = block * partition + s;
+                    const float expected = n < ir.getNumSamples() ? ir.getSample(0, n) : 0.0f;
+                    maxError = juce::jmax(maxError, std::abs(output[static_cast<size_t>(s)] - expected));
+                }
+            }
+            expect(maxError < 1.0e-4f, "Impulse in should give the IR out, got error " + juce::String(maxError));
+        }
+
+        beginTest("Reverb bus returns the head and tail of the convolution");
+        {
+            // long enough to need the background tail convolver
+            const auto ir = makeIr(3 * TrackConfig::REVERB_TAIL_BLOCK_SIZE + 500);
+
+            ConvolutionReverbBus bus;
+            bus.prepare(sampleRate);
+            bus.loadImpulseResponse(ir, sampleRate);
+
+            const int delay = bus.getReturnDelaySamples();
+            const int totalBlocks = (ir.getNumSamples() + delay) / blockSize + 2;
+
+            std::vector<float> send(blockSize, 0.0f);
+            juce::AudioBuffer<float> master(2, blockSize);
+            float maxError = 0.0f;
+
+            for (int block = 0; block < totalBlocks; ++block)
+            {
+                send[0] = block == 0 ? 1.0f : 0.0f;
+                master.clear();
+                bus.processReturn(send.data(), master, blockSize, block != 0);
+
+                for (int s = 0; s < blockSize; ++s)
+                {
+                    const int n = block * blockSize + s - delay;
+                    const float expected = n >= 0 && n < ir.getNumSamples() ? ir.getSample(0, n) : 0.0f;
+                    for (int ch = 0; ch < 2; ++ch)
+                        maxError = juce::jmax(maxError, std::abs(master.getSample(ch, s) - expected));
+                }
+
+                // give the tail thread a realtime-like schedule
+                juce::Thread::sleep(5);
+            }
+
+            expectEquals(bus.getNumLateTailBlocks(), 0);
+            expect(maxError < 1.0e-3f, "Return should be the delayed IR, got error " + juce::String(maxError));
+        }
+
+        beginTest("Reverb bus goes dormant after silence and wakes on signal");
+        {
+            ConvolutionReverbBus bus;
+            bus.prepare(sampleRate);
+            bus.loadImpulseResponse(makeIr(3 * TrackConfig::REVERB_TAIL_BLOCK_SIZE), sampleRate);
+
+            std::vector<float> send(blockSize, 0.0f);
+            juce::AudioBuffer<float> master(2, blockSize);
+
+            for (int block = 0; block < 80 && !bus.isDormant(); ++block)
+            {
+                master.clear();
+                bus.processReturn(send.data(), master, blockSize, true);
+                juce::Thread::sleep(2);
+            }
+            expect(bus.isDormant(), "Silent send should put the bus to sleep");
+
+            send[0] = 1.0f;
+            master.clear();
+            bus.processReturn(send.data(), master, blockSize, false);
+            expect(!bus.isDormant(), "Signal on the send should wake the bus");
+            expect(master.getMagnitude(0, blockSize) > 0.0f, "Woken bus should return the head right away");
+        }
+
+        beginTest("Default impulse response is stereo and energy normalised");
+        {
+            const auto ir = ConvolutionReverbBus::createDefaultImpulseResponse(sampleRate);
+            expectEquals(ir.getNumChannels(), 2);
+            expectEquals(ir.getNumSamples(), static_cast<int>(TrackConfig::REVERB_DEFAULT_DECAY_SECONDS * sampleRate));
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                double energy = 0.0;
+                for (int s = 0; s < ir.getNumSamples(); ++s)
+                    energy += static_cast<double>(ir.getSample(ch, s)) * ir.getSample(ch, s);
+                expectWithinAbsoluteError(energy, 1.0, 1.0e-3);
+            }
+        }
+    }
+};
+
+static ConvolutionReverbBusTests convolutionReverbBusTests;
@@ -0,0 +1,136 @@
+#include <vector>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/LatencyProbe.h"
+#include "../Audio/LoopManager.h"
+
+class LatencyCompensationTests : public juce::UnitTest
+{
+public:
+    LatencyCompensationTests() : juce::UnitTest("LatencyCompensationTests") {}
+
+    void runTest() override
+    {
+        beginTest("A take starts where the timeline was when its first sample was played");
+        {
+            // 64-sample beats: a 256-sample block less a 64-sample latency is three whole beats
+            constexpr int latency = 64;
+            constexpr int impulse = latency + 10;
+
+            expectEquals(recordImpulse(latency, impulse), 10, "The input arriving before the take is skipped");
+            expectEquals(recordImpulse(0, impulse), impulse, "No offset leaves the take as it came in");
+        }
+
+        beginTest("A take keeps the latency it started with");
+        {
+            expectEquals(recordImpulse(64, 74, 128), 10);
+        }
+
+        beginTest("The probe times a click's return through a loopback");
+        {
+            for (const int roundTrip : { 300, 1000, 4101 })
+            {
+                LatencyProbe probe;
+                probe.prepare(sampleRate);
+                probe.start();
+                expect(probe.isRunning());
+
+                int measured = 0;
+                expect(runLoopback(probe, roundTrip, measured), "The measurement should finish");
+                expectEquals(measured, roundTrip);
+                expect(!probe.isRunning());
+            }
+        }
+
+        beginTest("Without a loopback the probe gives up");
+        {
+            LatencyProbe probe;
+            probe.prepare(sampleRate);
+            probe.start();
+
+            int measured = 0;
+            expect(runLoopback(probe, -1, measured), "The measurement should time out");
+            expectEquals(measured, LatencyProbe::kNoEcho);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+
+    // Records one block with a unit impulse at impulseIndex, starting at timeline 0
+    // (the latency changing to laterLatency once the take has started);
+    // returns where the impulse landed in the take (-1 if it didn't).
+    int recordImpulse(int latency, int impulseIndex, int laterLatency = -1)
+    {
+        SyncEngine sync;
+        sync.prepare(sampleRate, blockSize);
+        sync.setTempo(45000.0f);
+
+        LoopManager manager(sync, 2);
+        manager.prepareToPlay(sampleRate, blockSize, 2);
+        manager.setRecordLatency(latency);
+
+        auto* track = manager.getTrack(0);
+        track->armForRecording(true);
+        track->startRecording(0);
+        if (laterLatency >= 0)
+            manager.setRecordLatency(laterLatency);
+
+        juce::AudioBuffer<float> input(2, blockSize);
+        input.clear();
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            input.setSample(ch, impulseIndex, 1.0f);
+        manager.processBlock(input);
+
+        expectEquals(track->getLoopLengthSamples(), blockSize - latency);
+
+        const auto& take = track->getAudioBuffer();
+        int found = -1;
+        for (int i = 0; i < take.getNumSamples() && found < 0; ++i)
+            if (take.getSample(0, i) > 0.5f)
+                found = i;
+
+        manager.reclaimRetiredPlayers();
+        return found;
+    }
+
+    // Runs 128-sample slices with the output fed back to the input roundTrip samples
+    // later (never, when negative) until the probe reports.
+    static bool runLoopback(LatencyProbe& probe, int roundTrip, int& measured)
+    {
+        constexpr int sliceLength = 128;
+        const int maxSlices = static_cast<int>(2.0 * sampleRate) / sliceLength;
+
+        std::vector<float> sent;
+        juce::AudioBuffer<float> input(1, sliceLength);
+        juce::AudioBuffer<float> output(1, sliceLength);
+        juce::Random random(3);
+
+        for (int slice = 0; slice < maxSlices; ++slice)
+        {
+            const int start = slice * sliceLength;
+            for (int i = 0; i < sliceLength; ++i)
+            {
+                const int source = start + i - roundTrip;
+                input.setSample(0, i, roundTrip >= 0 && source >= 0 ? sent[static_cast<size_t>(source)] : 0.0f);
+            }
+
+            probe.listen(input, 1);
+
+            // quiet loops playing, which the probe mutes while it listens
+            for (int i = 0; i < sliceLength; ++i)
+                output.setSample(0, i, 0.01f * (random.nextFloat() - 0.5f));
+            probe.emit(output);
+
+            sent.insert(sent.end(), output.getReadPointer(0), output.getReadPointer(0) + sliceLength);
+
+            if (probe.takeResult(measured))
+                return true;
+        }
+        return false;
+    }
+};
+
+static LatencyCompensationTests latencyCompensationTests;
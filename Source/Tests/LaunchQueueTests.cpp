@@ -0,0 +1,265 @@
+#include <vector>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/LaunchQueue.h"
+#include "../Audio/LoopManager.h"
+#include "../Utils/AudioThreadGuard.h"
+
+class LaunchQueueTests : public juce::UnitTest
+{
+public:
+    LaunchQueueTests() : juce::UnitTest("LaunchQueueTests") {}
+
+    void runTest() override
+    {
+        using Action = LaunchQueue::Action;
+        using Quantize = LaunchQueue::Quantize;
+
+        auto makeEvent = [](Action action, int track, Quantize quantize)
+        {
+            LaunchQueue::Event event;
+            event.action = action;
+            event.track = track;
+            event.quantize = quantize;
+            return event;
+        };
+        auto noDrop = [this](const LaunchQueue::Event&) { expect(false, "Nothing should be dropped"); };
+
+        beginTest("Events come out in time order, queue order on ties");
+        {
+            LaunchQueue queue;
+            const std::vector<int> dueForTrack { 300, 100, 200, 100, 50 };
+            for (int track = 0; track < static_cast<int>(dueForTrack.size()); ++track)
+                expect(queue.push(makeEvent(Action::StartPlayback, track, Quantize::NextBeat)));
+
+            queue.collect([&](const LaunchQueue::Event& event) { return static_cast<juce::int64>(dueForTrack[static_cast<size_t>(event.track)]); },
+                          noDrop);
+            expectEquals(queue.getNumScheduled(), 5);
+            expectEquals(queue.getNextDueSample(), static_cast<juce::int64>(50));
+
+            LaunchQueue::Event event;
+            expect(!queue.popDue(49, event), "Nothing is due before the earliest event");
+
+            std::vector<int> order;
+            while (queue.popDue(1000, event))
+                order.push_back(event.track);
+            expect(order == std::vector<int> { 4, 1, 3, 2, 0 });
+            expectEquals(queue.getNextDueSample(), LaunchQueue::kNever);
+        }
+
+        beginTest("Rescheduling and cancelling");
+        {
+            LaunchQueue queue;
+            queue.push(makeEvent(Action::Clear, 0, Quantize::NextBar));
+            queue.push(makeEvent(Action::Clear, 1, Quantize::NextBar));
+            queue.collect([](const LaunchQueue::Event& event) { return juce::int64(1000 + event.track); }, noDrop);
+
+            queue.reschedule([](const LaunchQueue::Event& event) { return juce::int64(10 - event.track); });
+            expectEquals(queue.getNextDueSample(), static_cast<juce::int64>(9));
+
+            int dropped = 0;
+            auto countDrop = [&dropped](const LaunchQueue::Event&) { ++dropped; };
+            queue.push(makeEvent(Action::Clear, 2, Quantize::NextBar));
+            queue.cancelAll();
+            queue.collect([](const LaunchQueue::Event&) { return juce::int64(0); }, countDrop);
+            expectEquals(queue.getNumScheduled(), 0);
+            expectEquals(dropped, 3, "Scheduled and queued events are both handed back");
+            queue.collect([](const LaunchQueue::Event&) { return juce::int64(0); }, noDrop);
+            expectEquals(queue.getNumScheduled(), 0, "The cancelled inbox stays empty");
+
+            for (int i = 0; i < LaunchQueue::kCapacity; ++i)
+                queue.push(makeEvent(Action::Clear, 0, Quantize::Immediate));
+            expect(!queue.push(makeEvent(Action::Clear, 0, Quantize::Immediate)), "A full inbox refuses new events");
+        }
+
+        beginTest("A quantized launch lands on its exact sample inside a block");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 160;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setTempo(45000.0f);        // 64 samples per beat
+
+            LoopManager manager(sync, 2);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> input(2, blockSize);
+            input.clear();
+
+            manager.processBlock(input);
+            expectEquals(sync.getGlobalSample(), static_cast<juce::int64>(blockSize));
+
+            // armed at the block edge, recording from the next beat (sample 192)
+            expect(manager.armTrack(1, true));
+            expect(manager.scheduleLaunch(Action::StartRecording, 1, Quantize::NextBeat));
+            expect(!manager.scheduleLaunch(Action::StartRecording, 7, Quantize::NextBeat), "Unknown track");
+
+            manager.processBlock(input);
+            expect(manager.getTrack(1)->getState() == LoopTrack::State::Recording);
+            expectEquals(manager.getTrack(1)->getRecordingStartGlobalSample(), static_cast<juce::int64>(192));
+            expectEquals(manager.getTrack(1)->getLoopLengthSamples(), 128, "Recorded from the beat to the block end");
+            expect(manager.getTrack(0)->getState() == LoopTrack::State::Empty, "Other tracks are untouched");
+            expectEquals(manager.getNumScheduledLaunches(), 0);
+
+            // next bar after 320 is 512, two blocks on
+            expect(manager.scheduleLaunch(Action::StopRecording, LaunchQueue::kAllTracks, Quantize::NextBar));
+            manager.processBlock(input);
+            expectEquals(manager.getNumScheduledLaunches(), 1);
+            expect(manager.getTrack(1)->getState() == LoopTrack::State::Recording);
+            manager.processBlock(input);
+            expectEquals(manager.getNumScheduledLaunches(), 0);
+            expect(manager.getTrack(1)->getState() == LoopTrack::State::Playing);
+            expect(manager.getTrack(0)->getState() == LoopTrack::State::Empty, "Stop only touches recording tracks");
+        }
+
+        beginTest("Commands reach the tracks at the next block and players come back to be freed");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+
+            LoopManager manager(sync, 2);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> input(2, blockSize);
+            input.clear();
+
+            juce::AudioBuffer<float> loop(2, 480);
+            for (int ch = 0; ch < loop.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::fill(loop.getWritePointer(ch), 0.25f, loop.getNumSamples());
+
+            expect(manager.loadTrackAudio(0, loop, sampleRate));
+            expect(!manager.loadTrackAudio(5, loop, sampleRate), "Unknown track");
+            manager.armAllTracks(true);
+            expect(!manager.getTrack(0)->hasAudio() && !manager.isAnyTrackArmed(), "Nothing changes before the audio thread runs");
+
+            const auto previousMode = AudioThreadGuard::getMode();
+            AudioThreadGuard::setMode(AudioThreadGuard::Mode::Count);
+            AudioThreadGuard::resetViolations();
+            {
+                const AudioThreadGuard::ScopedRealtimeSection realtime;
+                manager.processBlock(input);
+            }
+            expect(manager.getTrack(0)->hasAudio());
+            expectEquals(manager.getTrack(0)->getAudioBuffer().getNumSamples(), 480);
+            expect(manager.getTrack(0)->isArmed() && manager.getTrack(1)->isArmed());
+            const auto& shownAudio = manager.getTrack(0)->getAudioBuffer();
+
+            manager.clearAllTracks();
+            {
+                const AudioThreadGuard::ScopedRealtimeSection realtime;
+                manager.processBlock(input);
+            }
+            expect(!manager.getTrack(0)->hasAudio(), "Clear swapped in an empty player");
+            expectEquals(shownAudio.getNumSamples(), 480, "Audio read on this thread is left as it was until reclaimed");
+            expectEquals(shownAudio.getSample(1, 479), 0.25f);
+            expect(manager.getTrack(0)->getState() == LoopTrack::State::Empty);
+            expectEquals(AudioThreadGuard::getNumViolations(), 0, "Swapping players neither allocates nor frees");
+            AudioThreadGuard::setMode(previousMode);
+
+            // the loaded player and the empty ones it replaced wait in the retire queue
+            manager.reclaimRetiredPlayers();
+        }
+
+        beginTest("A loop edit swaps in a new player and leaves held audio alone");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 2048;
+
+            // a stopped host at one beat per block: the take is one block, and nothing plays
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setHostSyncEnabled(true);
+            juce::AudioPlayHead::PositionInfo host;
+            host.setIsPlaying(false);
+            host.setTimeInSamples(0);
+            host.setBpm(sampleRate * 60.0 / blockSize);
+            sync.syncToHost(host);
+
+            LoopManager manager(sync, 1);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> input(2, blockSize);
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int s = 0; s < blockSize; ++s)
+                    input.setSample(ch, s, static_cast<float>(s) / static_cast<float>(blockSize));
+
+            auto* track = manager.getTrack(0);
+            track->armForRecording(true);
+            track->startRecording(0);
+            manager.processBlock(input);
+            track->stopRecording();
+            expectEquals(track->getLoopLengthSamples(), blockSize);
+
+            // what a save streams from while it holds the players
+            const auto& held = track->getAudioBuffer();
+            expectEquals(held.getNumSamples(), blockSize);
+            manager.holdRetiredPlayers();
+
+            input.clear();
+            expect(manager.scheduleLaunch(Action::Divide, 0));
+            manager.processBlock(input);
+            manager.reclaimRetiredPlayers();
+
+            expectEquals(track->getLoopLengthSamples(), blockSize / 2);
+            expectEquals(track->getAudioBuffer().getNumSamples(), blockSize / 2, "The edit is in the new player");
+            expectEquals(held.getNumSamples(), blockSize, "The held player kept its audio");
+            expectEquals(held.getSample(1, blockSize - 1), static_cast<float>(blockSize - 1) / static_cast<float>(blockSize));
+
+            manager.releaseRetiredPlayers();
+        }
+
+        beginTest("A save holding players through more edits than the retire list holds loses none");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+            constexpr int batchSize = 64;
+            constexpr int numSwaps = TrackConfig::RETIRED_PLAYER_CAPACITY + batchSize;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+
+            LoopManager manager(sync, 1);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> input(2, blockSize);
+            input.clear();
+
+            juce::AudioBuffer<float> loop(2, 480);
+            loop.clear();
+            expect(manager.loadTrackAudio(0, loop, sampleRate));
+            manager.processBlock(input);
+            manager.reclaimRetiredPlayers();
+
+            auto* track = manager.getTrack(0);
+            const auto& held = track->getAudioBuffer();
+            manager.holdRetiredPlayers();
+
+            for (int swap = 0; swap < numSwaps;)
+            {
+                for (int i = 0; i < batchSize; ++i, ++swap)
+                {
+                    loop.setSample(0, 0, static_cast<float>(swap + 1));
+                    expect(manager.loadTrackAudio(0, loop, sampleRate));
+                }
+                manager.processBlock(input);
+            }
+            manager.reclaimRetiredPlayers();
+
+            expectEquals(manager.getNumScheduledLaunches(), 0, "No edit was refused or left waiting");
+            expect(!manager.takeLaunchesHeldBack(), "Reclaiming kept the list from filling");
+            expectEquals(track->getAudioBuffer().getSample(0, 0), static_cast<float>(numSwaps), "The last edit plays");
+            expectEquals(static_cast<int>(manager.getNumRetiredPlayers()), numSwaps, "Every swapped-out player is kept");
+            expectEquals(held.getNumSamples(), 480, "The held player kept its audio");
+
+            manager.releaseRetiredPlayers();
+            expectEquals(static_cast<int>(manager.getNumRetiredPlayers()), 0, "The release frees them all");
+        }
+    }
+};
+
+static LaunchQueueTests launchQueueTests;
@@ -35,7 +35,7 @@ public:
 static juce::AudioProcessorValueTreeState::ParameterLayout createMixerLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
     {
         const auto prefix = "Track" + juce::String(i + 1) + "_";
         layout.add(std::make_unique<juce::AudioParameterFloat>(
@@ -120,8 +120,16 @@ public:
         loopManager.processBlock(silentInput);
 
         juce::AudioBuffer<float> masterOutput(numChannels, blockSize);
-        masterOutput.clear();
-        mixer.process(loopManager.getTrackOutputs(), masterOutput);
+
+        // The master limiter delays the mix by its lookahead, which is longer than one block.
+        const int latencyBlocks = mixer.getLatencySamples() / blockSize + 1;
+        for (int block = 0; block < latencyBlocks; ++block)
+        {
+            if (block > 0)
+                loopManager.processBlock(silentInput);
+            masterOutput.clear();
+            mixer.process(loopManager.getTrackOutputs(), masterOutput);
+        }
 
         float peak = 0.0f;
         for (int ch = 0; ch < masterOutput.getNumChannels(); ++ch)
@@ -134,11 +142,17 @@ public:
 
         beginTest("Mixer APVTS mute/solo policy owns final audibility");
 
+        // Mute/solo changes fade through the mixer gain ramp, so let it settle first.
+        constexpr int settleBlocks = 16;
+
         auto renderMixedPeak = [&]() -> float
         {
-            loopManager.processBlock(silentInput);
-            masterOutput.clear();
-            mixer.process(loopManager.getTrackOutputs(), masterOutput);
+            for (int block = 0; block < settleBlocks; ++block)
+            {
+                loopManager.processBlock(silentInput);
+                masterOutput.clear();
+                mixer.process(loopManager.getTrackOutputs(), masterOutput);
+            }
 
             float renderedPeak = 0.0f;
             for (int ch = 0; ch < masterOutput.getNumChannels(); ++ch)
@@ -170,6 +184,64 @@ public:
         setTrackMuteSolo(apvts, 0, false, true);
         const float ownSoloPeak = renderMixedPeak();
         expect(ownSoloPeak > 0.01f, "Soloing this track in APVTS should restore audibility.");
+
+        beginTest("Idle and silent tracks publish no output to the mixer");
+
+        loopManager.processBlock(silentInput);
+        expect(loopManager.isTrackActiveThisBlock(0), "Playing track should be active.");
+        expect(!loopManager.isTrackActiveThisBlock(1), "Empty, unarmed track should be idle.");
+        expect(loopManager.getTrackOutputs()[1] == nullptr, "Idle track output should be skipped by the mixer.");
+
+        // Armed tracks monitor input, but a silent input is still digital silence
+        loopManager.getTrack(1)->armForRecording(true);
+        loopManager.processBlock(silentInput);
+        expect(!loopManager.isTrackActiveThisBlock(1), "Monitoring silence should not mark the track active.");
+
+        loopManager.processBlock(recordedInput);
+        expect(loopManager.isTrackActiveThisBlock(1), "Monitoring a live signal should mark the track active.");
+        loopManager.getTrack(1)->armForRecording(false);
+
+        expect(loopManager.getNumTracksActiveThisBlock() == 2, "Active count should follow the processed tracks.");
+
+        beginTest("Direct outputs receive the track render without a copy");
+
+        juce::AudioBuffer<float> directBus(numChannels, blockSize);
+        juce::AudioBuffer<float> idleBus(numChannels, blockSize);
+        fillBuffer(idleBus, 0.5f);      // hosts may hand over stale data
+
+        loopManager.setTrackDirectOutput(0, directBus.getArrayOfWritePointers(), numChannels, blockSize);
+        loopManager.setTrackDirectOutput(2, idleBus.getArrayOfWritePointers(), numChannels, blockSize);
+        loopManager.processBlock(silentInput);
+
+        const auto directOutputs = loopManager.getTrackOutputs();
+        expect(directOutputs[0] != nullptr
+               && directOutputs[0]->getReadPointer(0) == directBus.getReadPointer(0),
+               "Mixer should read the track straight from its direct output.");
+        expect(directBus.getMagnitude(0, blockSize) > 0.01f, "Direct output should carry the track.");
+        expect(idleBus.getMagnitude(0, blockSize) == 0.0f, "Idle track should still clear its direct output.");
+
+        masterOutput.clear();
+        mixer.process(directOutputs, masterOutput);
+        expect(masterOutput.getMagnitude(0, blockSize) > 0.01f, "Track should still reach the master.");
+
+        loopManager.clearTrackDirectOutput(0);
+        loopManager.clearTrackDirectOutput(2);
+        loopManager.processBlock(silentInput);
+        expect(loopManager.getTrackOutputs()[0]->getReadPointer(0) != directBus.getReadPointer(0),
+               "Cleared direct output should fall back to the internal buffer.");
+
+        beginTest("Track count is set when the LoopManager is created");
+
+        LoopManager largeManager(sync, 64);
+        largeManager.prepareToPlay(sampleRate, blockSize, numChannels);
+        expect(largeManager.getNumTracks() == 64, "All requested tracks should be created.");
+        expect(largeManager.getTrack(63) != nullptr, "Last track should be addressable.");
+        expect(largeManager.getTrack(64) == nullptr, "Tracks past the count should not exist.");
+        expect(largeManager.getTrackOutputs().size() == 64, "Mixer should see one output slot per track.");
+
+        LoopManager oversizedManager(sync, TrackConfig::MAX_TRACKS * 2);
+        expect(oversizedManager.getNumTracks() == static_cast<size_t>(TrackConfig::MAX_TRACKS),
+               "Track count should be clamped to the supported maximum.");
     }
 };
 
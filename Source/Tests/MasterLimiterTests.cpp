@@ -0,0 +1,87 @@
+#include <cmath>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/MasterLimiter.h"
+
+class MasterLimiterTests : public juce::UnitTest
+{
+public:
+    MasterLimiterTests() : juce::UnitTest("MasterLimiterTests") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 64;
+        const float ceiling = juce::Decibels::decibelsToGain(TrackConfig::LIMITER_CEILING_DB);
+
+        beginTest("quiet signal passes through delayed by the reported latency");
+        {
+            MasterLimiter limiter;
+            limiter.prepare(sampleRate, blockSize, 2);
+            const int latency = limiter.getLatencySamples();
+            expect(latency > 0, "Lookahead should add latency.");
+
+            constexpr int totalSamples = blockSize * 8;
+            juce::AudioBuffer<float> input(2, totalSamples);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int s = 0; s < totalSamples; ++s)
+                    input.setSample(ch, s, 0.25f * std::sin(0.01f * static_cast<float>(s)));
+
+            juce::AudioBuffer<float> output(input);
+            for (int start = 0; start < totalSamples; start += blockSize)
+            {
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, blockSize);
+                limiter.process(block);
+            }
+
+            float maxError = 0.0f;
+            for (int s = latency; s < totalSamples; ++s)
+                maxError = juce::jmax(maxError, std::abs(output.getSample(0, s) - input.getSample(0, s - latency)));
+            expect(maxError < 1.0e-5f, "Signal below the ceiling should be untouched, max error " + juce::String(maxError));
+        }
+
+        beginTest("inter-sample peaks are caught");
+        {
+            MasterLimiter limiter;
+            limiter.prepare(sampleRate, blockSize, 1);
+
+            // fs/4 sine at 45 degrees: every sample is at 0.707 of the true peak
+            constexpr float amplitude = 1.2f;
+            constexpr int totalSamples = blockSize * 16;
+            juce::AudioBuffer<float> buffer(1, totalSamples);
+            for (int s = 0; s < totalSamples; ++s)
+                buffer.setSample(0, s, amplitude * std::sin(juce::MathConstants<float>::halfPi * static_cast<float>(s)
+                                                            + juce::MathConstants<float>::pi * 0.25f));
+
+            expect(buffer.getMagnitude(0, totalSamples) < ceiling, "Sample peaks alone sit under the ceiling.");
+
+            for (int start = 0; start < totalSamples; start += blockSize)
+            {
+                juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 1, start, blockSize);
+                limiter.process(block);
+            }
+
+            // once settled, the reconstructed peak (sample peak / 0.707) must respect the ceiling
+            const float settledPeak = buffer.getMagnitude(totalSamples - blockSize, blockSize);
+            expect(settledPeak * juce::MathConstants<float>::sqrt2 <= ceiling * 1.02f,
+                   "True peak should be limited, got " + juce::String(settledPeak * juce::MathConstants<float>::sqrt2));
+        }
+
+        beginTest("oversized host blocks are processed without reallocating");
+        {
+            MasterLimiter limiter;
+            limiter.prepare(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> buffer(2, blockSize * 3 + 5);
+            buffer.clear();
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 4.0f, buffer.getNumSamples());
+
+            limiter.process(buffer);
+            expect(buffer.getMagnitude(0, buffer.getNumSamples()) <= ceiling + 0.0001f, "Output should stay under the ceiling.");
+        }
+    }
+};
+
+static MasterLimiterTests masterLimiterTests;
@@ -0,0 +1,168 @@
+/**
+ * Fused mix kernel vs. the previous four-pass mixer path
+ * (copy -> gain ramp -> pan -> sum) at 4, 16 and 64 tracks.
+ * Timings are logged; correctness of the fused path is asserted.
+ */
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+#include "../Audio/MixKernel.h"
+
+class MixKernelBenchmarks : public juce::UnitTest
+{
+public:
+    MixKernelBenchmarks() : juce::UnitTest("MixKernelBenchmarks") {}
+
+    void runTest() override
+    {
+        for (int numTracks : { 4, 16, 64 })
+        {
+            beginTest("fused kernel vs four-pass mix, " + juce::String(numTracks) + " tracks");
+            runComparison(numTracks);
+        }
+    }
+
+private:
+    static constexpr int kBlockSize = 256;
+    static constexpr int kLoopLength = 48000 + 37;   // odd length so reads wrap mid-block
+    static constexpr int kNumBlocks = 400;
+    static constexpr double kSampleRate = 48000.0;
+
+    struct TrackSetup
+    {
+        juce::AudioBuffer<float> source;
+        MixKernel::ChannelRamps ramps;      // gain and pan folded together, for the fused kernel
+        MixKernel::Ramp gain;               // the old path's separate gain ramp and panner
+        juce::dsp::Panner<float> panner;
+    };
+
+    static std::vector<TrackSetup> makeTracks(int numTracks)
+    {
+        juce::Random random(1234);
+        std::vector<TrackSetup> tracks(static_cast<size_t>(numTracks));
+
+        for (int t = 0; t < numTracks; ++t)
+        {
+            auto& track = tracks[static_cast<size_t>(t)];
+            // every fourth track is mono to cover the replication path
+            track.source.setSize(t % 4 == 3 ? 1 : 2, kLoopLength);
+            for (int ch = 0; ch < track.source.getNumChannels(); ++ch)
+            {
+                auto* data = track.source.getWritePointer(ch);
+                for (int s = 0; s < kLoopLength; ++s)
+                    data[s] = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            const float pan = random.nextFloat() * 2.0f - 1.0f;
+            float left = 1.0f;
+            float right = 1.0f;
+            MixKernel::computePanGains(pan, left, right);
+            const float gainStart = random.nextFloat();
+            const float gainEnd = (t % 2 == 0) ? gainStart : random.nextFloat();
+            track.ramps[0] = { gainStart * left, gainEnd * left };
+            track.ramps[1] = { gainStart * right, gainEnd * right };
+
+            // the panner as MixerEngine used to run it, settled at this track's pan
+            track.gain = { gainStart, gainEnd };
+            track.panner.setRule(juce::dsp::PannerRule::squareRoot3dB);
+            track.panner.prepare({ kSampleRate, static_cast<juce::uint32>(kBlockSize), 2 });
+            track.panner.setPan(pan);
+            track.panner.reset();
+        }
+        return tracks;
+    }
+
+    /** The pre-fusion mixer path, kept here as a reference. */
+    static void mixFourPass(std::vector<TrackSetup>& tracks,
+                            juce::AudioBuffer<float>& working,
+                            std::vector<float>& ramp,
+                            juce::AudioBuffer<float>& master,
+                            std::int64_t blockStart)
+    {
+        const int numSamples = master.getNumSamples();
+        master.clear();
+
+        for (auto& track : tracks)
+        {
+            const auto& source = track.source;
+            const int sourceStart = static_cast<int>(blockStart % source.getNumSamples());
+            const int block1 = juce::jmin(numSamples, source.getNumSamples() - sourceStart);
+            const int block2 = numSamples - block1;
+
+            // pass 1: clear + copy
+            working.clear();
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                const int srcCh = source.getNumChannels() == 1 ? 0 : ch;
+                working.copyFrom(ch, 0, source, srcCh, sourceStart, block1);
+                if (block2 > 0)
+                    working.copyFrom(ch, block1, source, srcCh, 0, block2);
+            }
+
+            // pass 2: gain ramp
+            MixKernel::fillRamp(ramp.data(), track.gain, numSamples);
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::multiply(working.getWritePointer(ch), ramp.data(), numSamples);
+
+            // pass 3: pan
+            juce::dsp::AudioBlock<float> block(working);
+            track.panner.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+            // pass 4: sum into master
+            for (int ch = 0; ch < 2; ++ch)
+                master.addFrom(ch, 0, working, ch, 0, numSamples);
+        }
+    }
+
+    static void mixFused(std::vector<TrackSetup>& tracks,
+                         std::vector<float>& ramp,
+                         juce::AudioBuffer<float>& master,
+                         std::int64_t blockStart)
+    {
+        master.clear();
+        for (auto& track : tracks)
+            MixKernel::accumulateTrack(track.source, master, master.getNumSamples(),
+                                       blockStart, track.ramps, ramp.data());
+    }
+
+    void runComparison(int numTracks)
+    {
+        auto tracks = makeTracks(numTracks);
+        juce::AudioBuffer<float> working(2, kBlockSize);
+        juce::AudioBuffer<float> referenceOut(2, kBlockSize);
+        juce::AudioBuffer<float> fusedOut(2, kBlockSize);
+        std::vector<float> ramp(static_cast<size_t>(kBlockSize));
+
+        // correctness, including a block that straddles the loop end
+        const std::int64_t wrapStart = kLoopLength - kBlockSize / 2;
+        mixFourPass(tracks, working, ramp, referenceOut, wrapStart);
+        mixFused(tracks, ramp, fusedOut, wrapStart);
+
+        float maxError = 0.0f;
+        for (int ch = 0; ch < 2; ++ch)
+            for (int s = 0; s < kBlockSize; ++s)
+                maxError = juce::jmax(maxError, std::abs(referenceOut.getSample(ch, s) - fusedOut.getSample(ch, s)));
+        expect(maxError < 1.0e-4f, "fused kernel should match the four-pass mix, max error " + juce::String(maxError));
+
+        auto timeIt = [&](auto&& mixBlock)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int block = 0; block < kNumBlocks; ++block)
+                mixBlock(static_cast<std::int64_t>(block) * kBlockSize);
+            return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        };
+
+        const double fourPassSeconds = timeIt([&](std::int64_t pos) { mixFourPass(tracks, working, ramp, referenceOut, pos); });
+        const double fusedSeconds = timeIt([&](std::int64_t pos) { mixFused(tracks, ramp, fusedOut, pos); });
+
+        const double perBlockFourPass = fourPassSeconds * 1.0e6 / kNumBlocks;
+        const double perBlockFused = fusedSeconds * 1.0e6 / kNumBlocks;
+        logMessage(juce::String(numTracks) + " tracks: four-pass " + juce::String(perBlockFourPass, 2)
+                   + " us/block, fused " + juce::String(perBlockFused, 2) + " us/block, speedup x"
+                   + juce::String(fusedSeconds > 0.0 ? fourPassSeconds / fusedSeconds : 0.0, 2));
+    }
+};
+
+static MixKernelBenchmarks mixKernelBenchmarks;
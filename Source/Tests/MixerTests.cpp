@@ -1,5 +1,6 @@
 #include <atomic>
 #include <cmath>
+#include <thread>
 #include <vector>
 
 #include <juce_audio_processors/juce_audio_processors.h>
@@ -33,10 +34,10 @@ public:
     void setStateInformation(const void*, int) override {}
 };
 
-static juce::AudioProcessorValueTreeState::ParameterLayout createMockLayout()
+static juce::AudioProcessorValueTreeState::ParameterLayout createMockLayout(int numTracks = TrackConfig::DEFAULT_NUM_TRACKS)
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    for (int i = 0; i < numTracks; ++i)
     {
         const auto prefix = "Track" + juce::String(i + 1) + "_";
         layout.add(std::make_unique<juce::AudioParameterFloat>(
@@ -105,11 +106,18 @@ static void fillBuffer(juce::AudioBuffer<float>& buffer, float value)
     }
 }
 
+// Goes through the parameter like a host or attachment would, so the mixer's listener sees it.
+static void setParam(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value)
+{
+    if (auto* param = apvts.getParameter(id))
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
 static void setTrackParams(juce::AudioProcessorValueTreeState& apvts, int track, float volume, float pan)
 {
     const auto prefix = "Track" + juce::String(track + 1) + "_";
-    apvts.getRawParameterValue(prefix + "Volume")->store(volume);
-    apvts.getRawParameterValue(prefix + "Pan")->store(pan);
+    setParam(apvts, prefix + "Volume", volume);
+    setParam(apvts, prefix + "Pan", pan);
 }
 
 static void setTrackMuteSolo(juce::AudioProcessorValueTreeState& apvts, int track, bool mute, bool solo)
@@ -130,21 +138,22 @@ public:
 
     void runTest() override
     {
-        beginTest("sums four tracks into stereo master with headroom");
+        beginTest("sums four tracks into stereo master");
         {
             DummyProcessor proc;
             juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 64);
 
             std::vector<juce::AudioBuffer<float>> trackStorage;
-            trackStorage.reserve(TrackConfig::MAX_TRACKS);
+            trackStorage.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
             std::vector<juce::AudioBuffer<float>*> inputs;
-            inputs.reserve(TrackConfig::MAX_TRACKS);
+            inputs.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
             {
                 setTrackParams(apvts, i, 1.0f, 0.0f);
                 trackStorage.emplace_back(2, 64);
@@ -162,8 +171,8 @@ public:
             const float leftSample = output.getSample(0, 0);
             const float rightSample = output.getSample(1, 0);
 
-            expectWithinAbsoluteError(leftSample, 1.0f, 0.02f, "Expected 4x track sum scaled by 0.25 headroom.");
-            expectWithinAbsoluteError(rightSample, 1.0f, 0.02f, "Expected center-panned stereo sum on right channel.");
+            expectWithinAbsoluteError(leftSample, 4.0f, 0.02f, "Expected unscaled 4x track sum.");
+            expectWithinAbsoluteError(rightSample, 4.0f, 0.02f, "Expected center-panned stereo sum on right channel.");
         }
 
         beginTest("applies track gain and pan before summing");
@@ -173,14 +182,15 @@ public:
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 64);
 
             std::vector<juce::AudioBuffer<float>> trackStorage;
-            trackStorage.reserve(TrackConfig::MAX_TRACKS);
+            trackStorage.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
             std::vector<juce::AudioBuffer<float>*> inputs;
-            inputs.reserve(TrackConfig::MAX_TRACKS);
+            inputs.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
             {
                 trackStorage.emplace_back(2, 64);
                 fillBuffer(trackStorage.back(), 1.0f);
@@ -225,9 +235,10 @@ public:
             MixerEngine mixer;
             mixer.attachParameters(apvts);
             mixer.setGlobalSampleCounter(&sampleCounter);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 4);
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
                 setTrackParams(apvts, i, i == 0 ? 1.0f : 0.0f, -1.0f);
 
             juce::AudioBuffer<float> longTrack(2, 16);
@@ -239,9 +250,9 @@ public:
             }
 
             std::vector<juce::AudioBuffer<float>*> inputs;
-            inputs.reserve(TrackConfig::MAX_TRACKS);
+            inputs.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
             inputs.push_back(&longTrack);
-            for (int i = 1; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 1; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
                 inputs.push_back(nullptr);
 
             juce::AudioBuffer<float> output(2, 4);
@@ -251,13 +262,13 @@ public:
                 mixer.process(inputs, output);
             }
 
-            expectWithinAbsoluteError(output.getSample(0, 0), 0.15f, 0.02f, "Expected sample 6 scaled by headroom.");
-            expectWithinAbsoluteError(output.getSample(0, 1), 0.175f, 0.02f, "Expected sample 7 scaled by headroom.");
-            expectWithinAbsoluteError(output.getSample(0, 2), 0.2f, 0.02f, "Expected sample 8 scaled by headroom.");
-            expectWithinAbsoluteError(output.getSample(0, 3), 0.225f, 0.02f, "Expected sample 9 scaled by headroom.");
+            expectWithinAbsoluteError(output.getSample(0, 0), 0.6f, 0.02f, "Expected sample 6.");
+            expectWithinAbsoluteError(output.getSample(0, 1), 0.7f, 0.02f, "Expected sample 7.");
+            expectWithinAbsoluteError(output.getSample(0, 2), 0.8f, 0.02f, "Expected sample 8.");
+            expectWithinAbsoluteError(output.getSample(0, 3), 0.9f, 0.02f, "Expected sample 9.");
         }
 
-        beginTest("hard clips master output to [-1, 1]");
+        beginTest("master limiter holds hot output under the ceiling");
         {
             DummyProcessor proc;
             juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
@@ -265,13 +276,14 @@ public:
             MixerEngine mixer;
             mixer.attachParameters(apvts);
             mixer.prepare(48000.0, 64);
+            expect(mixer.getLatencySamples() > 0, "Limiter lookahead should be reported as latency.");
 
             std::vector<juce::AudioBuffer<float>> trackStorage;
-            trackStorage.reserve(TrackConfig::MAX_TRACKS);
+            trackStorage.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
             std::vector<juce::AudioBuffer<float>*> inputs;
-            inputs.reserve(TrackConfig::MAX_TRACKS);
+            inputs.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
             {
                 setTrackParams(apvts, i, 1.0f, 0.0f);
                 trackStorage.emplace_back(2, 64);
@@ -279,43 +291,31 @@ public:
                 inputs.push_back(&trackStorage.back());
             }
 
-            juce::AudioBuffer<float> output(2, 64);
-            output.clear();
-            mixer.process(inputs, output);
-
-            float maxValue = -1000.0f;
-            float minValue = 1000.0f;
-            for (int channel = 0; channel < output.getNumChannels(); ++channel)
+            const float ceiling = juce::Decibels::decibelsToGain(TrackConfig::LIMITER_CEILING_DB);
+            auto renderPeak = [&]()
             {
-                for (int sample = 0; sample < output.getNumSamples(); ++sample)
+                juce::AudioBuffer<float> output(2, 64);
+                float peak = 0.0f;
+                for (int block = 0; block < 8; ++block)
                 {
-                    const float value = output.getSample(channel, sample);
-                    maxValue = juce::jmax(maxValue, value);
-                    minValue = juce::jmin(minValue, value);
+                    output.clear();
+                    mixer.process(inputs, output);
+                    peak = juce::jmax(peak, output.getMagnitude(0, output.getNumSamples()));
                 }
-            }
-            expect(maxValue <= 1.0001f, "Positive clipping should cap at +1.0");
-            expect(minValue >= -1.0001f, "Positive clipping should stay above -1.0");
+                return peak;
+            };
+
+            const float positivePeak = renderPeak();
+            expect(positivePeak <= ceiling + 0.0001f, "Positive overs should be limited to the ceiling");
+            expect(positivePeak > ceiling * 0.5f, "Limiting should not crush the output");
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
                 fillBuffer(trackStorage[i], -10.0f);
 
-            output.clear();
-            mixer.process(inputs, output);
+            expect(renderPeak() <= ceiling + 0.0001f, "Negative overs should be limited to the ceiling");
 
-            maxValue = -1000.0f;
-            minValue = 1000.0f;
-            for (int channel = 0; channel < output.getNumChannels(); ++channel)
-            {
-                for (int sample = 0; sample < output.getNumSamples(); ++sample)
-                {
-                    const float value = output.getSample(channel, sample);
-                    maxValue = juce::jmax(maxValue, value);
-                    minValue = juce::jmin(minValue, value);
-                }
-            }
-            expect(minValue >= -1.0001f, "Negative clipping should cap at -1.0");
-            expect(maxValue <= 1.0001f, "Negative clipping should stay below +1.0");
+            mixer.setMasterLimiterEnabled(false);
+            expect(mixer.getLatencySamples() == 0, "Bypassed limiter should report no latency.");
         }
     }
 };
@@ -337,8 +337,7 @@ public:
         mixer.attachParameters(apvts);
         mixer.prepare(48000.0, 32);
 
-        apvts.getRawParameterValue("Track2_Volume")->store(0.2f);
-        apvts.getRawParameterValue("Track2_Pan")->store(-0.5f);
+        setTrackParams(apvts, 1, 0.2f, -0.5f);
 
         juce::AudioBuffer<float> out(2, 32);
         juce::AudioBuffer<float> track0(2, 32);
@@ -348,8 +347,8 @@ public:
 
         mixer.process(inputs, out);
 
-        expect(mixer.getLastVolDb(1) == 0.2f);
-        expect(mixer.getLastPan(1) == -0.5f);
+        expectWithinAbsoluteError(mixer.getLastVolDb(1), 0.2f, 1.0e-6f);
+        expectWithinAbsoluteError(mixer.getLastPan(1), -0.5f, 1.0e-6f);
 
         beginTest("missing pan param does not crash");
         DummyProcessor proc2;
@@ -358,7 +357,7 @@ public:
         mixerMissing.attachParameters(apvtsMissing);
         mixerMissing.prepare(48000.0, 32);
 
-        apvtsMissing.getRawParameterValue("Track1_Volume")->store(0.7f);
+        setParam(apvtsMissing, "Track1_Volume", 0.7f);
         juce::AudioBuffer<float> out2(2, 32);
         juce::AudioBuffer<float> t2(2, 32);
         fillBuffer(t2, 1.0f);
@@ -366,21 +365,19 @@ public:
         inputs2.push_back(&t2);
         mixerMissing.process(inputs2, out2);
 
-        expect(mixerMissing.getLastVolDb(0) == 0.7f);
+        expectWithinAbsoluteError(mixerMissing.getLastVolDb(0), 0.7f, 1.0e-6f);
         expect(mixerMissing.getLastPan(0) == 0.0f);
 
         beginTest("inputs smaller than tracks");
-        apvts.getRawParameterValue("Track1_Volume")->store(0.3f);
-        apvts.getRawParameterValue("Track1_Pan")->store(0.1f);
-        apvts.getRawParameterValue("Track2_Volume")->store(0.9f);
-        apvts.getRawParameterValue("Track2_Pan")->store(0.0f);
+        setTrackParams(apvts, 0, 0.3f, 0.1f);
+        setTrackParams(apvts, 1, 0.9f, 0.0f);
 
         std::vector<juce::AudioBuffer<float>*> inputsOnly1;
         inputsOnly1.push_back(&track0);
         mixer.process(inputsOnly1, out);
 
-        expect(mixer.getLastVolDb(0) == 0.3f);
-        expect(mixer.getLastVolDb(1) == 0.9f);
+        expectWithinAbsoluteError(mixer.getLastVolDb(0), 0.3f, 1.0e-6f);
+        expectWithinAbsoluteError(mixer.getLastVolDb(1), 0.9f, 1.0e-6f);
     }
 };
 
@@ -400,6 +397,7 @@ public:
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);  
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 32);
 
             setTrackParams(apvts, 0, 1.0f, 0.0f);    
@@ -420,8 +418,8 @@ public:
 
             expect(!mixer.getIsAnyTrackSoloed(), " No solo buttons are active, so global solo state should be false .");
 
-            expectWithinAbsoluteError(out.getSample(0, 0), 0.25f, 0.02f, "Only one unmuted track should contribute");
-            expectWithinAbsoluteError(out.getSample(1, 0), 0.25f, 0.02f, "only one unmuted track should contribute.");
+            expectWithinAbsoluteError(out.getSample(0, 0), 1.0f, 0.02f, "Only one unmuted track should contribute");
+            expectWithinAbsoluteError(out.getSample(1, 0), 1.0f, 0.02f, "only one unmuted track should contribute.");
 
         }
 
@@ -432,6 +430,7 @@ public:
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 32);
 
             setTrackParams(apvts, 0, 1.0f, 0.0f);
@@ -452,8 +451,8 @@ public:
 
             expect(mixer.getIsAnyTrackSoloed(), " Solo listener should raise global solo state. ");
 
-            expectWithinAbsoluteError(out.getSample(0, 0), 0.25f, 0.02f, "soloed track should pass while non-solo track is ignored");
-            expectWithinAbsoluteError(out.getSample(1, 0), 0.25f, 0.02f, "Soloed track should pass while non-solo track is ignored");
+            expectWithinAbsoluteError(out.getSample(0, 0), 1.0f, 0.02f, "soloed track should pass while non-solo track is ignored");
+            expectWithinAbsoluteError(out.getSample(1, 0), 1.0f, 0.02f, "Soloed track should pass while non-solo track is ignored");
         }
     }
 };
@@ -474,21 +473,22 @@ public:
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 16);
 
             std::vector<juce::AudioBuffer<float>> trackStorage;
             std::vector<juce::AudioBuffer<float>*> inputs;
-            trackStorage.reserve(TrackConfig::MAX_TRACKS);
-            inputs.reserve(TrackConfig::MAX_TRACKS);
+            trackStorage.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
+            inputs.reserve(TrackConfig::DEFAULT_NUM_TRACKS);
 
-            for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
             {
                 setTrackParams(apvts, i, 1.0f, 0.0f);
                 trackStorage.emplace_back(2, 16);
                 inputs.push_back(&trackStorage.back());
             }
 
-            for (int track = 0; track < TrackConfig::MAX_TRACKS; ++track)
+            for (int track = 0; track < TrackConfig::DEFAULT_NUM_TRACKS; ++track)
             {
                 for (int ch = 0; ch < 2; ++ch)
                 {
@@ -505,10 +505,10 @@ public:
             for (int s = 0; s < 16; ++s)
             {
                 float sum = 0.0f;
-                for (int track = 0; track < TrackConfig::MAX_TRACKS; ++track)
+                for (int track = 0; track < TrackConfig::DEFAULT_NUM_TRACKS; ++track)
                     sum += trackStorage[static_cast<size_t>(track)].getSample(0, s);
 
-                const float expected = juce::jlimit(-1.0f, 1.0f, sum * MixerEngine::kDefaultHeadroomScale);
+                const float expected = sum;
                 expectWithinAbsoluteError(output.getSample(0, s), expected, 0.0001f);
                 expectWithinAbsoluteError(output.getSample(1, s), expected, 0.0001f);
             }
@@ -521,6 +521,7 @@ public:
 
             MixerEngine mixer;
             mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
             mixer.prepare(48000.0, 64);
 
             juce::AudioBuffer<float> track0(2, 64);
@@ -549,9 +550,435 @@ public:
 
             expect(middle > first, "expected ramped gain to increase through the block.");
             expect(last > middle, "Expected end of block to be louder than middle..");
-            expect(last <= 0.26f, " Headroom should keep single-track output around 0.25 max");
+            expect(last <= 1.01f, "Single unity track should not exceed unity gain");
         }
     }
 };
 
 static MixerTask34Tests mixerTask34Tests;
+
+class MixerGainStageTests : public juce::UnitTest
+{
+public:
+    MixerGainStageTests() : juce::UnitTest("MixerGainStageTests") {}
+
+    void runTest() override
+    {
+        beginTest("track trim folds into the mixer gain ramp");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 32);
+
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
+                setTrackParams(apvts, i, i == 0 ? 0.5f : 0.0f, 0.0f);
+            mixer.setTrackTrimGain(0, 0.5f);
+
+            juce::AudioBuffer<float> track0(2, 32);
+            fillBuffer(track0, 1.0f);
+            std::vector<juce::AudioBuffer<float>*> inputs { &track0 };
+
+            juce::AudioBuffer<float> out(2, 32);
+            mixer.process(inputs, out);
+
+            const float expected = 0.5f * 0.5f;
+            expectWithinAbsoluteError(out.getSample(0, 0), expected, 0.0001f, "fader * trim");
+            expectWithinAbsoluteError(out.getSample(1, 31), expected, 0.0001f, "fader * trim");
+        }
+
+        beginTest("mute fades out through the ramp instead of cutting");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 64);
+
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
+                setTrackParams(apvts, i, i == 0 ? 1.0f : 0.0f, 0.0f);
+
+            juce::AudioBuffer<float> track0(2, 64);
+            fillBuffer(track0, 1.0f);
+            std::vector<juce::AudioBuffer<float>*> inputs { &track0 };
+
+            juce::AudioBuffer<float> out(2, 64);
+            mixer.process(inputs, out);
+
+            setTrackMuteSolo(apvts, 0, true, false);
+            mixer.process(inputs, out);
+
+            const float first = out.getSample(0, 0);
+            const float last = out.getSample(0, 63);
+            expect(first > last, "muted track should ramp down across the block");
+            expect(last > 0.0f, "a single block should not hard-cut the track");
+
+            for (int i = 0; i < 16; ++i)
+                mixer.process(inputs, out);
+
+            expectWithinAbsoluteError(out.getSample(0, 63), 0.0f, 0.0001f, "fade should settle at silence");
+        }
+    }
+};
+
+static MixerGainStageTests mixerGainStageTests;
+
+class MixerTrackCountTests : public juce::UnitTest
+{
+public:
+    MixerTrackCountTests() : juce::UnitTest("MixerTrackCountTests") {}
+
+    void runTest() override
+    {
+        beginTest("smoothed value bank matches LinearSmoothedValue");
+        {
+            SmoothedValueBank bank;
+            bank.resize(3, 1.0f);
+            bank.reset(48000.0, 0.01);
+
+            juce::LinearSmoothedValue<float> reference;
+            reference.reset(48000.0, 0.01);
+            reference.setCurrentAndTargetValue(1.0f);
+
+            const float targets[] = { 0.0f, 0.0f, 0.5f, 0.5f, 1.0f, 0.25f, 0.25f, 0.25f };
+            float maxError = 0.0f;
+            for (const float target : targets)
+            {
+                bank.setTargetValue(1, target);
+                reference.setTargetValue(target);
+                maxError = juce::jmax(maxError, std::abs(bank.skip(1, 128) - reference.skip(128)));
+            }
+
+            expect(maxError < 1.0e-6f, "bank should ramp exactly like LinearSmoothedValue");
+            expectEquals(bank.getCurrentValue(0), 1.0f);
+            expectEquals(bank.getCurrentValue(2), 1.0f);
+        }
+
+        beginTest("mixer sums a 64-track project");
+        {
+            constexpr int numTracks = 64;
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout(numTracks));
+
+            MixerEngine mixer(numTracks);
+            expectEquals(static_cast<int>(mixer.getNumTracks()), numTracks);
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 64);
+
+            std::vector<juce::AudioBuffer<float>> trackStorage;
+            trackStorage.reserve(numTracks);
+            std::vector<juce::AudioBuffer<float>*> inputs;
+
+            for (int i = 0; i < numTracks; ++i)
+            {
+                setTrackParams(apvts, i, 1.0f, 0.0f);
+                trackStorage.emplace_back(2, 64);
+                fillBuffer(trackStorage.back(), 1.0f / numTracks);
+                inputs.push_back(&trackStorage.back());
+            }
+
+            juce::AudioBuffer<float> output(2, 64);
+            mixer.process(inputs, output);
+
+            expectWithinAbsoluteError(output.getSample(0, 0), 1.0f, 0.0001f);
+            expectWithinAbsoluteError(output.getSample(1, 63), 1.0f, 0.0001f);
+            expectEquals(mixer.getLastVolDb(numTracks - 1), 1.0f);
+        }
+
+        beginTest("track count is clamped to the supported range");
+        {
+            expectEquals(static_cast<int>(MixerEngine(0).getNumTracks()), TrackConfig::MIN_TRACKS);
+            expectEquals(static_cast<int>(MixerEngine(TrackConfig::MAX_TRACKS + 1).getNumTracks()), TrackConfig::MAX_TRACKS);
+        }
+    }
+};
+
+static MixerTrackCountTests mixerTrackCountTests;
+
+class MixerGroupBusTests : public juce::UnitTest
+{
+public:
+    MixerGroupBusTests() : juce::UnitTest("MixerGroupBusTests") {}
+
+    void runTest() override
+    {
+        auto renderTrack0 = [](MixerEngine& mixer, int numBlocks)
+        {
+            juce::AudioBuffer<float> track0(2, 64);
+            fillBuffer(track0, 1.0f);
+            std::vector<juce::AudioBuffer<float>*> inputs { &track0 };
+
+            juce::AudioBuffer<float> out(2, 64);
+            for (int block = 0; block < numBlocks; ++block)
+                mixer.process(inputs, out);
+            return out.getSample(0, 63);
+        };
+
+        beginTest("track routed through a group picks up the group gain");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 64);
+
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
+                setTrackParams(apvts, i, i == 0 ? 1.0f : 0.0f, 0.0f);
+
+            expect(mixer.setTrackOutput(0, 2));
+            expectEquals(mixer.getTrackOutput(0), 2);
+            mixer.setGroupGain(2, 0.5f);
+
+            expectWithinAbsoluteError(renderTrack0(mixer, 1), 0.5f, 0.0001f);
+
+            // routing back to the master bypasses the group
+            expect(mixer.setTrackOutput(0, TrackConfig::MASTER_BUS));
+            expectWithinAbsoluteError(renderTrack0(mixer, 1), 1.0f, 0.0001f);
+
+            expect(!mixer.setTrackOutput(0, TrackConfig::MAX_GROUP_BUSES), "out-of-range group is rejected");
+        }
+
+        beginTest("nested groups are scheduled sources first and cycles are rejected");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 64);
+
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
+                setTrackParams(apvts, i, i == 0 ? 1.0f : 0.0f, 0.0f);
+
+            // track 0 -> group 0 -> group 5 -> group 3 -> master; lower index runs later
+            expect(mixer.setGroupOutput(5, 3));
+            expect(mixer.setGroupOutput(0, 5));
+            expect(mixer.setTrackOutput(0, 0));
+            mixer.setGroupGain(0, 0.5f);
+            mixer.setGroupGain(5, 0.5f);
+            mixer.setGroupGain(3, 0.5f);
+
+            expectWithinAbsoluteError(renderTrack0(mixer, 1), 0.125f, 0.0001f, "gains multiply along the chain");
+
+            expect(!mixer.setGroupOutput(3, 0), "3 -> 0 would close a cycle");
+            expect(!mixer.setGroupOutput(3, 3), "a group cannot feed itself");
+            expectEquals(mixer.getGroupOutput(3), TrackConfig::MASTER_BUS);
+        }
+
+        beginTest("group inserts process the summed signal");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 64);
+
+            for (int i = 0; i < TrackConfig::DEFAULT_NUM_TRACKS; ++i)
+                setTrackParams(apvts, i, i == 0 ? 1.0f : 0.0f, 0.0f);
+
+            expect(mixer.setTrackOutput(0, 1));
+            auto& fx = mixer.getGroupFxChain(1);
+            fx.setFilter(TrackFxChain::FilterType::HighPass, 1000.0f, TrackConfig::FX_DEFAULT_FILTER_RESONANCE);
+            fx.setSlotEnabled(TrackFxChain::Slot::Filter, true);
+
+            // DC through a high-pass settles to silence
+            expectWithinAbsoluteError(renderTrack0(mixer, 64), 0.0f, 0.001f);
+        }
+    }
+};
+
+static MixerGroupBusTests mixerGroupBusTests;
+
+class MixerParameterSnapshotTests : public juce::UnitTest
+{
+public:
+    MixerParameterSnapshotTests() : juce::UnitTest("MixerParameterSnapshotTests") {}
+
+    void runTest() override
+    {
+        using Field = MixerParameterSnapshot::Field;
+
+        beginTest("snapshot is only re-read after a change");
+        {
+            MixerParameterSnapshot snapshot;
+            snapshot.resize(3);
+
+            expect(snapshot.update(), "first update should pick up the defaults");
+            expectEquals(snapshot.latest()[Field::Volume][2], 1.0f);
+            expect(!snapshot.update(), "nothing changed, so nothing should be copied");
+
+            snapshot.write(1, Field::Pan, -0.25f);
+            snapshot.write(2, Field::Solo, 1.0f);
+            expect(!snapshot.latest().anySolo, "readers keep their snapshot until the next update");
+
+            expect(snapshot.update());
+            expectEquals(snapshot.latest()[Field::Pan][1], -0.25f);
+            expect(snapshot.latest().anySolo);
+            expect(snapshot.isAnySoloActive());
+
+            // solo state follows the count, not the last write
+            snapshot.write(0, Field::Solo, 1.0f);
+            snapshot.write(2, Field::Solo, 0.0f);
+            snapshot.write(2, Field::Solo, 0.0f);
+            expect(snapshot.update());
+            expect(snapshot.latest().anySolo, "track 1 is still soloed");
+
+            snapshot.write(0, Field::Solo, 0.0f);
+            expect(snapshot.update());
+            expect(!snapshot.latest().anySolo);
+
+            snapshot.write(3, Field::Volume, 0.5f);    // out of range, ignored
+            expect(!snapshot.update());
+        }
+
+        beginTest("concurrent writes never produce a torn snapshot");
+        {
+            constexpr size_t numTracks = 64;
+            MixerParameterSnapshot snapshot;
+            snapshot.resize(numTracks);
+
+            std::atomic<bool> stopFlag{false};
+            std::thread writer([&]
+            {
+                float value = 0.0f;
+                while (!stopFlag.load())
+                {
+                    for (size_t t = 0; t < numTracks; ++t)
+                    {
+                        snapshot.write(t, Field::Solo, (t + static_cast<size_t>(value)) % 5 == 0 ? 1.0f : 0.0f);
+                        snapshot.write(t, Field::Volume, value);
+                    }
+                    value += 1.0f;
+                }
+                snapshot.write(0, Field::Volume, -1.0f);
+            });
+
+            int updates = 0;
+            bool consistent = true;
+            bool volumesMonotonic = true;
+            std::vector<float> lastVolumes(numTracks, 0.0f);
+
+            const auto endTime = juce::Time::getMillisecondCounter() + 100;
+            while (juce::Time::getMillisecondCounter() < endTime)
+            {
+                if (!snapshot.update())
+                    continue;
+                ++updates;
+
+                const auto& values = snapshot.latest();
+                bool anySolo = false;
+                for (size_t t = 0; t < numTracks; ++t)
+                {
+                    anySolo = anySolo || values[Field::Solo][t] > 0.5f;
+                    volumesMonotonic = volumesMonotonic && values[Field::Volume][t] >= lastVolumes[t];
+                    lastVolumes[t] = values[Field::Volume][t];
+                }
+                consistent = consistent && anySolo == values.anySolo;
+            }
+
+            stopFlag.store(true);
+            writer.join();
+
+            expect(updates > 0, "reader should have picked up snapshots while writes were running");
+            expect(consistent, "the solo flag should always match the solo values it was published with");
+            expect(volumesMonotonic, "values should never go back to an older write");
+
+            expect(snapshot.update());
+            expectEquals(snapshot.latest()[Field::Volume][0], -1.0f);
+        }
+
+        beginTest("writers that collide park their values instead of waiting, and none is lost");
+        {
+            constexpr size_t numTracks = 64;
+            constexpr int numRounds = 20000;
+            MixerParameterSnapshot snapshot;
+            snapshot.resize(numTracks);
+
+            // two writers on separate halves, like a host automation thread and the message thread
+            std::atomic<int> parked{0};
+            auto writeHalf = [&](size_t firstTrack)
+            {
+                for (int round = 1; round <= numRounds; ++round)
+                    for (size_t t = firstTrack; t < firstTrack + numTracks / 2; ++t)
+                        if (!snapshot.write(t, Field::Volume, static_cast<float>(round)))
+                            parked.fetch_add(1);
+            };
+
+            std::atomic<bool> stopFlag{false};
+            bool volumesMonotonic = true;
+            std::vector<float> lastVolumes(numTracks, 0.0f);
+            std::thread reader([&]
+            {
+                while (!stopFlag.load())
+                {
+                    if (!snapshot.update())
+                        continue;
+                    for (size_t t = 0; t < numTracks; ++t)
+                    {
+                        volumesMonotonic = volumesMonotonic && snapshot.latest()[Field::Volume][t] >= lastVolumes[t];
+                        lastVolumes[t] = snapshot.latest()[Field::Volume][t];
+                    }
+                }
+            });
+
+            std::thread first(writeHalf, size_t(0));
+            std::thread second(writeHalf, numTracks / 2);
+            first.join();
+            second.join();
+            stopFlag.store(true);
+            reader.join();
+
+            logMessage("writes parked behind another writer: " + juce::String(parked.load()));
+            expect(volumesMonotonic, "a parked value should never overwrite a newer one");
+
+            // the next block's update() publishes whatever is still parked
+            snapshot.update();
+            bool allFinal = true;
+            for (size_t t = 0; t < numTracks; ++t)
+                allFinal = allFinal && snapshot.latest()[Field::Volume][t] == static_cast<float>(numRounds);
+            expect(allFinal, "every track should end on its last written value");
+        }
+
+        beginTest("mixer follows parameter changes made after it is attached");
+        {
+            DummyProcessor proc;
+            juce::AudioProcessorValueTreeState apvts(proc, nullptr, "PARAMS", createMockLayout());
+
+            MixerEngine mixer;
+            mixer.attachParameters(apvts);
+            mixer.setMasterLimiterEnabled(false);
+            mixer.prepare(48000.0, 32);
+
+            juce::AudioBuffer<float> t0(2, 32);
+            fillBuffer(t0, 1.0f);
+            std::vector<juce::AudioBuffer<float>*> inputs { &t0 };
+            juce::AudioBuffer<float> out(2, 32);
+
+            setTrackParams(apvts, 0, 0.5f, 0.0f);
+            setTrackMuteSolo(apvts, 2, false, true);
+            expect(mixer.getIsAnyTrackSoloed(), "solo state should be published with the change, not on the next block");
+
+            mixer.process(inputs, out);
+            expectWithinAbsoluteError(mixer.getLastVolDb(0), 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(out.getSample(0, 31), 0.0f, 1.0e-6f, "track 3 is soloed, so track 1 is silent");
+
+            mixer.detachParameters();
+            setTrackParams(apvts, 0, 0.25f, 0.0f);
+            mixer.process(inputs, out);
+            expectWithinAbsoluteError(mixer.getLastVolDb(0), 0.5f, 1.0e-6f, "a detached mixer should not hear the parameters");
+        }
+    }
+};
+
+static MixerParameterSnapshotTests mixerParameterSnapshotTests;
@@ -0,0 +1,126 @@
+#include <cmath>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../PluginProcessor.h"
+
+class PluginProcessorTests : public juce::UnitTest
+{
+public:
+    PluginProcessorTests() : juce::UnitTest("PluginProcessorTests") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+        const int numPhysicalCpus = juce::SystemStats::getNumPhysicalCpus();
+        const int parallelWorkers = TrackConfig::getNumRenderWorkers(TrackConfig::PARALLEL_RENDER_MIN_TRACKS,
+                                                                     numPhysicalCpus);
+
+        beginTest("A project grown past the threshold renders on helper threads");
+        {
+            AudioLoopStationAudioProcessor processor;
+            processor.prepareToPlay(sampleRate, blockSize);
+            expectEquals(processor.getNumTracks(), TrackConfig::DEFAULT_NUM_TRACKS);
+            expectEquals(processor.getLoopManager().getNumRenderWorkers(), 0);
+
+            expect(processor.setNumTracks(TrackConfig::PARALLEL_RENDER_MIN_TRACKS));
+            expectEquals(processor.getNumTracks(), TrackConfig::PARALLEL_RENDER_MIN_TRACKS);
+            expectEquals(processor.getLoopManager().getNumRenderWorkers(), parallelWorkers);
+            if (numPhysicalCpus > 2)
+                expect(parallelWorkers > 0, "Machines with a core to spare should get helper threads.");
+
+            // the engine runs at the new size straight away
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+            buffer.clear();
+            juce::MidiBuffer midi;
+            processor.processBlock(buffer, midi);
+            expect(buffer.getMagnitude(0, blockSize) == 0.0f, "Empty tracks should be silent.");
+
+            expect(processor.setNumTracks(TrackConfig::PARALLEL_RENDER_MIN_TRACKS - 1));
+            expectEquals(processor.getLoopManager().getNumRenderWorkers(), 0);
+            processor.releaseResources();
+        }
+
+        beginTest("A host state brings its track count, and its render workers, back");
+        {
+            juce::MemoryBlock state;
+            {
+                AudioLoopStationAudioProcessor saved;
+                expect(saved.setNumTracks(TrackConfig::PARALLEL_RENDER_MIN_TRACKS));
+                saved.getStateInformation(state);
+            }
+
+            AudioLoopStationAudioProcessor restored;
+            restored.prepareToPlay(sampleRate, blockSize);
+            restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            expectEquals(restored.getNumTracks(), TrackConfig::PARALLEL_RENDER_MIN_TRACKS);
+            expectEquals(restored.getLoopManager().getNumRenderWorkers(), parallelWorkers);
+            expect(restored.takeUserMessages().isEmpty(), "Nothing should have been refused.");
+            restored.releaseResources();
+        }
+
+        beginTest("A track's direct output stays sample-aligned with the limited master");
+        {
+            AudioLoopStationAudioProcessor processor;
+            auto* directBus = processor.getBus(false, 1);
+            expect(directBus != nullptr && directBus->enable(true), "Track 1's direct output should turn on.");
+
+            processor.prepareToPlay(sampleRate, blockSize);
+            expect(processor.getLatencySamples() > 0, "The limiter's lookahead should be the plugin's latency.");
+
+            // a noise loop, quiet enough that the limiter only delays it
+            juce::Random random(4321);
+            juce::AudioBuffer<float> loop(2, 4800);
+            for (int ch = 0; ch < loop.getNumChannels(); ++ch)
+                for (int s = 0; s < loop.getNumSamples(); ++s)
+                    loop.setSample(ch, s, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+            auto& loopManager = processor.getLoopManager();
+            expect(loopManager.loadTrackAudio(0, loop, sampleRate));
+            expect(loopManager.adoptTrackAudio(0, 0));
+            processor.startPlayback();
+
+            constexpr int numBlocks = 16;
+            juce::AudioBuffer<float> master(2, numBlocks * blockSize);
+            juce::AudioBuffer<float> stem(2, numBlocks * blockSize);
+            juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+            juce::MidiBuffer midi;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                buffer.clear();
+                processor.processBlock(buffer, midi);
+
+                const auto mainOut = processor.getBusBuffer(buffer, false, 0);
+                const auto stemOut = processor.getBusBuffer(buffer, false, 1);
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    master.copyFrom(ch, block * blockSize, mainOut, ch, 0, blockSize);
+                    stem.copyFrom(ch, block * blockSize, stemOut, ch, 0, blockSize);
+                }
+            }
+
+            expect(stem.getMagnitude(0, stem.getNumSamples()) > 0.1f, "The track should be playing.");
+
+            // centred and unlimited, the master is the stem times the track's fader gain
+            // on every sample, so any offset between the two shows up as a mismatch
+            int peakSample = 0;
+            for (int s = 0; s < stem.getNumSamples(); ++s)
+                if (std::abs(stem.getSample(0, s)) > std::abs(stem.getSample(0, peakSample)))
+                    peakSample = s;
+            const float gain = master.getSample(0, peakSample) / stem.getSample(0, peakSample);
+            expect(gain > 0.0f, "The master should carry the track.");
+
+            float worstError = 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int s = 0; s < stem.getNumSamples(); ++s)
+                    worstError = juce::jmax(worstError, std::abs(master.getSample(ch, s) - gain * stem.getSample(ch, s)));
+            expectLessThan(worstError, 1.0e-4f);
+
+            processor.releaseResources();
+        }
+    }
+};
+
+static PluginProcessorTests pluginProcessorTests;
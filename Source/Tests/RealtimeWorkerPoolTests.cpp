@@ -0,0 +1,162 @@
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/LoopManager.h"
+#include "../Audio/RealtimeWorkerPool.h"
+
+class RealtimeWorkerPoolTests : public juce::UnitTest
+{
+public:
+    RealtimeWorkerPoolTests() : juce::UnitTest("RealtimeWorkerPoolTests") {}
+
+    void runTest() override
+    {
+        beginTest("Every task runs exactly once per batch");
+        {
+            struct Counts
+            {
+                std::vector<std::atomic<int>> perTask;
+                explicit Counts(size_t n) : perTask(n) {}
+            };
+
+            for (int numWorkers : { 0, 3 })
+            {
+                RealtimeWorkerPool pool;
+                pool.start(numWorkers, 48000.0, 256);
+                expectEquals(pool.getNumWorkers(), numWorkers);
+
+                constexpr int numTasks = 37;
+                constexpr int numBatches = 500;
+                Counts counts(numTasks);
+
+                for (int batch = 0; batch < numBatches; ++batch)
+                {
+                    pool.run(numTasks, [](void* context, int taskIndex)
+                    {
+                        static_cast<Counts*>(context)->perTask[static_cast<size_t>(taskIndex)].fetch_add(1);
+                    }, &counts);
+                }
+
+                bool allExact = true;
+                for (auto& count : counts.perTask)
+                    allExact = allExact && count.load() == numBatches;
+                expect(allExact, "Each task should run once per batch with " + juce::String(numWorkers) + " workers");
+            }
+        }
+
+        beginTest("Projects from the parallel threshold up get render workers");
+        {
+            constexpr int threshold = TrackConfig::PARALLEL_RENDER_MIN_TRACKS;
+            expectEquals(TrackConfig::getNumRenderWorkers(threshold - 1, 8), 0, "Small projects render serially");
+            expectEquals(TrackConfig::getNumRenderWorkers(threshold, 8), 6, "One core for the audio thread, one left free");
+            expectEquals(TrackConfig::getNumRenderWorkers(TrackConfig::MAX_TRACKS, 32), TrackConfig::MAX_RENDER_WORKERS);
+            expectEquals(TrackConfig::getNumRenderWorkers(TrackConfig::MAX_TRACKS, 2), 0, "No core to spare");
+            static_assert(TrackConfig::PARALLEL_RENDER_MIN_TRACKS <= TrackConfig::MAX_TRACKS, "The threshold must be reachable");
+
+            // what prepareToPlay() sets up for a project at the threshold
+            SyncEngine sync;
+            sync.prepare(48000.0, 64);
+            LoopManager manager(sync, threshold);
+            manager.setNumRenderWorkers(TrackConfig::getNumRenderWorkers(threshold, 4));
+            manager.prepareToPlay(48000.0, 64, 2);
+            expectEquals(manager.getNumRenderWorkers(), 2);
+        }
+
+        beginTest("Parallel track rendering is bit-identical to serial");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+            constexpr int numChannels = 2;
+            constexpr int numTracks = 8;
+
+            // the plugin's audio thread runs with denormals flushed, as the workers do
+            juce::ScopedNoDenormals noDenormals;
+
+            juce::AudioBuffer<float> recordedInput(numChannels, blockSize);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int s = 0; s < blockSize; ++s)
+                    recordedInput.setSample(ch, s, 0.5f * std::sin(0.3f * static_cast<float>(s + ch)));
+
+            juce::AudioBuffer<float> silentInput(numChannels, blockSize);
+            silentInput.clear();
+
+            auto setUp = [&](SyncEngine& sync, LoopManager& manager, int numWorkers)
+            {
+                sync.prepare(sampleRate, blockSize);
+                // samples-per-beat rounds to one block, so the loop is one block long
+                sync.setTempo(45000.0f);
+
+                manager.setNumRenderWorkers(numWorkers);
+                manager.prepareToPlay(sampleRate, blockSize, numChannels);
+
+                for (size_t t = 0; t < manager.getNumTracks(); ++t)
+                {
+                    manager.getTrack(t)->armForRecording(true);
+                    manager.getTrack(t)->startRecording(0);
+                }
+                manager.processBlock(recordedInput);
+
+                // give the tracks different work so a scheduling mix-up would show
+                for (size_t t = 0; t < manager.getNumTracks(); ++t)
+                {
+                    auto* track = manager.getTrack(t);
+                    track->stopRecording();
+                    track->armForRecording(false);
+                    track->setReverse(t % 3 == 0);
+
+                    if (t % 2 == 0)
+                    {
+                        auto& fx = track->getFxChain();
+                        fx.setFilter(TrackFxChain::FilterType::LowPass, 400.0f + 300.0f * static_cast<float>(t),
+                                     TrackConfig::FX_DEFAULT_FILTER_RESONANCE);
+                        fx.setSlotEnabled(TrackFxChain::Slot::Filter, true);
+                    }
+                }
+            };
+
+            SyncEngine serialSync;
+            LoopManager serial(serialSync, numTracks);
+            setUp(serialSync, serial, 0);
+
+            SyncEngine parallelSync;
+            LoopManager parallel(parallelSync, numTracks);
+            setUp(parallelSync, parallel, 3);
+            expectEquals(parallel.getNumRenderWorkers(), 3);
+
+            bool identical = true;
+            for (int block = 0; block < 32; ++block)
+            {
+                serial.processBlock(silentInput);
+                parallel.processBlock(silentInput);
+
+                const auto serialOutputs = serial.getTrackOutputs();
+                const auto parallelOutputs = parallel.getTrackOutputs();
+
+                for (size_t t = 0; t < serialOutputs.size(); ++t)
+                {
+                    if ((serialOutputs[t] == nullptr) != (parallelOutputs[t] == nullptr))
+                    {
+                        identical = false;
+                        continue;
+                    }
+                    if (serialOutputs[t] == nullptr)
+                        continue;
+
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        for (int s = 0; s < blockSize; ++s)
+                            identical = identical && serialOutputs[t]->getSample(ch, s) == parallelOutputs[t]->getSample(ch, s);
+                }
+            }
+
+            expect(identical, "Track outputs should match serial rendering exactly");
+            expect(parallel.getNumTracksActiveThisBlock() == serial.getNumTracksActiveThisBlock(),
+                   "Activity flags should match serial rendering");
+            expect(serial.getNumTracksActiveThisBlock() > 1, "The comparison should cover several playing tracks");
+        }
+    }
+};
+
+static RealtimeWorkerPoolTests realtimeWorkerPoolTests;
@@ -0,0 +1,73 @@
+#include <thread>
+
+#include <juce_core/juce_core.h>
+
+#include "../Audio/SpscQueue.h"
+
+class SpscQueueTests : public juce::UnitTest
+{
+public:
+    SpscQueueTests() : juce::UnitTest("SpscQueueTests") {}
+
+    void runTest() override
+    {
+        beginTest("Items come out in the order they went in, up to capacity");
+        {
+            SpscQueue<int, 8> queue;
+            int item = 0;
+            expect(!queue.pop(item), "A new queue is empty");
+
+            for (int i = 0; i < 8; ++i)
+                expect(queue.push(i));
+            expect(!queue.push(8), "A full queue refuses new items");
+            expectEquals(static_cast<int>(queue.getNumReady()), 8);
+
+            for (int i = 0; i < 8; ++i)
+            {
+                expect(queue.pop(item));
+                expectEquals(item, i);
+            }
+            expect(!queue.pop(item));
+
+            // the indices keep counting past the capacity
+            for (int round = 0; round < 100; ++round)
+            {
+                expect(queue.push(round));
+                expect(queue.pop(item) && item == round);
+            }
+        }
+
+        beginTest("One producer and one consumer thread lose and reorder nothing");
+        {
+            constexpr int numItems = 200000;
+            SpscQueue<int, 64> queue;
+
+            std::thread producer([&queue]
+            {
+                for (int i = 0; i < numItems; ++i)
+                    while (!queue.push(i))
+                        std::this_thread::yield();
+            });
+
+            int expected = 0;
+            bool inOrder = true;
+            while (expected < numItems)
+            {
+                int item = 0;
+                if (!queue.pop(item))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                inOrder = inOrder && item == expected;
+                ++expected;
+            }
+            producer.join();
+
+            expect(inOrder, "Items arrived out of order");
+            expectEquals(static_cast<int>(queue.getNumReady()), 0);
+        }
+    }
+};
+
+static SpscQueueTests spscQueueTests;
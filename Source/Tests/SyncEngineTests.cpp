@@ -0,0 +1,109 @@
+#include <cmath>
+#include <limits>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/SyncEngine.h"
+
+class SyncEngineTests : public juce::UnitTest
+{
+public:
+    SyncEngineTests() : juce::UnitTest("SyncEngineTests") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 64;
+
+        auto hostPosition = [](juce::int64 sample, double ppq, double bpm, bool playing)
+        {
+            juce::AudioPlayHead::PositionInfo info;
+            info.setTimeInSamples(sample);
+            info.setPpqPosition(ppq);
+            info.setBpm(bpm);
+            info.setIsPlaying(playing);
+            return info;
+        };
+
+        beginTest("Host position and tempo are ignored until sync is enabled");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+
+            sync.syncToHost(hostPosition(48000, 1.5, 90.0, true));
+            sync.advance(blockSize);
+            expectEquals(sync.getGlobalSample(), static_cast<juce::int64>(blockSize));
+            expectEquals(sync.getTimelineGeneration(), static_cast<juce::uint32>(0));
+        }
+
+        beginTest("Following the host relocates the clock and re-anchors the tempo");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setHostSyncEnabled(true);
+
+            sync.syncToHost(hostPosition(48000, 1.5, 90.0, true));
+            sync.advance(blockSize);
+            expectEquals(sync.getBlockStartSample(), static_cast<juce::int64>(48000));
+            expectEquals(sync.getGlobalSample(), static_cast<juce::int64>(48000 + blockSize));
+            expectEquals(sync.getTimelineGeneration(), static_cast<juce::uint32>(1));
+            expectEquals(sync.getTempo(), 90.0f);
+            expectWithinAbsoluteError(sync.getBeatPosition(), 1.5 + blockSize * 90.0 / 60.0 / sampleRate, 1.0e-9);
+
+            // a host that carries on where we are is not a jump, even through a tempo ramp
+            sync.syncToHost(hostPosition(48000 + blockSize, 1.502, 91.0, true));
+            sync.advance(blockSize);
+            expectEquals(sync.getTimelineGeneration(), static_cast<juce::uint32>(1));
+            expectWithinAbsoluteError(sync.getBeatPosition(), 1.502 + blockSize * 91.0 / 60.0 / sampleRate, 1.0e-9);
+        }
+
+        beginTest("A stopped host holds the clock");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setHostSyncEnabled(true);
+
+            sync.syncToHost(hostPosition(1000, 0.0, 120.0, false));
+            sync.advance(blockSize);
+            expect(!sync.isTransportRolling());
+            expectEquals(sync.getGlobalSample(), static_cast<juce::int64>(1000));
+
+            sync.setHostSyncEnabled(false);
+            expect(sync.isTransportRolling(), "Switching back to the internal clock runs again");
+        }
+
+        beginTest("Host loop ranges wrap on the exact sample");
+        {
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setHostSyncEnabled(true);
+
+            // loop over the first bar at 120 bpm: 96000 samples
+            constexpr juce::int64 loopEnd = 96000;
+            auto info = hostPosition(loopEnd - 24, 4.0 - 24.0 / 24000.0, 120.0, true);
+            info.setIsLooping(true);
+            info.setLoopPoints(juce::AudioPlayHead::LoopPoints { 0.0, 4.0 });
+            sync.syncToHost(info);
+
+            expectEquals(sync.getSamplesUntilLoopWrap(), 24);
+            sync.advance(24);
+            expectEquals(sync.getSamplesUntilLoopWrap(), std::numeric_limits<int>::max());
+
+            const auto generation = sync.getTimelineGeneration();
+            sync.advance(blockSize - 24);
+            expectEquals(sync.getBlockStartSample(), static_cast<juce::int64>(0));
+            expectEquals(sync.getGlobalSample(), static_cast<juce::int64>(blockSize - 24));
+            expectEquals(sync.getTimelineGeneration(), generation + 1);
+
+            // the host reports the same place next block: no second jump
+            auto next = hostPosition(blockSize - 24, (blockSize - 24) / 24000.0, 120.0, true);
+            next.setIsLooping(true);
+            next.setLoopPoints(juce::AudioPlayHead::LoopPoints { 0.0, 4.0 });
+            sync.syncToHost(next);
+            expectEquals(sync.getTimelineGeneration(), generation + 1);
+            expectEquals(sync.getSamplesUntilLoopWrap(), static_cast<int>(loopEnd - (blockSize - 24)));
+        }
+    }
+};
+
+static SyncEngineTests syncEngineTests;
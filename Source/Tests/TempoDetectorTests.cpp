@@ -0,0 +1,131 @@
+#include <cmath>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/LoopManager.h"
+#include "../Audio/TempoDetector.h"
+
+class TempoDetectorTests : public juce::UnitTest
+{
+public:
+    TempoDetectorTests() : juce::UnitTest("TempoDetectorTests") {}
+
+    void runTest() override
+    {
+        beginTest("A click loop gives its tempo, beat count and downbeat");
+        {
+            struct Case { double sampleRate; double bpm; int beats; int rotation; };
+            const Case cases[] = { { 44100.0, 100.0, 16, 0 },
+                                   { 44100.0, 100.0, 16, 22050 },
+                                   { 48000.0, 128.0, 8, 3000 },
+                                   { 48000.0, 72.0, 8, 1000 } };
+
+            for (const auto& c : cases)
+            {
+                const auto loop = makeClickLoop(c.sampleRate, c.bpm, c.beats, c.rotation);
+                const auto estimate = TempoDetector::analyse(loop, c.sampleRate, 4);
+                const auto label = juce::String(c.bpm) + " BPM, rotated " + juce::String(c.rotation);
+
+                expect(estimate.isValid(), label);
+                expectWithinAbsoluteError(estimate.bpm, c.bpm, 0.01, label);
+                expectEquals(estimate.beatsPerLoop, c.beats, label);
+                expectGreaterThan(estimate.confidence, TrackConfig::TEMPO_DETECT_MIN_CONFIDENCE, label);
+
+                // the accented click was moved rotation samples earlier, around the loop point
+                const int length = loop.getNumSamples();
+                const int barLength = length * 4 / c.beats;
+                const int expected = ((length - c.rotation) % length) % barLength;
+                const int error = std::abs(estimate.downbeatSample - expected);
+                expectLessThan(juce::jmin(error, barLength - error), TrackConfig::TEMPO_DETECT_HOP_SIZE, label);
+            }
+        }
+
+        beginTest("Silence and audio too short for a beat have no tempo");
+        {
+            juce::AudioBuffer<float> silence(2, 96000);
+            silence.clear();
+            expect(!TempoDetector::analyse(silence, 48000.0).isValid());
+
+            const auto shortClick = makeClickLoop(48000.0, 120.0, 1, 0);
+            expect(!TempoDetector::analyse(shortClick, 48000.0).isValid());
+        }
+
+        beginTest("Analysis runs in the background and reports once");
+        {
+            TempoDetector detector;
+            detector.requestAnalysis(2, makeClickLoop(44100.0, 100.0, 16, 0), 44100.0);
+
+            TempoDetector::Estimate estimate;
+            bool finished = false;
+            for (int attempt = 0; attempt < 1000 && !finished; ++attempt)
+            {
+                finished = detector.takeEstimate(estimate);
+                if (!finished)
+                    juce::Thread::sleep(5);
+            }
+
+            expect(finished, "The analysis should finish within five seconds");
+            expectEquals(estimate.trackIndex, 2);
+            expectWithinAbsoluteError(estimate.bpm, 100.0, 0.01);
+            expect(!detector.takeEstimate(estimate), "Each estimate is handed out once");
+            expect(!detector.isBusy());
+        }
+
+        beginTest("Imported audio becomes a loop with its downbeat on the bar line");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+
+            LoopManager manager(sync, 2);
+            manager.prepareToPlay(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> input(2, blockSize);
+            input.clear();
+
+            const auto loop = makeClickLoop(sampleRate, 120.0, 8, 0);
+            expect(manager.loadTrackAudio(1, loop, sampleRate));
+            expect(manager.adoptTrackAudio(1, 6000));
+            manager.processBlock(input);
+
+            const auto* track = manager.getTrack(1);
+            expectEquals(track->getLoopLengthSamples(), loop.getNumSamples());
+            expectEquals(track->getRecordingStartGlobalSample(), static_cast<juce::int64>(-6000));
+            expect(track->getState() == LoopTrack::State::Stopped, "Ready to play, not playing");
+
+            manager.reclaimRetiredPlayers();
+        }
+    }
+
+private:
+    // Decaying noise bursts on every beat, louder on the first of each bar,
+    // shifted rotation samples earlier around the loop point.
+    static juce::AudioBuffer<float> makeClickLoop(double sampleRate, double bpm, int beats, int rotation)
+    {
+        const int beatLength = juce::roundToInt(60.0 * sampleRate / bpm);
+        const int length = beatLength * beats;
+        const int clickLength = static_cast<int>(0.03 * sampleRate);
+
+        juce::AudioBuffer<float> loop(2, length);
+        loop.clear();
+
+        juce::Random random(1);
+        for (int beat = 0; beat < beats; ++beat)
+        {
+            const float level = beat % 4 == 0 ? 0.9f : 0.4f;
+            for (int i = 0; i < clickLength; ++i)
+            {
+                const auto sample = level * (random.nextFloat() * 2.0f - 1.0f)
+                                    * std::exp(-i / static_cast<float>(0.005 * sampleRate));
+                const int index = ((beat * beatLength + i - rotation) % length + length) % length;
+                for (int channel = 0; channel < loop.getNumChannels(); ++channel)
+                    loop.addSample(channel, index, sample);
+            }
+        }
+        return loop;
+    }
+};
+
+static TempoDetectorTests tempoDetectorTests;
@@ -0,0 +1,221 @@
+#include <cmath>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include "../Audio/SyncEngine.h"
+#include "../Audio/TempoMap.h"
+
+class TempoMapTests : public juce::UnitTest
+{
+public:
+    TempoMapTests() : juce::UnitTest("TempoMapTests") {}
+
+    void runTest() override
+    {
+        beginTest("Beat positions stay exact over six hours of blocks");
+        {
+            constexpr double sampleRate = 44100.0;
+            constexpr double bpm = 123.45;          // 21433.77... samples per beat
+            constexpr int blockSize = 512;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            sync.setTempo(static_cast<float>(bpm));
+
+            const auto exactBpm = static_cast<double>(static_cast<float>(bpm));
+            const juce::int64 totalSamples = static_cast<juce::int64>(sampleRate) * 60 * 60 * 6;
+            for (juce::int64 done = 0; done < totalSamples; done += blockSize)
+                sync.advance(blockSize);
+
+            const auto samples = static_cast<long double>(sync.getGlobalSample());
+            const auto exactBeats = samples * exactBpm / (60.0L * sampleRate);
+            const auto error = std::abs(static_cast<long double>(sync.getBeatPosition()) - exactBeats);
+            expect(error < 1.0e-9L, "Drift after six hours: " + juce::String(static_cast<double>(error)) + " beats");
+
+            // what the rounded samples-per-beat clock would have said
+            const auto roundedBeats = samples / static_cast<long double>(sync.getSamplesPerBeat());
+            expect(std::abs(roundedBeats - exactBeats) > 0.1L, "Rounding the beat length should visibly drift");
+        }
+
+        beginTest("Tempo changes anchor on the previous segment");
+        {
+            TempoMap map(120.0);
+            map.setSampleRate(48000.0);
+            expect(map.setTempoAt(TempoMap::beatsToTicks(8.0), 60.0));
+
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(8.0)), 192000.0);
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(10.0)), 288000.0);
+            expect(map.sampleToTicks(288000.0) == TempoMap::beatsToTicks(10.0), "Sample to beat should be exact");
+            expectEquals(map.getTempoAtSample(191999.0), 120.0);
+            expectEquals(map.getTempoAtSample(200000.0), 60.0);
+            expectEquals(map.getSamplesPerBeatAtSample(200000.0), 48000.0);
+
+            expect(map.setTempoAt(TempoMap::beatsToTicks(8.0), 240.0), "Same tick replaces the change");
+            expectEquals(map.getNumTempoChanges(), 2);
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(10.0)), 216000.0);
+
+            // a rate change moves samples, not beats
+            map.setSampleRate(96000.0);
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(10.0)), 432000.0);
+
+            expect(!map.setTempoAt(0, 0.0), "Non-positive tempo is rejected");
+            map.setConstantTempo(90.0);
+            expectEquals(map.getNumTempoChanges(), 1);
+        }
+
+        beginTest("Merged tempo changes cover the same samples");
+        {
+            TempoMap map(120.0);
+            map.setSampleRate(48000.0);
+            expect(map.setTempoAt(TempoMap::beatsToTicks(4.0), 60.0));
+            expect(map.setTempoAt(TempoMap::beatsToTicks(6.0), 240.0));
+            expect(map.setTempoAt(TempoMap::beatsToTicks(8.0), 120.0));
+
+            // beats 4 to 7 take 108000 samples: 80 bpm
+            expect(map.mergeTempoChanges(TempoMap::beatsToTicks(4.0), TempoMap::beatsToTicks(7.0)));
+            expectEquals(map.getNumTempoChanges(), 4);
+            expectEquals(map.getTempoAtTick(TempoMap::beatsToTicks(5.0)), 80.0);
+            expectEquals(map.getTempoAtTick(TempoMap::beatsToTicks(7.0)), 240.0, "The rest of the split segment keeps its tempo");
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(2.0)), 48000.0);
+            expectWithinAbsoluteError(map.ticksToSample(TempoMap::beatsToTicks(7.0)), 204000.0, 1.0e-6);
+            expectWithinAbsoluteError(map.ticksToSample(TempoMap::beatsToTicks(10.0)), 264000.0, 1.0e-6);
+
+            expect(!map.mergeTempoChanges(TempoMap::beatsToTicks(5.0), TempoMap::beatsToTicks(6.0)), "No change starts there");
+            expect(!map.mergeTempoChanges(TempoMap::beatsToTicks(8.0), TempoMap::beatsToTicks(8.0)));
+        }
+
+        beginTest("Sample and tick conversions round-trip");
+        {
+            TempoMap map(97.0);
+            map.setSampleRate(44100.0);
+            map.setTempoAt(TempoMap::beatsToTicks(3.25), 181.5);
+            map.setTempoAt(TempoMap::beatsToTicks(17.0), 45.0);
+
+            auto& random = getRandom();
+            for (int i = 0; i < 1000; ++i)
+            {
+                const double sample = random.nextDouble() * 44100.0 * 600.0;
+                const auto ticks = map.sampleToTicks(sample);
+                expectWithinAbsoluteError(map.ticksToSample(ticks), sample, 1.0e-4);
+            }
+        }
+
+        beginTest("Meter changes sit on bar lines");
+        {
+            TempoMap map(120.0, { 4, 4 });
+            expect(map.setMeterAt(2, { 7, 8 }));
+            expect(!map.setMeterAt(4, { 5, 3 }), "Denominator must be a power of two");
+
+            expect(map.barToTicks(2) == TempoMap::beatsToTicks(8.0));
+            expect(map.barToTicks(3) == TempoMap::beatsToTicks(11.5));
+
+            const auto inBar = map.ticksToBar(TempoMap::beatsToTicks(9.0));
+            expect(inBar.bar == 2 && inBar.tickInBar == TempoMap::kTicksPerBeat, "Beat 9 is one beat into bar 2");
+            expect(inBar.meter == TempoMap::Meter{ 7, 8 });
+
+            const auto beforeStart = map.ticksToBar(-TempoMap::kTicksPerBeat);
+            expect(beforeStart.bar == -1 && beforeStart.tickInBar == TempoMap::beatsToTicks(3.0),
+                   "Positions before the start floor to bar -1");
+        }
+
+        beginTest("SyncEngine publishes map edits to the audio thread");
+        {
+            SyncEngine sync;
+            sync.prepare(48000.0, 64);
+            sync.setTempo(45000.0f);        // 64 samples per beat
+            expect(sync.setTimeSignature(3, 4));
+            expect(!sync.setTimeSignature(0, 4));
+
+            // edits reach the live map at the next block; until then it is the default 120 bpm
+            expectEquals(sync.getBeatAlignedLength(0, 10), 24000);
+            sync.advance(64);
+            expectEquals(sync.getBeatAlignedLength(0, 10), 64);
+            expectEquals(sync.getBeatAlignedLength(64, 65), 128);
+            expectEquals(sync.getSamplesPerBar(), 192);
+            expectEquals(sync.getBeatPosition(), 1.0);
+
+            TempoMap map(120.0, { 6, 8 });
+            map.setTempoAt(TempoMap::beatsToTicks(1.0), 60.0);
+            sync.setTempoMap(map);
+            sync.advance(64);
+            expectEquals(sync.getTempo(), 120.0f);
+            expect(sync.getTimeSignature() == TempoMap::Meter{ 6, 8 });
+            // one beat at 120 then one at 60
+            expectEquals(sync.getBeatAlignedLength(0, 24001), 72000);
+        }
+
+        beginTest("A live tempo change carries on from the current beat");
+        {
+            SyncEngine sync;
+            sync.prepare(48000.0, 64);
+            sync.setTempo(45000.0f);        // 64 samples per beat
+            for (int block = 0; block < 10; ++block)
+                sync.advance(64);
+            expectEquals(sync.getBeatPosition(), 10.0);
+
+            sync.setTempo(22500.0f);        // 128 samples per beat from here
+            sync.advance(64);
+            expectEquals(sync.getBeatPosition(), 10.5, "No jump at the change");
+            sync.advance(64);
+            expectEquals(sync.getBeatPosition(), 11.0);
+
+            const auto& map = sync.getLiveTempoMap();
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(5.0)), 320.0, "The past keeps its tempo");
+            expectEquals(map.getTempoAtTick(TempoMap::beatsToTicks(10.0)), 22500.0);
+
+            sync.setConstantTempo(45000.0f);
+            sync.advance(64);
+            expectEquals(map.getNumTempoChanges(), 1, "Loading a project resets the timeline");
+        }
+
+        beginTest("Many tempo changes at one position leave a single segment");
+        {
+            SyncEngine sync;
+            sync.prepare(48000.0, 64);
+            sync.setTempo(45000.0f);        // 64 samples per beat
+            for (int block = 0; block < 10; ++block)
+                sync.advance(64);
+
+            // empty blocks: the clock stays on beat 10
+            for (int change = 0; change < 4 * TempoMap::kMaxTempoChanges; ++change)
+            {
+                sync.setTempo(20000.0f + static_cast<float>(change));
+                sync.advance(0);
+            }
+
+            const auto& map = sync.getLiveTempoMap();
+            expectEquals(map.getNumTempoChanges(), 2);
+            expectEquals(map.getTempoAtTick(TempoMap::beatsToTicks(10.0)), 20000.0 + 4 * TempoMap::kMaxTempoChanges - 1);
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(5.0)), 320.0, "The past keeps its tempo");
+            expectEquals(sync.getBeatPosition(), 10.0);
+        }
+
+        beginTest("A tempo drag while playing adds one segment, not one per block");
+        {
+            constexpr double sampleRate = 48000.0;
+            constexpr int blockSize = 64;
+
+            SyncEngine sync;
+            sync.prepare(sampleRate, blockSize);
+            for (int block = 0; block < 1500; ++block)     // two seconds at 120, beat 4
+                sync.advance(blockSize);
+
+            bool noJumps = true;
+            for (int block = 0; block < 4 * TempoMap::kMaxTempoChanges; ++block)
+            {
+                const double bpm = 120.0 + 0.125 * block;
+                const auto beatBefore = sync.getBeatPosition();
+                sync.setTempo(static_cast<float>(bpm));
+                sync.advance(blockSize);
+                noJumps = noJumps && std::abs(sync.getBeatPosition() - beatBefore - blockSize * bpm / 60.0 / sampleRate) < 1.0e-9;
+            }
+
+            const auto& map = sync.getLiveTempoMap();
+            expect(noJumps, "Every block should move on by its own tempo from where the last one ended");
+            expect(map.getNumTempoChanges() <= 3, "One change for the gesture so far and one for the current tempo");
+            expectEquals(map.ticksToSample(TempoMap::beatsToTicks(2.0)), 48000.0, "Before the drag nothing moves");
+        }
+    }
+};
+
+static TempoMapTests tempoMapTests;
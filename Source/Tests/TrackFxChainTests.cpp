@@ -0,0 +1,113 @@
+#include <cmath>
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "TrackFxChain.h"
+
+class TrackFxChainTests : public juce::UnitTest
+{
+public:
+    TrackFxChainTests() : juce::UnitTest("TrackFxChainTests") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        using Slot = TrackFxChain::Slot;
+
+        auto fillSine = [](juce::AudioBuffer<float>& buffer, float frequency, int offset)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int s = 0; s < buffer.getNumSamples(); ++s)
+                    buffer.setSample(ch, s, 0.5f * std::sin(juce::MathConstants<float>::twoPi * frequency
+                                                            * static_cast<float>(offset + s) / static_cast<float>(sampleRate)));
+        };
+
+        beginTest("Fully bypassed chain leaves audio bit-identical");
+        {
+            TrackFxChain chain;
+            chain.prepare(sampleRate, blockSize, 2);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            fillSine(buffer, 440.0f, 0);
+            juce::AudioBuffer<float> reference(buffer);
+
+            chain.process(buffer);
+
+            bool identical = true;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int s = 0; s < blockSize; ++s)
+                    identical = identical && buffer.getSample(ch, s) == reference.getSample(ch, s);
+            expect(identical, "Bypassed slots must not touch the buffer");
+
+            for (int slot = 0; slot < TrackFxChain::kNumSlots; ++slot)
+                expect(chain.getSlotCpuMicros(static_cast<Slot>(slot)) == 0.0f, "Bypassed slots report no CPU time");
+        }
+
+        beginTest("Low-pass filter slot attenuates content above the cutoff");
+        {
+            TrackFxChain chain;
+            chain.prepare(sampleRate, blockSize, 2);
+            chain.setFilter(TrackFxChain::FilterType::LowPass, 500.0f, TrackConfig::FX_DEFAULT_FILTER_RESONANCE);
+            chain.setSlotEnabled(Slot::Filter, true);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            for (int block = 0; block < 4; ++block)
+            {
+                fillSine(buffer, 8000.0f, block * blockSize);
+                chain.process(buffer);
+            }
+
+            expect(buffer.getRMSLevel(0, 0, blockSize) < 0.5f * 0.05f, "8 kHz should be well below a 500 Hz low-pass");
+            expect(chain.getSlotCpuMicros(Slot::Filter) > 0.0f, "Active slot should report CPU time");
+            expect(chain.getSlotCpuMicros(Slot::Delay) == 0.0f, "Bypassed slot should not be timed");
+
+            chain.setSlotEnabled(Slot::Filter, false);
+            chain.process(buffer);
+            expect(chain.getSlotCpuMicros(Slot::Filter) == 0.0f, "CPU time clears once the slot is bypassed");
+        }
+
+        beginTest("Delay slot echoes at the delay time and reports its tail");
+        {
+            TrackFxChain chain;
+            chain.prepare(sampleRate, blockSize, 1);
+            chain.setDelay(10.0f, 0.0f, 0.5f);           // 480 samples, single repeat
+            chain.setSlotEnabled(Slot::Delay, true);
+
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            buffer.clear();
+            buffer.setSample(0, 0, 1.0f);
+            chain.process(buffer);
+
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.5f, 1.0e-6f, "Dry impulse at half level");
+            expectWithinAbsoluteError(buffer.getSample(0, 480), 0.5f, 1.0e-4f, "Echo after 10 ms");
+            expect(chain.hasTail(), "Delay with signal should report a tail");
+
+            buffer.clear();
+            chain.process(buffer, true);
+            expect(!chain.hasTail(), "Tail should run out after the echo has played");
+        }
+
+        beginTest("EQ and compressor slots run without touching bypassed slots");
+        {
+            TrackFxChain chain;
+            chain.prepare(sampleRate, blockSize, 2);
+            chain.setEq(0.0f, 1000.0f, -24.0f, 2.0f, 0.0f);
+            chain.setCompressor(-40.0f, 10.0f, 1.0f, 50.0f, 0.0f);
+            chain.setSlotEnabled(Slot::Eq, true);
+            chain.setSlotEnabled(Slot::Compressor, true);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            for (int block = 0; block < 8; ++block)
+            {
+                fillSine(buffer, 1000.0f, block * blockSize);
+                chain.process(buffer);
+            }
+
+            expect(buffer.getRMSLevel(0, 0, blockSize) < 0.5f * 0.1f, "Mid cut plus compression should reduce a 1 kHz tone");
+            expect(chain.getSlotCpuLoad(Slot::Eq) > 0.0f, "Active EQ should report load");
+            expect(chain.getSlotCpuLoad(Slot::Filter) == 0.0f, "Bypassed filter should report no load");
+        }
+    }
+};
+
+static TrackFxChainTests trackFxChainTests;
@@ -2,14 +2,16 @@
 #include "../../PluginProcessor.h"
 
 //==============================================================================
-TrackControlPanel::TrackControlPanel(AudioLoopStationAudioProcessor& processor)
-    : apvts(processor.getApvts())
+TrackControlPanel::TrackControlPanel(AudioLoopStationAudioProcessor& processorRef)
+    : processor(processorRef),
+      apvts(processorRef.getApvts())
 {
-    for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
-    {
-        trackStrips[i] = std::make_unique<TrackStripComponent>(i, apvts, processor.getLoopManager());
-        addAndMakeVisible(*trackStrips[i]);
-    }
+    rebuildStrips();
+
+    viewport.setViewedComponent(&stripContainer, false);
+    viewport.setScrollBarsShown(false, true);
+    addAndMakeVisible(viewport);
+
     startTimerHz(15);
 }
 
@@ -18,8 +20,28 @@ TrackControlPanel::~TrackControlPanel()
     stopTimer();
 }
 
+void TrackControlPanel::rebuildStrips()
+{
+    const int numTracks = processor.getNumTracks();
+
+    // strips of tracks that are still there keep their attachments
+    trackStrips.resize(static_cast<size_t>(juce::jmin(numTracks, static_cast<int>(trackStrips.size()))));
+    for (int i = static_cast<int>(trackStrips.size()); i < numTracks; ++i)
+    {
+        trackStrips.push_back(std::make_unique<TrackStripComponent>(i, apvts, processor.getLoopManager()));
+        stripContainer.addAndMakeVisible(*trackStrips.back());
+    }
+    stripContainer.numStrips = numTracks;
+}
+
 void TrackControlPanel::timerCallback()
 {
+    if (static_cast<int>(trackStrips.size()) != processor.getNumTracks())
+    {
+        rebuildStrips();
+        resized();
+    }
+
     for (auto& strip : trackStrips)
         if (strip != nullptr)
             strip->syncArmButtonWithEngine();
@@ -34,13 +56,19 @@ void TrackControlPanel::paint(juce::Graphics& g)
 
     g.setColour(juce::Colours::white);
     g.drawRect(getLocalBounds(), 1);
+}
+
+void TrackControlPanel::StripContainer::paint(juce::Graphics& g)
+{
+    if (numStrips <= 0)
+        return;
 
     // Draw track separators
     auto bounds = getLocalBounds();
-    auto trackWidth = bounds.getWidth() / static_cast<float>(TrackConfig::MAX_TRACKS);
+    auto trackWidth = bounds.getWidth() / static_cast<float>(numStrips);
 
     g.setColour(juce::Colours::darkgrey);
-    for (int i = 1; i < TrackConfig::MAX_TRACKS; ++i)
+    for (int i = 1; i < numStrips; ++i)
     {
         auto x = static_cast<float>(i) * trackWidth;
         g.drawLine(x, 0.0f, x, static_cast<float>(bounds.getHeight()), 1.0f);
@@ -49,6 +77,17 @@ void TrackControlPanel::paint(juce::Graphics& g)
 
 void TrackControlPanel::resized()
 {
+    constexpr float margin = 5.0f;
+
+    auto area = getLocalBounds().reduced(10);
+    viewport.setBounds(area);
+
+    // Fill the panel when the strips fit, otherwise keep the minimum width and scroll
+    const int numStrips = static_cast<int>(trackStrips.size());
+    const int minContentWidth = numStrips * (minStripWidth + 2 * static_cast<int>(margin));
+    const int contentHeight = area.getHeight() - (minContentWidth > area.getWidth() ? viewport.getScrollBarThickness() : 0);
+    stripContainer.setSize(juce::jmax(area.getWidth(), minContentWidth), contentHeight);
+
     juce::FlexBox flexBox;
     flexBox.flexDirection = juce::FlexBox::Direction::row;
     flexBox.flexWrap = juce::FlexBox::Wrap::noWrap;
@@ -56,12 +95,10 @@ void TrackControlPanel::resized()
     flexBox.alignItems = juce::FlexBox::AlignItems::stretch;
     flexBox.justifyContent = juce::FlexBox::JustifyContent::flexStart;
 
-    constexpr float margin = 5.0f;
-
-    for (int i = 0; i < TrackConfig::MAX_TRACKS; ++i)
+    for (auto& strip : trackStrips)
     {
-        flexBox.items.add(juce::FlexItem(*trackStrips[i]).withFlex(1.0f).withMinWidth(80.0f).withMargin(margin));
+        flexBox.items.add(juce::FlexItem(*strip).withFlex(1.0f).withMinWidth(static_cast<float>(minStripWidth)).withMargin(margin));
     }
 
-    flexBox.performLayout(getLocalBounds().reduced(10));
+    flexBox.performLayout(stripContainer.getLocalBounds());
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "TrackStripComponent.h"
 #include "../../Utils/TrackConfig.h"
@@ -18,10 +20,26 @@ public:
     void resized() override;
 
 private:
+    /** Holds the strips inside the viewport and draws the separators between them. */
+    struct StripContainer final : public juce::Component
+    {
+        int numStrips = 0;
+        void paint(juce::Graphics&) override;
+    };
+
     void timerCallback() override;
+    // One strip per track of the project; rebuilt when its track count changes
+    void rebuildStrips();
 
-    std::array<std::unique_ptr<TrackStripComponent>, TrackConfig::MAX_TRACKS> trackStrips;
+    static constexpr int minStripWidth = 80;
+
+    AudioLoopStationAudioProcessor& processor;
     juce::AudioProcessorValueTreeState& apvts;
 
+    // Strips keep their minimum width and scroll horizontally once they no longer fit
+    juce::Viewport viewport;
+    StripContainer stripContainer;
+    std::vector<std::unique_ptr<TrackStripComponent>> trackStrips;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrackControlPanel)
 };
@@ -54,6 +54,14 @@ void TrackStripComponent::setupControls()
     panSlider.setValue(0.0);
     addAndMakeVisible(panSlider);
 
+    // Reverb send slider
+    sendSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    sendSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    sendSlider.setRange(0.0, 1.0, 0.01);
+    sendSlider.setValue(0.0);
+    sendSlider.setTooltip("Reverb send");
+    addAndMakeVisible(sendSlider);
+
     // Buttons
     recordArmButton.setButtonText("ARM");
     recordArmButton.setColour(juce::TextButton::buttonColourId, juce::Colours::grey);
@@ -61,8 +69,7 @@ void TrackStripComponent::setupControls()
     recordArmButton.setClickingTogglesState(true);
     recordArmButton.onClick = [this]
     {
-        if (auto* track = loopManager.getTrack(static_cast<size_t>(trackIndex)))
-            track->armForRecording(recordArmButton.getToggleState());
+        loopManager.armTrack(static_cast<size_t>(trackIndex), recordArmButton.getToggleState());
     };
     addAndMakeVisible(recordArmButton);
 
@@ -88,6 +95,8 @@ void TrackStripComponent::setupControls()
         apvts, trackPrefix + "Volume", volumeSlider);
     panAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         apvts, trackPrefix + "Pan", panSlider);
+    sendAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        apvts, trackPrefix + "Send", sendSlider);
     muteAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         apvts, trackPrefix + "Mute", muteButton);
     soloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
@@ -193,6 +202,9 @@ void TrackStripComponent::resized()
     // panSlider
     flexBox.items.add(juce::FlexItem(panSlider).withHeight(30.0f).withMargin(margin));
 
+    // sendSlider
+    flexBox.items.add(juce::FlexItem(sendSlider).withHeight(24.0f).withMargin(margin));
+
     // Button row 1: ARM and Mute
     juce::FlexBox buttonRow1;
     buttonRow1.flexDirection = juce::FlexBox::Direction::row;
@@ -35,6 +35,7 @@ private:
     juce::Label trackLabel;
     juce::Slider volumeSlider;
     juce::Slider panSlider;
+    juce::Slider sendSlider;
     juce::TextButton recordArmButton;
     juce::TextButton muteButton;
     juce::TextButton soloButton;
@@ -42,6 +43,7 @@ private:
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> volumeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> panAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sendAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> muteAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> soloAttachment;
 
@@ -0,0 +1,192 @@
+#include "AudioThreadGuard.h"
+
+#if ALS_AUDIO_THREAD_GUARD
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <juce_core/juce_core.h>
+
+#if defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+ // glibc's own entry points, so the interposed malloc family can forward to them
+ extern "C" void* __libc_malloc(size_t);
+ extern "C" void* __libc_calloc(size_t, size_t);
+ extern "C" void* __libc_realloc(void*, size_t);
+ extern "C" void __libc_free(void*);
+ #define ALS_GUARD_HOOKS_LIBC 1
+#else
+ #define ALS_GUARD_HOOKS_LIBC 0
+#endif
+
+namespace
+{
+// Plain ints with static TLS: touching them never allocates, even from inside malloc.
+thread_local int realtimeDepth = 0;
+thread_local int allowanceDepth = 0;
+thread_local int reportingDepth = 0;
+
+std::atomic<int> violationCount { 0 };
+std::atomic<AudioThreadGuard::Mode> guardMode { AudioThreadGuard::Mode::Assert };
+
+inline bool isChecking() noexcept
+{
+    return realtimeDepth > 0 && allowanceDepth == 0 && reportingDepth == 0;
+}
+
+void reportViolation(const char* what) noexcept
+{
+    if (!isChecking())
+        return;
+
+    // the report itself allocates; don't report that
+    ++reportingDepth;
+    violationCount.fetch_add(1, std::memory_order_relaxed);
+
+    const auto mode = guardMode.load(std::memory_order_relaxed);
+    if (mode != AudioThreadGuard::Mode::Count)
+    {
+        const auto message = juce::String("AudioThreadGuard: ") + what + " on the audio thread\n"
+                             + juce::SystemStats::getStackBacktrace();
+        std::fputs(message.toRawUTF8(), stderr);
+        std::fflush(stderr);
+    }
+
+    if (mode == AudioThreadGuard::Mode::Assert)
+        jassertfalse;
+
+    --reportingDepth;
+}
+}
+
+namespace AudioThreadGuard
+{
+ScopedRealtimeSection::ScopedRealtimeSection() noexcept { ++realtimeDepth; }
+ScopedRealtimeSection::~ScopedRealtimeSection() noexcept { --realtimeDepth; }
+
+ScopedAllowance::ScopedAllowance() noexcept { ++allowanceDepth; }
+ScopedAllowance::~ScopedAllowance() noexcept { --allowanceDepth; }
+
+bool isInRealtimeSection() noexcept { return realtimeDepth > 0; }
+
+void setMode(Mode newMode) noexcept { guardMode.store(newMode, std::memory_order_relaxed); }
+Mode getMode() noexcept { return guardMode.load(std::memory_order_relaxed); }
+int getNumViolations() noexcept { return violationCount.load(std::memory_order_relaxed); }
+void resetViolations() noexcept { violationCount.store(0, std::memory_order_relaxed); }
+}
+
+#if ALS_GUARD_HOOKS_LIBC
+//==============================================================================
+// glibc: the executable's definitions interpose libc's, which also catches
+// operator new/delete (libstdc++ implements them with malloc/free) and every
+// std::mutex / juce::CriticalSection lock.
+extern "C"
+{
+void* malloc(size_t size) noexcept
+{
+    reportViolation("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    reportViolation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept
+{
+    reportViolation("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        reportViolation("free");
+    __libc_free(pointer);
+}
+}
+
+namespace
+{
+using MutexLockFunction = int (*)(pthread_mutex_t*);
+std::atomic<MutexLockFunction> realMutexLock { nullptr };
+
+MutexLockFunction getRealMutexLock() noexcept
+{
+    auto function = realMutexLock.load(std::memory_order_acquire);
+    if (function == nullptr)
+    {
+        function = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realMutexLock.store(function, std::memory_order_release);
+    }
+    return function;
+}
+
+// Resolved during static initialisation, so the audio thread never runs dlsym.
+[[maybe_unused]] const bool mutexLockResolved = getRealMutexLock() != nullptr;
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    reportViolation("pthread_mutex_lock");
+    return getRealMutexLock()(mutex);
+}
+
+#else
+//==============================================================================
+// Elsewhere only the C++ allocation functions can be replaced portably.
+// Aligned overloads keep the library defaults and are not checked.
+void* operator new(std::size_t size)
+{
+    reportViolation("operator new");
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    reportViolation("operator new[]");
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    reportViolation("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    reportViolation("operator new[]");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        reportViolation("operator delete");
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        reportViolation("operator delete[]");
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete[](pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { operator delete[](pointer); }
+#endif
+
+#endif
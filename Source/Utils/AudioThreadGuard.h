@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * Debug and test check for the audio-thread contract: between the construction
+ * and destruction of a ScopedRealtimeSection, the calling thread must not
+ * allocate, free or block on a lock.
+ *
+ * With ALS_AUDIO_THREAD_GUARD=1 (the test runner, and Debug builds configured
+ * with the ALS_AUDIO_THREAD_GUARD option) AudioThreadGuard.cpp hooks the
+ * allocator and, on glibc, pthread_mutex_lock. Any call from a thread inside a
+ * realtime section is counted and, depending on the mode, reported with its
+ * stack. The hooks only take effect in executables (the Standalone app and the
+ * tests); a plugin loaded by a host keeps the host's allocator.
+ *
+ * Without the flag every class here is an empty inline, so release builds pay nothing.
+ */
+
+#ifndef ALS_AUDIO_THREAD_GUARD
+ #define ALS_AUDIO_THREAD_GUARD 0
+#endif
+
+namespace AudioThreadGuard
+{
+    enum class Mode
+    {
+        Assert,     // print the stack, then jassertfalse (default)
+        Log,        // print the stack and carry on
+        Count       // only count, for tests that trigger violations on purpose
+    };
+
+#if ALS_AUDIO_THREAD_GUARD
+    // Marks the calling thread as realtime for its lifetime. Nests.
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection() noexcept;
+        ~ScopedRealtimeSection() noexcept;
+
+        ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+        ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+    };
+
+    // Lifts the contract for a known, bounded exception inside a realtime
+    // section. Every use needs a comment saying why it cannot be avoided.
+    class ScopedAllowance
+    {
+    public:
+        ScopedAllowance() noexcept;
+        ~ScopedAllowance() noexcept;
+
+        ScopedAllowance(const ScopedAllowance&) = delete;
+        ScopedAllowance& operator=(const ScopedAllowance&) = delete;
+    };
+
+    constexpr bool isEnabled() noexcept { return true; }
+    bool isInRealtimeSection() noexcept;
+
+    void setMode(Mode newMode) noexcept;
+    Mode getMode() noexcept;
+    int getNumViolations() noexcept;
+    void resetViolations() noexcept;
+#else
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection() noexcept {}
+    };
+
+    class ScopedAllowance
+    {
+    public:
+        ScopedAllowance() noexcept {}
+    };
+
+    constexpr bool isEnabled() noexcept { return false; }
+    inline bool isInRealtimeSection() noexcept { return false; }
+
+    inline void setMode(Mode) noexcept {}
+    inline Mode getMode() noexcept { return Mode::Assert; }
+    inline int getNumViolations() noexcept { return 0; }
+    inline void resetViolations() noexcept {}
+#endif
+}
@@ -26,7 +26,9 @@ namespace Config {
      * - TrackControlPanel: Creates UI strips
      * - APVTS: Creates parameters for each track
      */
-    constexpr int MAX_TRACKS = 4;                       // MVP: 4 mono/2 stereo
+    constexpr int MIN_TRACKS = 1;
+    constexpr int MAX_TRACKS = 64;                      // upper bound for the per-project track count
+    constexpr int DEFAULT_NUM_TRACKS = 4;               // MVP: 4 mono/2 stereo
     constexpr double MAX_LOOP_LEN_SEC = 600.0;          // 10 minutes, int and f vers
     constexpr float MAX_LOOP_LEN_SEC_F =
             static_cast<float>(MAX_LOOP_LEN_SEC);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 64-bit content hash for change detection (XXH64, bit-compatible with the
+ * reference implementation). Four independent lanes keep it at memory speed,
+ * so hashing a track costs about as much as copying it. Not cryptographic:
+ * it proves audio unchanged only against accidents, not against an adversary.
+ */
+namespace ContentHash
+{
+    namespace detail
+    {
+        constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+        inline uint64_t rotl(uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+        // Little-endian reads, like the file format
+        inline uint64_t read64(const uint8_t* p) noexcept { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+        inline uint32_t read32(const uint8_t* p) noexcept { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+
+        inline uint64_t round(uint64_t acc, uint64_t input) noexcept
+        {
+            acc += input * kPrime2;
+            return rotl(acc, 31) * kPrime1;
+        }
+
+        inline uint64_t mergeRound(uint64_t acc, uint64_t lane) noexcept
+        {
+            acc ^= round(0, lane);
+            return acc * kPrime1 + kPrime4;
+        }
+    }
+
+    inline uint64_t hash(const void* data, size_t numBytes, uint64_t seed = 0) noexcept
+    {
+        using namespace detail;
+        const auto* p = static_cast<const uint8_t*>(data);
+        const uint8_t* const end = p + numBytes;
+        uint64_t h;
+
+        if (numBytes >= 32)
+        {
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            for (const uint8_t* const limit = end - 32; p <= limit; p += 32)
+            {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+            }
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = mergeRound(h, v1);
+            h = mergeRound(h, v2);
+            h = mergeRound(h, v3);
+            h = mergeRound(h, v4);
+        }
+        else
+        {
+            h = seed + kPrime5;
+        }
+
+        h += static_cast<uint64_t>(numBytes);
+
+        for (; p + 8 <= end; p += 8)
+            h = rotl(h ^ round(0, read64(p)), 27) * kPrime1 + kPrime4;
+        if (p + 4 <= end)
+        {
+            h = rotl(h ^ (static_cast<uint64_t>(read32(p)) * kPrime1), 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+            h = rotl(h ^ (*p * kPrime5), 11) * kPrime1;
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+}
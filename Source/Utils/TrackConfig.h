@@ -22,23 +22,66 @@ namespace TrackConfig {
     constexpr float BPM_GLOBAL_MIN = 40.0f;
     constexpr float BPM_GLOBAL_MAX = 200.0f;
     constexpr float DEFAULT_BPM_INCR = 0.5f;
+    constexpr int DEFAULT_BEATS_PER_BAR = 4;           // time signature numerator
+    constexpr int DEFAULT_BEAT_UNIT = 4;               // time signature denominator
+
+    // Tempo detection (background analysis of the first loop or an imported file)
+    constexpr int TEMPO_DETECT_FFT_ORDER = 10;          // 1024-point frames
+    constexpr int TEMPO_DETECT_HOP_SIZE = 256;          // onset envelope resolution, ~5.8ms at 44.1k
+    constexpr double TEMPO_DETECT_MIN_BPM = 60.0;
+    constexpr double TEMPO_DETECT_MAX_BPM = 200.0;
+    constexpr double TEMPO_DETECT_PREFERRED_BPM = 120.0; // centre of the octave-resolving weight
+    constexpr double TEMPO_DETECT_SNAP_TOLERANCE = 0.02; // snap to whole beats within 2% of the measured tempo
+    constexpr double TEMPO_DETECT_MAX_SECONDS = 60.0;   // longer files are analysed from the start
+    constexpr float TEMPO_DETECT_MIN_CONFIDENCE = 0.3f; // below this an estimate is not offered
 
     // Track Configuration
     constexpr int INVALID_TRACK_ID = -1;
     constexpr int FIRST_TRACK_ID = 0;
-    constexpr int MAX_TRACKS = 4;                      // MVP: 4 mono/2 stereo
+    constexpr int MIN_TRACKS = 1;
+    constexpr int MAX_TRACKS = 64;                     // upper bound for the per-project track count
+    constexpr int DEFAULT_NUM_TRACKS = 4;              // MVP: 4 mono/2 stereo
+    constexpr int MAX_GROUP_BUSES = 8;                 // sub-mix buses between the tracks and the master
+    constexpr int MASTER_BUS = -1;                     // routing destination meaning "straight to master"
     constexpr bool STEREO_MODE = true;                 // set to false for 4 mono tracks, true for two stereo tracks
+    constexpr int DEFAULT_TRACK_CHANNELS = STEREO_MODE ? 2 : 1;
+    constexpr int DYNAMIC_CHANNELS = 0;                // hot paths read the channel count at runtime
+
+    // Track count requested at project creation, clamped to the supported range
+    constexpr int clampNumTracks(int numTracks) {
+        return numTracks < MIN_TRACKS ? MIN_TRACKS : (numTracks > MAX_TRACKS ? MAX_TRACKS : numTracks);
+    }
 
     // Audio Engine
     constexpr int DEFAULT_SAMPLE_RATE = 48000;          // compile-time default
     constexpr int INIT_BUFFER_SIZE_SAMPLES = 1024;
     constexpr int DEFAULT_BUFFER_SIZE = 256;            // for ~5.3ms latency at 48k
     constexpr double MAX_LOOP_LENGTH_SECONDS = 600;     // 10 minutes
+    constexpr float SILENCE_THRESHOLD = 1.0e-6f;        // -120 dBFS, treated as digital silence
+    constexpr int PARALLEL_RENDER_MIN_TRACKS = 16;      // below this, tracks render serially on the audio thread
+    constexpr int MAX_RENDER_WORKERS = 7;               // helper threads, plus the audio thread itself
+
+    // Render helper threads for a project: none below PARALLEL_RENDER_MIN_TRACKS, otherwise as many
+    // as leave one physical core free once the audio thread has its own (numPhysicalCpus - 2)
+    constexpr int getNumRenderWorkers(int numTracks, int numPhysicalCpus) {
+        const int workers = numPhysicalCpus - 2;
+        return numTracks < PARALLEL_RENDER_MIN_TRACKS || workers <= 0 ? 0
+             : (workers > MAX_RENDER_WORKERS ? MAX_RENDER_WORKERS : workers);
+    }
+    constexpr int LAUNCH_QUEUE_CAPACITY = 256;          // quantized transport actions waiting for their beat/bar/wrap
+    constexpr int RETIRED_PLAYER_CAPACITY = 512;        // players swapped out on the audio thread, freed on the message thread
+
+    // Record latency compensation
+    constexpr int MAX_RECORD_LATENCY_SAMPLES = 48000;   // round trips longer than this are clamped
+    constexpr int LATENCY_PROBE_CLICK_SAMPLES = 16;
+    constexpr float LATENCY_PROBE_CLICK_LEVEL = 0.5f;
+    constexpr float LATENCY_PROBE_THRESHOLD = 0.05f;    // ~-26 dBFS: the echo of the click, not the noise floor
+    constexpr double LATENCY_PROBE_TIMEOUT_SECONDS = 1.0;
 
     // DSP Parameters
     constexpr float MIN_VOLUME_DB = -60.0f;
     constexpr float MAX_VOLUME_DB = 6.0f;
-    constexpr float DEFAULT_VOLUME_DB = 0.8f;           // -6dB default
+    constexpr float DEFAULT_VOLUME_DB = 0.0f;           // per-track trim, unity (fader lives in APVTS)
     constexpr double_t VOLUME_FADE_SECONDS = 0.05f;
 
     constexpr float MIN_PAN = -1.0f;                    // Full left
@@ -46,6 +89,10 @@ namespace TrackConfig {
     constexpr float DEFAULT_PAN = 0.0f;                 // Center
     constexpr double_t PAN_FADE_SECONDS = 0.03f;
 
+    constexpr float LIMITER_CEILING_DB = -1.0f;         // true-peak ceiling on the master bus
+    constexpr double LIMITER_LOOKAHEAD_SECONDS = 0.0015; // ~72 samples at 48k
+    constexpr double LIMITER_RELEASE_SECONDS = 0.06;
+
     constexpr float MIN_PITCH_SEMITONES = -12.0f;
     constexpr float MAX_PITCH_SEMITONES = 12.0f;
     constexpr float DEFAULT_PITCH = 0.0f;               // No shift
@@ -54,13 +101,39 @@ namespace TrackConfig {
     constexpr float MAX_STRETCH_RATIO = 2.0f;           // 200% faster
     constexpr float DEFAULT_STRETCH = 1.0f;             // Normal speed
 
+    // Insert FX (per-track chain)
+    constexpr float FX_DEFAULT_FILTER_CUTOFF_HZ = 1000.0f;
+    constexpr float FX_DEFAULT_FILTER_RESONANCE = 0.7071f;  // Butterworth
+    constexpr float FX_EQ_LOW_SHELF_HZ = 120.0f;
+    constexpr float FX_EQ_DEFAULT_MID_HZ = 1000.0f;
+    constexpr float FX_EQ_HIGH_SHELF_HZ = 8000.0f;
+    constexpr float FX_DEFAULT_COMP_THRESHOLD_DB = -18.0f;
+    constexpr float FX_DEFAULT_COMP_RATIO = 4.0f;
+    constexpr float FX_DEFAULT_COMP_ATTACK_MS = 5.0f;
+    constexpr float FX_DEFAULT_COMP_RELEASE_MS = 100.0f;
+    constexpr double FX_MAX_DELAY_SECONDS = 2.0;
+    constexpr float FX_DEFAULT_DELAY_MS = 375.0f;            // dotted eighth at 120 BPM
+    constexpr float FX_DEFAULT_DELAY_FEEDBACK = 0.35f;
+    constexpr float FX_DEFAULT_DELAY_MIX = 0.25f;
+
+    // Send reverb (one shared convolution bus on the master section)
+    constexpr float DEFAULT_SEND_LEVEL = 0.0f;
+    constexpr int REVERB_HEAD_BLOCK_SIZE = 128;         // audio-thread partitions, also the return's pre-delay
+    constexpr int REVERB_TAIL_BLOCK_SIZE = 2048;        // background-thread partitions
+    constexpr double REVERB_DEFAULT_DECAY_SECONDS = 2.0;
+    constexpr double REVERB_MAX_IR_SECONDS = 10.0;
+
     // Performance Targets
     constexpr double MAX_LATENCY_MS = 10.0;             // <10ms target
     constexpr double UI_REFRESH_MS = 16.0;              // ~60 FPS
+    constexpr int MESSAGE_THREAD_POLL_MS = 50;          // processor timer: tempo results, retired players
 
     // UI Constraints
 
     // File handler
-    static constexpr int PROJECT_VERSION = 1;
+    static constexpr int PROJECT_VERSION = 3;          // 2: chunk table, page-aligned audio; 3: JSON anywhere
     static constexpr const char* PROJECT_FILE_EXT = "als";
+    static constexpr int PROJECT_SAVE_SEGMENT_SAMPLES = 1 << 18;   // coded save: per-job slice of a channel (1 MiB of floats)
+    static constexpr int FILE_READ_SLICE_SAMPLES = 1 << 16;        // imports are read (and can be cancelled) in slices
+    static constexpr double PROJECT_MAX_DEAD_RATIO = 1.0;           // incremental saves: unreferenced bytes per live byte before a full rewrite
 }